@@ -0,0 +1,126 @@
+// Compare the constant-time discrete normal sampler with the exact one.
+//
+// This times discrete_normal_dist (the exact, variable-time sampler) and
+// discrete_normal_ct (the constant-time table sampler, one sample at a
+// time and in batches) for several values of sigma.  For each, it reports
+// the time per sample, the mean number of digits used per sample, and the
+// range of the number of digits used by a single sample (which is fixed for
+// discrete_normal_ct).  Each time is the best of 3 runs.  Both samplers use
+// rand_digit<2^16> with std::mt19937_64.
+//
+// Usage: bench_discrete_ct [--samples M] [--seed S]
+//
+// M (default 1000000) is the number of samples per run.
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <sstream>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include <cstdlib>
+#include <exrandom/rand_digit.hpp>
+#include <exrandom/discrete_normal_dist.hpp>
+#include <exrandom/discrete_normal_ct.hpp>
+
+typedef exrandom::rand_digit<1U<<16> digit_gen;
+long long samples = 1000000LL;
+unsigned seed = 0;
+
+struct result {
+  double ns, digits;
+  long long dmin, dmax;
+};
+
+// Time n samples of f, the best of 3 runs; f(g, k) fills k samples
+template<typename F>
+result time_it(digit_gen& D, F f, long long batch) {
+  result r = {0, 0, 0, 0};
+  std::vector<int> v((size_t(batch)));
+  for (int run = 0; run < 3; ++run) {
+    std::mt19937_64 g(seed);
+    long long c0 = D.count(), s = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    for (long long i = 0; i < samples; i += batch) {
+      f(g, v.data(), size_t((std::min)(batch, samples - i)));
+      s += v[0];
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    double t = double(std::chrono::duration_cast<std::chrono::nanoseconds>
+                      (t1 - t0).count()) / samples;
+    if (s == -1) std::cerr << " ";  // so that s is used
+    r.ns = run ? (std::min)(r.ns, t) : t;
+    r.digits = double(D.count() - c0) / samples;
+  }
+  // The range of digits for single samples
+  std::mt19937_64 g(seed);
+  for (long long i = 0; i < (std::min)(samples, 100000LL); ++i) {
+    long long c0 = D.count();
+    f(g, v.data(), 1U);
+    long long d = D.count() - c0;
+    r.dmin = i ? (std::min)(r.dmin, d) : d;
+    r.dmax = i ? (std::max)(r.dmax, d) : d;
+  }
+  return r;
+}
+
+void print(const std::string& sigma, const std::string& method,
+           const result& r, size_t bytes) {
+  std::ostringstream range;
+  range << r.dmin << "-" << r.dmax;
+  std::cout << std::left << std::setw(8) << sigma << std::setw(12) << method
+            << std::right << std::fixed << std::setprecision(1)
+            << std::setw(10) << r.ns << std::setw(12) << 1e3 / r.ns
+            << std::setprecision(2) << std::setw(10) << r.digits
+            << std::setw(10) << range.str() << std::setw(10) << bytes
+            << "\n";
+}
+
+void bench(int sigma_num, int sigma_den) {
+  std::ostringstream s;
+  s << sigma_num;
+  if (sigma_den != 1) s << "/" << sigma_den;
+  digit_gen D;
+  exrandom::discrete_normal_dist<digit_gen> V(D, 1, 7, sigma_num, sigma_den);
+  exrandom::discrete_normal_ct<digit_gen> C(D, 1, 7, sigma_num, sigma_den);
+  result rv = time_it(D, [&V](std::mt19937_64& g, int* p, size_t n)
+                      { for (size_t i = 0; i < n; ++i) p[i] = V(g); }, 1),
+    rc = time_it(D, [&C](std::mt19937_64& g, int* p, size_t n)
+                 { for (size_t i = 0; i < n; ++i) p[i] = C(g); }, 1),
+    rb = time_it(D, [&C](std::mt19937_64& g, int* p, size_t n)
+                 { C.generate(g, p, n); }, 1000);
+  print(s.str(), "variable", rv, V.prepared().table_bytes());
+  print("", "ct", rc, C.table_bytes());
+  print("", "ct batch", rb, C.table_bytes());
+}
+
+int main(int argc, char* argv[]) {
+  seed = std::random_device()();
+  for (int i = 1; i < argc; ++i) {
+    std::string a(argv[i]);
+    if (a == "--samples" && i + 1 < argc)
+      samples = (std::max)(1LL, std::atoll(argv[++i]));
+    else if (a == "--seed" && i + 1 < argc)
+      seed = unsigned(std::strtoul(argv[++i], 0, 10));
+    else {
+      std::cerr << "Usage: " << argv[0] << " [--samples M] [--seed S]\n";
+      return 1;
+    }
+  }
+  std::cerr << "Seed set to " << seed << "\n";
+  std::cout << "Discrete normal samples with mu = 1/7: variable time "
+            << "(discrete_normal_dist)\nvs constant time "
+            << "(discrete_normal_ct)\n"
+            << std::left << std::setw(8) << "sigma" << std::setw(12)
+            << "method" << std::right << std::setw(10) << "ns"
+            << std::setw(12) << "Msamples/s" << std::setw(10) << "digits"
+            << std::setw(10) << "range" << std::setw(10) << "bytes" << "\n";
+  bench(16, 100);
+  bench(16, 10);
+  bench(16, 1);
+  bench(129, 2);
+  bench(160, 1);
+  return 0;
+}
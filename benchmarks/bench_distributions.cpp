@@ -0,0 +1,359 @@
+// Multi-threaded timing of the exrandom distributions.
+//
+// Each worker thread owns its engine and its distribution object and draws
+// samples in batches.  For each combination of distribution, engine, and
+// number of threads this reports
+//   ns/sample: the time per sample for a single thread,
+//   samples/s: the aggregate throughput of all the threads,
+//   p50, p99: the median and 99th percentile times per batch,
+//   calls/sample: the number of calls to the engine per sample,
+//   efficiency: the throughput relative to N times the single-thread
+//     throughput.
+//
+// Usage: bench_distributions [--threads N] [--samples M] [--batch B]
+//          [--seed S] [--filter STR] [--format text|csv|json] [--output FILE]
+//
+// The runs use 1, 2, 4, ..., threads (default the number of hardware
+// threads); M (default 1000000) is the number of samples per thread; B
+// (default 1000) is the batch size; only the runs whose "dist/engine" name
+// contains STR are made.
+
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <memory>
+#include <algorithm>
+#include <cstdlib>
+#include <cstdint>
+#include <exrandom/unit_normal_distribution.hpp>
+#include <exrandom/unit_exponential_distribution.hpp>
+#include <exrandom/unit_uniform_distribution.hpp>
+#include <exrandom/discrete_normal_distribution.hpp>
+#include <exrandom/philox_engine.hpp>
+
+// Engines need compile-time min() and max() with some standard libraries
+#if EXRANDOM_CONSTEXPR
+#  define BENCH_CONSTEXPR constexpr
+#else
+#  define BENCH_CONSTEXPR
+#endif
+
+// exrandom::philox_engine with the constructor from a seed sequence used
+// for the other engines
+class philox : public exrandom::philox_engine {
+public:
+  template<typename SeedSeq> explicit philox(SeedSeq& s)
+    : exrandom::philox_engine(key(s)) {}
+private:
+  template<typename SeedSeq> static result_type key(SeedSeq& s) {
+    std::uint32_t k[2];
+    s.generate(k, k + 2);
+    return (result_type(k[0]) << 32) | k[1];
+  }
+};
+
+namespace exrandom {
+  template<> class word32_engine<philox> {
+  public:
+    static const bool value = true;
+  };
+}
+
+// An engine whose range exrandom treats as unknown at compile time; this
+// times the run-time checks of the range which engine_bits eliminates.
+template<typename Engine> class runtime_range : public Engine {
+public:
+  template<typename SeedSeq> explicit runtime_range(SeedSeq& s)
+    : Engine(s) {}
+};
+
+namespace exrandom {
+  template<typename Engine> class engine_bits< runtime_range<Engine> > {
+  public:
+    static const int value = -1;
+  };
+}
+
+// An adaptor which counts the calls to an engine.
+template<typename Engine> class counting_engine {
+public:
+  typedef typename Engine::result_type result_type;
+  static BENCH_CONSTEXPR result_type min() { return Engine::min(); }
+  static BENCH_CONSTEXPR result_type max() { return Engine::max(); }
+  template<typename SeedSeq> explicit counting_engine(SeedSeq& s)
+    : _e(s), _count(0), _halves(0) {}
+  result_type operator()() { ++_count; return _e(); }
+  // Only used if exrandom::word32_engine<Engine>::value is true
+  std::uint32_t next32() { ++_halves; return _e.next32(); }
+  long long count() const { return _count + _halves / 2; }
+private:
+  Engine _e;
+  long long _count, _halves;
+};
+
+namespace exrandom {
+  template<typename Engine> class word32_engine< counting_engine<Engine> > {
+  public:
+    static const bool value = word32_engine<Engine>::value;
+  };
+  template<typename Engine> class engine_bits< counting_engine<Engine> > {
+  public:
+    static const int value = engine_bits<Engine>::value;
+  };
+}
+
+// The distributions to time
+struct normal_float {
+  typedef exrandom::unit_normal_distribution<float> type;
+  static std::string name() { return "normal<float>"; }
+  static type* make() { return new type(); }
+};
+struct normal_double {
+  typedef exrandom::unit_normal_distribution<double> type;
+  static std::string name() { return "normal<double>"; }
+  static type* make() { return new type(); }
+};
+struct exponential_double {
+  typedef exrandom::unit_exponential_distribution<double> type;
+  static std::string name() { return "exponential<double>"; }
+  static type* make() { return new type(); }
+};
+struct uniform_double {
+  typedef exrandom::unit_uniform_distribution<double> type;
+  static std::string name() { return "uniform<double>"; }
+  static type* make() { return new type(); }
+};
+template<int sigma> struct discrete_normal {
+  typedef exrandom::discrete_normal_distribution type;
+  static std::string name() {
+    std::ostringstream s; s << "discrete_normal(1/7," << sigma << ")";
+    return s.str();
+  }
+  static type* make() { return new type(1, 7, sigma, 1); }
+};
+struct std_normal_double {
+  typedef std::normal_distribution<double> type;
+  static std::string name() { return "std::normal<double>"; }
+  static type* make() { return new type(); }
+};
+
+struct result {
+  std::string dist, engine;
+  int threads;
+  long long samples;
+  double ns_per_sample, samples_per_sec, p50, p99, calls_per_sample,
+    efficiency;
+};
+
+struct options {
+  int threads;
+  long long samples, batch;
+  unsigned seed;
+  std::string filter, format, output;
+};
+
+// The state of one worker thread
+struct worker_data {
+  std::vector<double> latency;  // ns per batch
+  long long calls;
+  double sum;                   // so that the samples are used
+};
+
+template<typename Spec, typename Engine>
+void worker(const options& opt, int id, std::atomic<int>& ready,
+            std::atomic<bool>& go, worker_data& w) {
+  std::seed_seq s{opt.seed, unsigned(id)};
+  Engine g(s);
+  std::unique_ptr<typename Spec::type> d(Spec::make());
+  long long nbatch = (opt.samples + opt.batch - 1) / opt.batch;
+  w.latency.reserve(size_t(nbatch));
+  double sum = 0;
+  ++ready;
+  while (!go) std::this_thread::yield();
+  for (long long i = 0; i < nbatch; ++i) {
+    auto t0 = std::chrono::steady_clock::now();
+    for (long long j = 0; j < opt.batch; ++j)
+      sum += (*d)(g);
+    auto t1 = std::chrono::steady_clock::now();
+    w.latency.push_back(double(std::chrono::duration_cast
+                               <std::chrono::nanoseconds>(t1 - t0).count()));
+  }
+  w.calls = g.count();
+  w.sum = sum;
+}
+
+template<typename Spec, typename Engine>
+result run(const options& opt, const std::string& engine, int threads) {
+  std::vector<worker_data> w(threads);
+  std::vector<std::thread> t;
+  std::atomic<int> ready(0);
+  std::atomic<bool> go(false);
+  for (int i = 0; i < threads; ++i)
+    t.push_back(std::thread(worker<Spec, Engine>, std::cref(opt), i,
+                            std::ref(ready), std::ref(go), std::ref(w[i])));
+  while (ready < threads) std::this_thread::yield();
+  auto t0 = std::chrono::steady_clock::now();
+  go = true;
+  for (int i = 0; i < threads; ++i) t[i].join();
+  auto t1 = std::chrono::steady_clock::now();
+  double wall = double(std::chrono::duration_cast<std::chrono::nanoseconds>
+                       (t1 - t0).count());
+  std::vector<double> lat;
+  long long calls = 0;
+  double busy = 0;
+  for (int i = 0; i < threads; ++i) {
+    lat.insert(lat.end(), w[i].latency.begin(), w[i].latency.end());
+    calls += w[i].calls;
+  }
+  for (size_t i = 0; i < lat.size(); ++i) busy += lat[i];
+  std::sort(lat.begin(), lat.end());
+  result r;
+  r.dist = Spec::name(); r.engine = engine; r.threads = threads;
+  r.samples = threads * ((opt.samples + opt.batch - 1) / opt.batch)
+    * opt.batch;
+  r.ns_per_sample = busy / r.samples;
+  r.samples_per_sec = r.samples / (wall * 1e-9);
+  r.p50 = lat[lat.size() / 2];
+  r.p99 = lat[(std::min)(lat.size() - 1, size_t(0.99 * lat.size()))];
+  r.calls_per_sample = double(calls) / r.samples;
+  r.efficiency = 1;
+  return r;
+}
+
+void print_header(std::ostream& os, const options& opt) {
+  if (opt.format == "csv")
+    os << "dist,engine,threads,samples,ns_per_sample,samples_per_sec,"
+       << "p50_batch_ns,p99_batch_ns,calls_per_sample,efficiency\n";
+  else if (opt.format == "json")
+    os << "[\n";
+  else
+    os << std::left << std::setw(30) << "dist" << std::setw(13) << "engine"
+       << std::right << std::setw(8) << "threads"
+       << std::setw(12) << "ns/sample" << std::setw(14) << "samples/s"
+       << std::setw(12) << "p50(ns)" << std::setw(12) << "p99(ns)"
+       << std::setw(14) << "calls/sample" << std::setw(12) << "efficiency"
+       << "\n";
+}
+
+void print_result(std::ostream& os, const options& opt, const result& r,
+                  bool first) {
+  if (opt.format == "csv")
+    os << "\"" << r.dist << "\"," << r.engine << "," << r.threads << ","
+       << r.samples << "," << r.ns_per_sample << "," << r.samples_per_sec
+       << "," << r.p50 << "," << r.p99 << "," << r.calls_per_sample << ","
+       << r.efficiency << "\n";
+  else if (opt.format == "json")
+    os << (first ? "" : ",\n")
+       << "  {\"dist\": \"" << r.dist << "\", \"engine\": \"" << r.engine
+       << "\", \"threads\": " << r.threads << ", \"samples\": " << r.samples
+       << ", \"ns_per_sample\": " << r.ns_per_sample
+       << ", \"samples_per_sec\": " << r.samples_per_sec
+       << ", \"p50_batch_ns\": " << r.p50 << ", \"p99_batch_ns\": " << r.p99
+       << ", \"calls_per_sample\": " << r.calls_per_sample
+       << ", \"efficiency\": " << r.efficiency << "}";
+  else
+    os << std::left << std::setw(30) << r.dist << std::setw(13) << r.engine
+       << std::right << std::fixed << std::setw(8) << r.threads
+       << std::setprecision(1) << std::setw(12) << r.ns_per_sample
+       << std::setprecision(0) << std::setw(14) << r.samples_per_sec
+       << std::setw(12) << r.p50 << std::setw(12) << r.p99
+       << std::setprecision(3) << std::setw(14) << r.calls_per_sample
+       << std::setw(12) << r.efficiency << "\n";
+  os << std::flush;
+}
+
+// Time one distribution with one engine for 1, 2, 4, ..., opt.threads
+// threads.
+template<typename Spec, typename Engine>
+void bench(std::ostream& os, const options& opt, const std::string& engine,
+           bool& first) {
+  if ((Spec::name() + "/" + engine).find(opt.filter) == std::string::npos)
+    return;
+  double single = 0;
+  for (int n = 1;; n = (std::min)(2 * n, opt.threads)) {
+    result r = run<Spec, counting_engine<Engine> >(opt, engine, n);
+    if (n == 1) single = r.samples_per_sec;
+    r.efficiency = r.samples_per_sec / (n * single);
+    print_result(os, opt, r, first);
+    first = false;
+    if (n == opt.threads) break;
+  }
+}
+
+template<typename Spec>
+void bench_engines(std::ostream& os, const options& opt, bool& first) {
+  bench<Spec, std::mt19937>(os, opt, "mt19937", first);
+  bench<Spec, runtime_range<std::mt19937> >(os, opt, "mt19937/rt", first);
+  bench<Spec, std::mt19937_64>(os, opt, "mt19937_64", first);
+  bench<Spec, runtime_range<std::mt19937_64> >
+    (os, opt, "mt19937_64/rt", first);
+  bench<Spec, std::ranlux48>(os, opt, "ranlux48", first);
+  bench<Spec, philox>(os, opt, "philox", first);
+}
+
+int main(int argc, char* argv[]) {
+  options opt;
+  opt.threads = (std::max)(1, int(std::thread::hardware_concurrency()));
+  opt.samples = 1000000LL;
+  opt.batch = 1000LL;
+  opt.seed = std::random_device()();
+  opt.format = "text";
+  for (int i = 1; i < argc; ++i) {
+    std::string a(argv[i]);
+    if (i + 1 == argc) {
+      std::cerr << "Missing argument for " << a << "\n";
+      return 1;
+    }
+    std::string v(argv[++i]);
+    if (a == "--threads")
+      opt.threads = (std::max)(1, std::atoi(v.c_str()));
+    else if (a == "--samples")
+      opt.samples = (std::max)(1LL, std::atoll(v.c_str()));
+    else if (a == "--batch")
+      opt.batch = (std::max)(1LL, std::atoll(v.c_str()));
+    else if (a == "--seed")
+      opt.seed = unsigned(std::strtoul(v.c_str(), 0, 10));
+    else if (a == "--filter")
+      opt.filter = v;
+    else if (a == "--format" &&
+             (v == "text" || v == "csv" || v == "json"))
+      opt.format = v;
+    else if (a == "--output")
+      opt.output = v;
+    else {
+      std::cerr << "Usage: " << argv[0]
+                << " [--threads N] [--samples M] [--batch B] [--seed S]\n"
+                << "    [--filter STR] [--format text|csv|json]"
+                << " [--output FILE]\n";
+      return 1;
+    }
+  }
+  std::ofstream file;
+  if (!opt.output.empty()) {
+    file.open(opt.output.c_str());
+    if (!file.good()) {
+      std::cerr << "Cannot open " << opt.output << "\n";
+      return 1;
+    }
+  }
+  std::ostream& os = opt.output.empty() ? std::cout : file;
+  std::cerr << "Seed set to " << opt.seed << "\n";
+  print_header(os, opt);
+  bool first = true;
+  bench_engines<normal_float>(os, opt, first);
+  bench_engines<normal_double>(os, opt, first);
+  bench_engines<exponential_double>(os, opt, first);
+  bench_engines<uniform_double>(os, opt, first);
+  bench_engines<discrete_normal<16> >(os, opt, first);
+  bench_engines<discrete_normal<1600> >(os, opt, first);
+  bench_engines<std_normal_double>(os, opt, first);
+  if (opt.format == "json") os << "\n]\n";
+  return 0;
+}
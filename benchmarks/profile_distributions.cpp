@@ -0,0 +1,108 @@
+// Attribute the costs of the exrandom distributions to the steps of their
+// algorithms.
+//
+// For each distribution this prints the sample_stats summary and, per
+// sample, the digits, cycles, branch misses, and cache misses for each
+// sample_stage (see exrandom::perf_stats); the hardware counters are read
+// with perf_event_open on Linux.
+//
+// Usage: profile_distributions [--samples M] [--seed S] [--filter STR]
+//
+// M (default 1000000) is the number of samples; only the distributions whose
+// names contain STR are profiled.  This is built by cmake with
+// -D EXRANDOM_PROFILE=ON, which also compiles the library with the functions
+// for the steps of the algorithms out of line, so that "perf record" and
+// similar profilers attribute time to them.
+
+#include <iostream>
+#include <string>
+#include <random>
+#include <cstdlib>
+#include <exrandom/rand_digit.hpp>
+#include <exrandom/unit_normal_dist.hpp>
+#include <exrandom/unit_exponential_dist.hpp>
+#include <exrandom/unit_normal_kahn.hpp>
+#include <exrandom/discrete_normal_dist.hpp>
+#include <exrandom/perf_stats.hpp>
+
+typedef exrandom::rand_digit<0U> digit_gen;
+typedef exrandom::perf_stats stats;
+
+template<typename dist>
+void report(const std::string& name, const dist& d) {
+  std::cout << name << ":\n" << d.statistics() << "\n";
+}
+
+int main(int argc, char* argv[]) {
+  long long samples = 1000000LL;
+  unsigned seed = std::random_device()();
+  std::string filter;
+  for (int i = 1; i < argc; ++i) {
+    std::string a(argv[i]);
+    if (i + 1 == argc) {
+      std::cerr << "Missing argument for " << a << "\n";
+      return 1;
+    }
+    std::string v(argv[++i]);
+    if (a == "--samples")
+      samples = std::atoll(v.c_str());
+    else if (a == "--seed")
+      seed = unsigned(std::strtoul(v.c_str(), 0, 10));
+    else if (a == "--filter")
+      filter = v;
+    else {
+      std::cerr << "Unknown option " << a << "\n";
+      return 1;
+    }
+  }
+  std::cout << "Seed set to " << seed << "\n\n";
+  std::mt19937 g(seed);
+  digit_gen D;
+  double x = 0;                 // To keep the samples from being optimized away
+  {
+    std::string name = "unit_normal_dist";
+    exrandom::unit_normal_dist<digit_gen, false, stats> N(D);
+    if (name.find(filter) != std::string::npos) {
+      for (long long i = 0; i < samples; ++i) x += N.value<double>(g);
+      report(name, N);
+    }
+  }
+  {
+    std::string name = "unit_normal_dist/ziggurat";
+    exrandom::unit_normal_dist<digit_gen, true, stats, true> N(D);
+    if (name.find(filter) != std::string::npos) {
+      for (long long i = 0; i < samples; ++i) x += N.value<double>(g);
+      report(name, N);
+    }
+  }
+  {
+    std::string name = "unit_exponential_dist";
+    exrandom::unit_exponential_dist<digit_gen, true, stats> E(D);
+    if (name.find(filter) != std::string::npos) {
+      for (long long i = 0; i < samples; ++i) x += E.value<double>(g);
+      report(name, E);
+    }
+  }
+  {
+    std::string name = "unit_normal_kahn";
+    exrandom::rand_digit<16U> D16;
+    exrandom::unit_normal_kahn<exrandom::rand_digit<16U>, stats> K(D16);
+    if (name.find(filter) != std::string::npos) {
+      for (long long i = 0; i < samples; ++i) x += K.value<double>(g);
+      report(name, K);
+    }
+  }
+  {
+    std::string name = "discrete_normal_dist(1/7,1600)";
+    typedef exrandom::rand_digit<(1U << 16)> digit_gen16;
+    typedef exrandom::discrete_normal_dist<digit_gen16, false, stats> dist;
+    digit_gen16 D16;
+    dist N(D16, dist::param_type(1, 7, 1600, 1));
+    if (name.find(filter) != std::string::npos) {
+      for (long long i = 0; i < samples; ++i) x += N(g);
+      report(name, N);
+    }
+  }
+  std::cerr << "checksum " << x << "\n";
+  return 0;
+}
@@ -0,0 +1,149 @@
+// Choose between the algorithms for the unit normal distribution.
+//
+// This times unit_normal_dist (Algorithm N) and unit_normal_kahn (Algorithm
+// K) for float, double, and long double results and for several bases and
+// reports the faster one for each combination.  It then times
+// unit_normal_distribution<RealType, algorithm> with algorithm =
+// von_neumann_normal, ziggurat_normal, and kahn_normal and reports which
+// policy to use for each RealType on this host.  Each time is the best of 3
+// runs.
+//
+// Usage: tune_normal [--samples M] [--seed S]
+//
+// M (default 1000000) is the number of samples per run.
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include <cstdlib>
+#include <exrandom/rand_digit.hpp>
+#include <exrandom/unit_normal_dist.hpp>
+#include <exrandom/unit_normal_kahn.hpp>
+#include <exrandom/unit_normal_distribution.hpp>
+
+long long samples = 1000000LL;
+unsigned seed = 0;
+
+// The best of 3 times (ns per sample) for Dist::value<RealType>
+template<typename RealType, typename Dist, typename digit_gen>
+double time_dist() {
+  double best = 0;
+  for (int r = 0; r < 3; ++r) {
+    std::mt19937_64 g(seed);
+    digit_gen D;
+    Dist d(D);
+    RealType sum = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    for (long long i = 0; i < samples; ++i)
+      sum += d.template value<RealType>(g);
+    auto t1 = std::chrono::steady_clock::now();
+    double t = double(std::chrono::duration_cast<std::chrono::nanoseconds>
+                      (t1 - t0).count()) / samples;
+    if (sum == RealType(-1)) std::cerr << " ";  // so that sum is used
+    best = r ? (std::min)(best, t) : t;
+  }
+  return best;
+}
+
+// The best of 3 times (ns per sample) for unit_normal_distribution
+template<typename RealType, typename algorithm>
+double time_policy() {
+  double best = 0;
+  for (int r = 0; r < 3; ++r) {
+    std::mt19937_64 g(seed);
+    exrandom::unit_normal_distribution<RealType, algorithm> d;
+    RealType sum = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    for (long long i = 0; i < samples; ++i)
+      sum += d(g);
+    auto t1 = std::chrono::steady_clock::now();
+    double t = double(std::chrono::duration_cast<std::chrono::nanoseconds>
+                      (t1 - t0).count()) / samples;
+    if (sum == RealType(-1)) std::cerr << " ";
+    best = r ? (std::min)(best, t) : t;
+  }
+  return best;
+}
+
+void print(const std::string& type, const std::string& base,
+           double tn, double tk) {
+  std::cout << std::left << std::setw(13) << type << std::setw(7) << base
+            << std::right << std::fixed << std::setprecision(1)
+            << std::setw(10) << tn;
+  if (tk > 0)
+    std::cout << std::setw(10) << tk << "  "
+              << (tn <= tk ? "von_neumann" : "kahn") << "\n";
+  else
+    std::cout << std::setw(10) << "-" << "  von_neumann\n";
+}
+
+// Kahn's method is only available for bases up to 16
+template<typename RealType, exrandom::uint_t b>
+void tune_base(const std::string& type, const std::string& base) {
+  typedef exrandom::rand_digit<b> digit_gen;
+  double tn = time_dist<RealType, exrandom::unit_normal_dist<digit_gen>,
+                        digit_gen>(),
+    tk = b && b <= 16U ?
+    time_dist<RealType, exrandom::unit_normal_kahn
+              <exrandom::rand_digit<(b && b <= 16U ? b : 2U)> >,
+              exrandom::rand_digit<(b && b <= 16U ? b : 2U)> >() : -1;
+  print(type, base, tn, tk);
+}
+
+template<typename RealType>
+void tune(const std::string& type) {
+  tune_base<RealType, 2U>(type, "2");
+  tune_base<RealType, 4U>(type, "4");
+  tune_base<RealType, 16U>(type, "16");
+  tune_base<RealType, 1U<<16>(type, "2^16");
+  tune_base<RealType, 0U>(type, "2^32");
+}
+
+template<typename RealType>
+void recommend(const std::string& type) {
+  double tn = time_policy<RealType, exrandom::von_neumann_normal>(),
+    tz = time_policy<RealType, exrandom::ziggurat_normal>(),
+    tk = time_policy<RealType, exrandom::kahn_normal>();
+  std::cout << std::left << std::setw(13) << type << std::right
+            << std::fixed << std::setprecision(1)
+            << std::setw(10) << tn << std::setw(10) << tz
+            << std::setw(10) << tk << "  "
+            << (tz <= tn && tz <= tk ? "ziggurat_normal" :
+                tn <= tk ? "von_neumann_normal" : "kahn_normal") << "\n";
+}
+
+int main(int argc, char* argv[]) {
+  seed = std::random_device()();
+  for (int i = 1; i < argc; ++i) {
+    std::string a(argv[i]);
+    if (a == "--samples" && i + 1 < argc)
+      samples = (std::max)(1LL, std::atoll(argv[++i]));
+    else if (a == "--seed" && i + 1 < argc)
+      seed = unsigned(std::strtoul(argv[++i], 0, 10));
+    else {
+      std::cerr << "Usage: " << argv[0] << " [--samples M] [--seed S]\n";
+      return 1;
+    }
+  }
+  std::cerr << "Seed set to " << seed << "\n";
+  std::cout << "Times (ns/sample) for unit_normal_dist (N) and "
+            << "unit_normal_kahn (K)\n"
+            << std::left << std::setw(13) << "RealType" << std::setw(7)
+            << "base" << std::right << std::setw(10) << "N"
+            << std::setw(10) << "K" << "  faster\n";
+  tune<float>("float");
+  tune<double>("double");
+  tune<long double>("long double");
+  std::cout << "\nTimes (ns/sample) for unit_normal_distribution<RealType, "
+            << "algorithm>\n"
+            << std::left << std::setw(13) << "RealType" << std::right
+            << std::setw(10) << "N" << std::setw(10) << "Z"
+            << std::setw(10) << "K" << "  recommended algorithm\n";
+  recommend<float>("float");
+  recommend<double>("double");
+  recommend<long double>("long double");
+  return 0;
+}
@@ -2,17 +2,24 @@
 #include <iomanip>
 #include <cmath>
 #include <vector>
+#include <memory>
 #include <map>
+#include <limits>
 #include <exrandom/unit_normal_distribution.hpp>
 #include <exrandom/unit_exponential_distribution.hpp>
 #include <exrandom/unit_uniform_distribution.hpp>
 #include <exrandom/discrete_normal_distribution.hpp>
+#include <exrandom/geometric_distribution.hpp>
+#include <exrandom/discrete_laplace_distribution.hpp>
+#include <exrandom/rand_digit.hpp>
+#include <exrandom/normal_tail_dist.hpp>
+#include <exrandom/truncated_exponential_dist.hpp>
 #include <exrandom/aux_info.hpp>
 
 // Compute probs for num bins [x0+n*dx, x0+(n+1)*dx] for n=[0,num) plus an
-// (num+1)th bin for everything else
-std::vector<double> probs(double (*f)(double),
-                          double x0, double dx, int nbins) {
+// (num+1)th bin for everything else; f is the cumulative distribution
+template<typename F>
+std::vector<double> probs(F f, double x0, double dx, int nbins) {
   std::vector<double> r(nbins+1, 0);
   double s = 0;
   for (int n = 0; n < nbins; ++n) {
@@ -42,6 +49,44 @@ std::vector<double> discrete_normal_probs(const param_type& p,
   return r;
 }
 
+// Compute probs for discrete Laplace with P_i proportional to exp(-|i-mu|/t)
+// using num bins [x0+n*dx, x0+(n+1)*dx) for i=[0,num) plus an (num+1)th bin
+// for everything else.  With c = ceil(mu), the tails i >= c and i < c are
+// geometric with weights exp(-(c-mu)/t) and exp(-(mu-c+1)/t).
+std::vector<double> discrete_laplace_probs(double mu, double t,
+                                           int x0, int dx, int nbins) {
+  int c = int(std::ceil(mu));
+  double norm = (std::exp(-(c - mu)/t) + std::exp(-(mu - c + 1)/t)) /
+    (-std::expm1(-1/t));
+  std::vector<double> r(nbins+1, 0);
+  double s = 0;
+  for (int n = 0; n < nbins; ++n) {
+    for (int j = 0; j < dx; ++j)
+      r[n] += std::exp(-std::fabs(x0 + dx * n + j - mu)/t) / norm;
+    s += r[n];
+  }
+  r[nbins] = 1 - s;
+  return r;
+}
+
+// The cumulative distribution for |x| where x is normal with |x| > t
+struct normal_tail_cdf {
+  double t;
+  double operator()(double x) const {
+    return x <= t ? 0 :
+      1 - std::erfc(x/std::sqrt(2.0)) / std::erfc(t/std::sqrt(2.0));
+  }
+};
+
+// The cumulative distribution for the exponential restricted to [a, a+w)
+struct truncated_exponential_cdf {
+  double a, w;
+  double operator()(double x) const {
+    return x <= a ? 0 : (x >= a + w ? 1 :
+                         std::expm1(a - x) / std::expm1(-w));
+  }
+};
+
 double chisqf(const std::vector<double>& probs,
               std::map<int, long long>& counts) {
   int nbins = int(probs.size()) - 1;
@@ -80,6 +125,85 @@ void discrete_chisq(Generator& g, long long num,
               << ", chi-squared = " << chisq << std::endl;
   }
 
+// The geometric distribution is the special case mu = 0 and x0 >= 0 of
+// discrete_laplace_probs scaled by 1 + exp(-1/t)
+template<typename Generator>
+void geometric_chisq(Generator& g, long long num, int t_num, int t_den,
+                     int dx, int DOF) {
+  exrandom::geometric_distribution d(t_num, t_den);
+  double t = d.t_num() / double(d.t_den());
+  std::vector<int> v(1000);
+  std::map<int, long long> hist;
+  for (long long i = 0; i < num; i += 1000) {
+    d.generate(&v[0], v.size(), g);
+    for (size_t j = 0; j < v.size(); ++j) ++hist[v[j] / dx];
+  }
+  std::vector<double> p = discrete_laplace_probs(0, t, 0, dx, DOF);
+  double s = 0;
+  for (int n = 0; n < DOF; ++n) s += (p[n] *= 1 + std::exp(-1/t));
+  p[DOF] = 1 - s;
+  double chisq = chisqf(p, hist);
+  std::cout << "geometric_distribution (t = " << t << "): samples = "
+            << num << ", DOF = " << DOF
+            << ", chi-squared = " << chisq << std::endl;
+}
+
+template<typename Generator>
+void laplace_chisq(Generator& g, long long num,
+                   int mu_num, int mu_den, int t_num, int t_den,
+                   int x0, int dx, int DOF) {
+  exrandom::discrete_laplace_distribution d(mu_num, mu_den, t_num, t_den);
+  double mu = d.mu_num() / double(d.mu_den()),
+    t = d.t_num() / double(d.t_den());
+  std::map<int, long long> hist;
+  for (long long i = 0; i < num; ++i)
+    ++hist[int(std::floor((d(g) - x0 + 0.5)/dx))];
+  double chisq = chisqf(discrete_laplace_probs(mu, t, x0, dx, DOF), hist);
+  std::cout << "discrete_laplace_distribution (mu = " << mu
+            << ", t = " << t << "):\n            samples = "
+            << num << ", DOF = " << DOF
+            << ", chi-squared = " << chisq << std::endl;
+}
+
+template<typename Generator>
+void tail_chisq(Generator& g, long long num, int t_num, int t_den,
+                double dx, int DOF) {
+  typedef exrandom::rand_digit<0> digit_gen;
+  digit_gen D;
+  exrandom::normal_tail_dist<digit_gen> d(D, t_num, t_den);
+  normal_tail_cdf cdf = { t_num / double(t_den) };
+  std::map<int, long long> hist;
+  for (long long i = 0; i < num; ++i)
+    ++hist[int(std::floor( (std::fabs(d.value<double>(g)) - cdf.t) / dx ))];
+  double chisq = chisqf(probs(cdf, cdf.t, dx, DOF), hist);
+  std::cout << "normal_tail_dist (t = " << cdf.t << "): samples = "
+            << num << ", DOF = " << DOF
+            << ", chi-squared = " << chisq << std::endl;
+}
+
+// b_den = 0 for the tail [a, inf)
+template<typename Generator>
+void truncated_chisq(Generator& g, long long num, int a_num, int a_den,
+                     int b_num, int b_den, double dx, int DOF) {
+  typedef exrandom::rand_digit<0> digit_gen;
+  typedef exrandom::truncated_exponential_dist<digit_gen> dist;
+  digit_gen D;
+  std::unique_ptr<dist> p(b_den ? new dist(D, a_num, a_den, b_num, b_den) :
+                          new dist(D, a_num, a_den));
+  dist& d = *p;
+  double a = a_num / double(a_den),
+    w = b_den ? b_num / double(b_den) - a :
+    std::numeric_limits<double>::infinity();
+  truncated_exponential_cdf cdf = { a, w };
+  std::map<int, long long> hist;
+  for (long long i = 0; i < num; ++i)
+    ++hist[int(std::floor( (d.value<double>(g) - a) / dx ))];
+  double chisq = chisqf(probs(cdf, a, dx, DOF), hist);
+  std::cout << "truncated_exponential_dist (a = " << a << ", b = " << a + w
+            << "):\n            samples = " << num << ", DOF = " << DOF
+            << ", chi-squared = " << chisq << std::endl;
+}
+
 int main() {
   unsigned s = std::random_device()(); // Set seed from random_device
   std::mt19937 g(s);                   // Initialize URNG
@@ -147,4 +271,19 @@ int main() {
   discrete_chisq(g, num, 0, 1, 61, 10, -24, 1, 50);
   discrete_chisq(g, num, -5, 3, 69, 10, -24, 1, 50);
   discrete_chisq(g, num, 201, 7, 1301, 2, -2500, 100, 50);
+
+  geometric_chisq(g, num, 10, 1, 1, 50);
+  geometric_chisq(g, num, 7, 3, 1, 15);
+  geometric_chisq(g, num, 1000, 1, 100, 50);
+  laplace_chisq(g, num, 0, 1, 5, 1, -25, 1, 50);
+  laplace_chisq(g, num, 1, 3, 17, 4, -23, 1, 46);
+  laplace_chisq(g, num, -5, 2, 1, 2, -6, 1, 8);
+  laplace_chisq(g, num, 201, 7, 1301, 2, -2500, 100, 50);
+
+  tail_chisq(g, num, 1, 2, 0.08, 50);     // 50 bins in [1/2, 9/2]
+  tail_chisq(g, num, 7, 2, 0.04, 50);     // 50 bins in [7/2, 11/2]
+  tail_chisq(g, num, 10, 1, 0.01, 50);    // 50 bins in [10, 10.5]
+  truncated_chisq(g, num, 3, 1, 0, 0, 0.16, 50); // 50 bins in [3, 11]
+  truncated_chisq(g, num, 2, 1, 7, 2, 0.03, 49); // 49 bins in [2, 7/2)
+  truncated_chisq(g, num, 1, 1, 5, 4, 0.005, 49); // 49 bins in [1, 5/4)
 }
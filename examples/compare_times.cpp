@@ -2,9 +2,17 @@
 #include <iomanip>
 #include <random>
 #include <chrono>
+#include <vector>
+#include <memory>
+#include <cmath>
 #include <exrandom/unit_normal_distribution.hpp>
 #include <exrandom/unit_exponential_distribution.hpp>
+#include <exrandom/unit_exponential_lanes.hpp>
 #include <exrandom/discrete_normal_distribution.hpp>
+#include <exrandom/geometric_distribution.hpp>
+#include <exrandom/discrete_laplace_distribution.hpp>
+#include <exrandom/normal_tail_dist.hpp>
+#include <exrandom/truncated_exponential_dist.hpp>
 
 template<typename Dist, typename Generator>
 double timer(long long num, Dist& d, Generator& g) {
@@ -18,6 +26,24 @@ double timer(long long num, Dist& d, Generator& g) {
   return dt/num;
 }
 
+// Time unit_exponential_lanes filling batches of 1000
+template<typename real, typename Generator>
+double lanes_timer(long long num, Generator& g) {
+  exrandom::rand_digit<0U> D;
+  exrandom::unit_exponential_lanes<exrandom::rand_digit<0U> > d(D);
+  std::vector<real> v(1000);
+  real sum = 0;
+  auto t0 = std::chrono::high_resolution_clock::now();
+  for (long long i = 0; i < num; i += 1000) {
+    d.generate(g, &v[0], 1000);
+    sum += v[0];
+  }
+  auto t1 = std::chrono::high_resolution_clock::now();
+  double dt = double(std::chrono::duration_cast<std::chrono::nanoseconds>
+                       (t1 - t0).count());
+  return dt/num;
+}
+
 template<typename Generator>
 void discrete_timer(Generator& g, long long num,
                     int mu_num, int mu_den, int sigma_num, int sigma_den) {
@@ -26,7 +52,127 @@ void discrete_timer(Generator& g, long long num,
   double t = timer(num, d, g);
   std::cout << "  time with mu = " << d.mu_num() << "/" << d.mu_den()
             << ", sigma = " << d.sigma_num() << "/" << d.sigma_den()
-            << ": " << t << " ns" << std::endl;
+            << ": " << t << " ns";
+  if (d.table_bytes())
+    std::cout << " (table of " << d.table_bytes() << " bytes)";
+  std::cout << std::endl;
+}
+
+// Time discrete_normal_dist with long long results (for large sigma)
+template<typename Generator>
+void discrete_timer_wide(Generator& g, long long num,
+                         long long mu_num, long long mu_den,
+                         long long sigma_num, long long sigma_den) {
+  typedef exrandom::rand_digit<1U<<16> digit_gen;
+  digit_gen D;
+  exrandom::discrete_normal_dist<digit_gen, false, exrandom::no_stats,
+                                 long long>
+    d(D, mu_num, mu_den, sigma_num, sigma_den);
+  long long sum = 0;
+  auto t0 = std::chrono::high_resolution_clock::now();
+  for (long long i = 0; i < num; ++i)
+    sum += d(g);
+  auto t1 = std::chrono::high_resolution_clock::now();
+  double t = double(std::chrono::duration_cast<std::chrono::nanoseconds>
+                    (t1 - t0).count()) / num;
+  std::cout << "  time with mu = " << d.mu_num() << "/" << d.mu_den()
+            << ", sigma = " << d.sigma_num() << "/" << d.sigma_den()
+            << " (long long): " << t << " ns" << std::endl;
+}
+
+// Time geometric_distribution and std::geometric_distribution with p = 1 -
+// exp(-1/t)
+template<typename Generator>
+void geometric_timer(Generator& g, long long num, int t_num, int t_den) {
+  exrandom::geometric_distribution d(t_num, t_den);
+  std::geometric_distribution<int>
+    d1(-std::expm1(-double(d.t_den()) / d.t_num()));
+  double t1 = timer(num, d1, g), t2 = timer(num, d, g);
+  std::cout << "  time with t = " << d.t_num() << "/" << d.t_den()
+            << ": C++11/random = " << t1 << " ns; exrandom = " << t2
+            << " ns" << std::endl;
+}
+
+// Time discrete_laplace_distribution and the difference of two
+// std::geometric_distribution deviates (for integer mu)
+template<typename Generator>
+void laplace_timer(Generator& g, long long num,
+                   int mu_num, int mu_den, int t_num, int t_den) {
+  exrandom::discrete_laplace_distribution d(mu_num, mu_den, t_num, t_den);
+  double t2 = timer(num, d, g);
+  std::cout << "  time with mu = " << d.mu_num() << "/" << d.mu_den()
+            << ", t = " << d.t_num() << "/" << d.t_den() << ": ";
+  if (d.mu_den() == 1) {
+    std::geometric_distribution<int>
+      d1(-std::expm1(-double(d.t_den()) / d.t_num()));
+    int sum = 0;
+    auto t0 = std::chrono::high_resolution_clock::now();
+    for (long long i = 0; i < num; ++i)
+      sum += d.mu_num() + d1(g) - d1(g);
+    auto t1 = std::chrono::high_resolution_clock::now();
+    std::cout << "C++11/random = "
+              << double(std::chrono::duration_cast<std::chrono::nanoseconds>
+                        (t1 - t0).count()) / num << " ns; ";
+  }
+  std::cout << "exrandom = " << t2 << " ns" << std::endl;
+}
+
+// Time a *_dist class with a value<double> member function
+template<typename Dist, typename Generator>
+double value_timer(long long num, Dist& d, Generator& g) {
+  double sum = 0;
+  auto t0 = std::chrono::high_resolution_clock::now();
+  for (long long i = 0; i < num; ++i)
+    sum += d.template value<double>(g);
+  auto t1 = std::chrono::high_resolution_clock::now();
+  double dt = double(std::chrono::duration_cast<std::chrono::nanoseconds>
+                       (t1 - t0).count());
+  return dt/num;
+}
+
+// Time normal_tail_dist and, for t <= 2, rejecting the results of
+// unit_normal_distribution with |x| <= t
+template<typename Generator>
+void tail_timer(Generator& g, long long num, int t_num, int t_den) {
+  exrandom::rand_digit<0U> D;
+  exrandom::normal_tail_dist<exrandom::rand_digit<0U> > d(D, t_num, t_den);
+  double t = t_num / double(t_den), t1 = value_timer(num, d, g);
+  std::cout << "  time with t = " << t << ": exact = " << t1 << " ns";
+  if (t <= 2) {
+    exrandom::unit_normal_distribution<double> n;
+    long long m = num / 100;
+    double sum = 0;
+    auto t0 = std::chrono::high_resolution_clock::now();
+    for (long long i = 0; i < m; ++i) {
+      double x;
+      do x = n(g); while (!(std::abs(x) > t));
+      sum += x;
+    }
+    auto t2 = std::chrono::high_resolution_clock::now();
+    std::cout << "; rejection = "
+              << double(std::chrono::duration_cast<std::chrono::nanoseconds>
+                        (t2 - t0).count()) / m << " ns";
+  }
+  std::cout << std::endl;
+}
+
+// Time truncated_exponential_dist; b_den = 0 for the tail [a, inf)
+template<typename Generator>
+void truncated_timer(Generator& g, long long num,
+                     int a_num, int a_den, int b_num, int b_den) {
+  typedef exrandom::truncated_exponential_dist<exrandom::rand_digit<0U> >
+    dist;
+  exrandom::rand_digit<0U> D;
+  std::unique_ptr<dist> p(b_den ? new dist(D, a_num, a_den, b_num, b_den) :
+                          new dist(D, a_num, a_den));
+  dist& d = *p;
+  double t = value_timer(num, d, g);
+  std::cout << "  time with a = " << a_num << "/" << a_den << ", b = ";
+  if (b_den)
+    std::cout << b_num << "/" << b_den;
+  else
+    std::cout << "inf";
+  std::cout << ": " << t << " ns" << std::endl;
 }
 
 int main() {
@@ -43,10 +189,13 @@ int main() {
     double t1 = timer(num, d1, g);
     exrandom::unit_normal_distribution<real> d2;
     double t2 = timer(num, d2, g);
+    exrandom::unit_normal_distribution<real, exrandom::ziggurat_normal> d3;
+    double t3 = timer(num, d3, g);
     std::cout << "  time with prec "
               << std::numeric_limits<real>::digits
               << ": C++11/random = " << t1
-              << " ns; exrandom = " << t2 << " ns" << std::endl;
+              << " ns; exrandom = " << t2 << " ns; ziggurat = " << t3
+              << " ns" << std::endl;
   }
   {
     typedef double real;
@@ -54,10 +203,13 @@ int main() {
     double t1 = timer(num, d1, g);
     exrandom::unit_normal_distribution<real> d2;
     double t2 = timer(num, d2, g);
+    exrandom::unit_normal_distribution<real, exrandom::ziggurat_normal> d3;
+    double t3 = timer(num, d3, g);
     std::cout << "  time with prec "
               << std::numeric_limits<real>::digits
               << ": C++11/random = " << t1
-              << " ns; exrandom = " << t2 << " ns" << std::endl;
+              << " ns; exrandom = " << t2 << " ns; ziggurat = " << t3
+              << " ns" << std::endl;
   }
   {
     // For Visual Studio long double is the same as double
@@ -66,10 +218,13 @@ int main() {
     double t1 = timer(num, d1, g);
     exrandom::unit_normal_distribution<real> d2;
     double t2 = timer(num, d2, g);
+    exrandom::unit_normal_distribution<real, exrandom::ziggurat_normal> d3;
+    double t3 = timer(num, d3, g);
     std::cout << "  time with prec "
               << std::numeric_limits<real>::digits
               << ": C++11/random = " << t1
-              << " ns; exrandom = " << t2 << " ns" << std::endl;
+              << " ns; exrandom = " << t2 << " ns; ziggurat = " << t3
+              << " ns" << std::endl;
   }
 
   std::cout << "Compare times to sample from the exponential distribution\n";
@@ -79,10 +234,12 @@ int main() {
     double t1 = timer(num, d1, g);
     exrandom::unit_exponential_distribution<real> d2;
     double t2 = timer(num, d2, g);
+    double t3 = lanes_timer<real>(num, g);
     std::cout << "  time with prec "
               << std::numeric_limits<real>::digits
               << ": C++11/random = " << t1
-              << " ns; exrandom = " << t2 << " ns" << std::endl;
+              << " ns; exrandom = " << t2 << " ns; lanes = " << t3
+              << " ns" << std::endl;
   }
   {
     typedef double real;
@@ -90,10 +247,12 @@ int main() {
     double t1 = timer(num, d1, g);
     exrandom::unit_exponential_distribution<real> d2;
     double t2 = timer(num, d2, g);
+    double t3 = lanes_timer<real>(num, g);
     std::cout << "  time with prec "
               << std::numeric_limits<real>::digits
               << ": C++11/random = " << t1
-              << " ns; exrandom = " << t2 << " ns" << std::endl;
+              << " ns; exrandom = " << t2 << " ns; lanes = " << t3
+              << " ns" << std::endl;
   }
   {
     // For Visual Studio long double is the same as double
@@ -123,4 +282,36 @@ int main() {
   discrete_timer(g, num,  0, 1, (1<<18)-1, 1);
   discrete_timer(g, num,  0, 1, (1<<18),   1);
   discrete_timer(g, num,  0, 1, (1<<18)+1, 1);
+  discrete_timer_wide(g, num, 0, 1, (1<<18)+1, 1);
+  discrete_timer_wide(g, num, 1, 7, 1LL<<24, 1);
+  discrete_timer_wide(g, num, 1, 7, 1LL<<32, 1);
+  discrete_timer_wide(g, num, 1, 2, 1LL<<40, 1);
+
+  std::cout << "Times to sample from the geometric distribution\n";
+  geometric_timer(g, num, 1, 4);
+  geometric_timer(g, num, 1, 1);
+  geometric_timer(g, num, 10, 1);
+  geometric_timer(g, num, 1000, 3);
+  geometric_timer(g, num, 1000000, 1);
+
+  std::cout << "Times to sample from the discrete Laplace distribution\n";
+  laplace_timer(g, num, 0, 1, 1, 4);
+  laplace_timer(g, num, 0, 1, 1, 1);
+  laplace_timer(g, num, 3, 1, 10, 1);
+  laplace_timer(g, num, 1, 3, 10, 1);
+  laplace_timer(g, num, 0, 1, 1000, 3);
+  laplace_timer(g, num, -2, 7, 1000000, 1);
+
+  std::cout << "Times to sample from the tails of the normal distribution\n";
+  tail_timer(g, num, 1, 2);
+  tail_timer(g, num, 2, 1);
+  tail_timer(g, num, 3, 1);
+  tail_timer(g, num, 10, 1);
+  tail_timer(g, num, 1000, 1);
+
+  std::cout << "Times to sample from the truncated exponential distribution\n";
+  truncated_timer(g, num, 3, 1, 0, 0);
+  truncated_timer(g, num, 100, 1, 0, 0);
+  truncated_timer(g, num, 2, 1, 7, 2);
+  truncated_timer(g, num, 1, 1, 5, 4);
 }
@@ -234,4 +234,20 @@ int main() {
     print_hist(bitcount);
   }
 
+  {
+    std::cout
+      << "Bits needed for normal deviates of reduced precision\n";
+    exrandom::rand_digit<b> D;
+    exrandom::unit_normal_dist<exrandom::rand_digit<b>> N(D);
+    const int precs[] = {8, 16, 24, std::numeric_limits<double>::digits};
+    for (int j = 0; j < 4; ++j) {
+      long long c0 = D.count();
+      for (long long i = 0; i < num; ++i)
+        N.reduced_value<double>(g, precs[j]);
+      std::cout << "precision = " << precs[j] << ", <bits> = "
+                << (D.count() - c0)/double(num) << "\n";
+    }
+    std::cout << std::endl;
+  }
+
 }
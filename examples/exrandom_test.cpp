@@ -1,10 +1,254 @@
 #include <iomanip>
 #include <limits>
 #include <cmath>
+#include <vector>
+#include <memory>
+#include <sstream>
+#include <fstream>
+#include <cstdio>
+#include <stdexcept>
+#include <atomic>
+#include <new>
+#include <cstdlib>
 #include <exrandom/unit_normal_distribution.hpp>
+#include <exrandom/unit_normal_kahn.hpp>
 #include <exrandom/unit_exponential_distribution.hpp>
+#include <exrandom/unit_exponential_lanes.hpp>
 #include <exrandom/unit_uniform_distribution.hpp>
 #include <exrandom/discrete_normal_distribution.hpp>
+#include <exrandom/discrete_normal_ct.hpp>
+#include <exrandom/buffered_rand_digit.hpp>
+#include <exrandom/inline_digits.hpp>
+#include <exrandom/normal_k_table.hpp>
+#include <exrandom/normal_ziggurat_table.hpp>
+#include <exrandom/sample_stats.hpp>
+#include <exrandom/samplers.hpp>
+#include <exrandom/philox_engine.hpp>
+#include <exrandom/u_rand_stream.hpp>
+#include <exrandom/scaled_u_rand.hpp>
+#include <exrandom/u_rand_workspace.hpp>
+#include <exrandom/normal_tail_dist.hpp>
+#include <exrandom/truncated_exponential_dist.hpp>
+#include <exrandom/mapped_file_gen.hpp>
+#include <exrandom/low_precision.hpp>
+#include <exrandom/prefetch_gen.hpp>
+#include <exrandom/sample_stream.hpp>
+#include <exrandom/perf_stats.hpp>
+#include <exrandom/bernoulli.hpp>
+#include <exrandom/geometric_distribution.hpp>
+#include <exrandom/discrete_laplace_distribution.hpp>
+
+// Count all the allocations with operator new (to check that sampling
+// doesn't allocate)
+static std::atomic<long long> new_count(0);
+void* operator new(size_t n) {
+  ++new_count;
+  void* p = std::malloc(n ? n : 1);
+  if (!p) throw std::bad_alloc();
+  return p;
+}
+// The deletes are not inlined, to avoid a spurious -Wmismatched-new-delete
+// warning (g++ 12)
+#if defined(__GNUC__)
+#define NOT_INLINED __attribute__((noinline))
+#else
+#define NOT_INLINED
+#endif
+NOT_INLINED void operator delete(void* p) noexcept { std::free(p); }
+#if __cplusplus >= 201402L
+NOT_INLINED void operator delete(void* p, size_t) noexcept { std::free(p); }
+#endif
+
+// An allocator which counts the number of allocations
+template<typename T> class counting_allocator {
+public:
+  typedef T value_type;
+  static long long count;
+  counting_allocator() {}
+  template<typename U> counting_allocator(const counting_allocator<U>&) {}
+  T* allocate(size_t n) { ++count; return std::allocator<T>().allocate(n); }
+  void deallocate(T* p, size_t n) { std::allocator<T>().deallocate(p, n); }
+  bool operator==(const counting_allocator&) const { return true; }
+  bool operator!=(const counting_allocator&) const { return false; }
+};
+template<typename T> long long counting_allocator<T>::count = 0;
+
+// A buffered_rand_digit for which u_rand::less_than uses the digit-by-digit
+// comparison
+template<exrandom::uint_t b>
+class unpeekable_rand_digit : public exrandom::buffered_rand_digit<b> {};
+
+// A 32-bit engine which returns zeros() zeros before continuing with
+// mt19937; with rand_digit<2>, this gives u_rands with leading zero digits.
+class zero_prefix_engine {
+public:
+  typedef unsigned result_type;
+  explicit zero_prefix_engine(unsigned s) : _g(s), _z(0) {}
+#if EXRANDOM_CONSTEXPR
+  static constexpr result_type min() { return 0U; }
+  static constexpr result_type max() { return 0xffffffffU; }
+#else
+  static result_type min() { return 0U; }
+  static result_type max() { return 0xffffffffU; }
+#endif
+  result_type operator()() { return _z ? (--_z, 0U) : result_type(_g()); }
+  void zeros(int z) { _z = z; }
+private:
+  std::mt19937 _g;
+  int _z;
+};
+
+// An engine which returns 1, 2, ..., n and then throws
+class finite_engine {
+public:
+  typedef unsigned result_type;
+#if EXRANDOM_CONSTEXPR
+  static constexpr result_type min() { return 0U; }
+  static constexpr result_type max() { return 0xffffffffU; }
+#else
+  static result_type min() { return 0U; }
+  static result_type max() { return 0xffffffffU; }
+#endif
+  explicit finite_engine(unsigned n) : _n(n), _k(0) {}
+  result_type operator()() {
+    if (_k >= _n) throw std::runtime_error("finite_engine: end");
+    return ++_k;
+  }
+private:
+  unsigned _n, _k;
+};
+
+// mt19937 with its range treated as unknown at compile time, forcing the
+// digit generators to check the range at run time
+class runtime_range_engine : public std::mt19937 {
+public:
+  explicit runtime_range_engine(unsigned s) : std::mt19937(s) {}
+};
+namespace exrandom {
+  template<> class engine_bits<runtime_range_engine> {
+  public:
+    static const int value = -1;
+  };
+}
+
+// Round d >= 0 (the true result truncated to a double) to a multiple of
+// 2^q; mode = 0 (nearest), 1 (toward zero), 2 (away from zero).  The true
+// result is never a multiple of 2^q or a tie.
+double spaced_round(double d, int q, int mode) {
+  double t = std::ldexp(d, -q), f = std::floor(t);
+  if (mode == 0 ? t - f >= 0.5 : mode == 2) f += 1;
+  return std::ldexp(f, q);
+}
+
+// The digit-by-digit u_rand::compare(g, u1, u2, v) for x >= 0
+template<typename digit_gen, typename Generator>
+int reference_compare(exrandom::u_rand<digit_gen>& x, Generator& g,
+                      long long u1, long long u2, long long v) {
+  long long lbase = (long long)(digit_gen::max_value) + 1;
+  u1 = (std::max)(0LL, u1 - (long long)(x.integer()) * v);
+  u2 = (std::min)( v , u2 - (long long)(x.integer()) * v);
+  for (size_t k = 0;; ++k) {
+    if (u1 >= v) return -1;
+    if (u2 <= 0) return  1;
+    if (u1 <= 0 && u2 >= v) return 0;
+    long long d = x.digit(g, k);
+    u1 = (std::max)(0LL, u1 * lbase - d * v);
+    u2 = (std::min)( v , u2 * lbase - d * v);
+  }
+}
+
+// Count the differences between u_rand::compare and reference_compare in
+// the results, the digits, and the subsequent state of the engine
+template<typename digit_gen>
+int compare_differences(unsigned seed) {
+  std::mt19937 g1(seed), g2(seed), h(seed);
+  digit_gen D1, D2;
+  exrandom::u_rand<digit_gen> x(D1), y(D2);
+  const long long vs[] = {2, 6, 8, 1000, 1024, 3LL << 20, 1LL << 24,
+                          (1LL << 40) + 1, 1LL << 40};
+  int bad = 0;
+  for (int i = 0; i < 20000; ++i) {
+    long long v = vs[i % 9];
+    std::uniform_int_distribution<long long> U(0, v);
+    long long u1 = U(h), u2 = U(h);
+    if (u1 > u2) std::swap(u1, u2);
+    if (u1 == u2) ++u2;
+    size_t n = size_t(i % 5 == 0 ? i % 61 : 0);
+    x.init(); y.init();
+    if (n) { x.extend(g1, n); y.extend(g2, n); }
+    bad += x.compare(g1, u1, u2, v) != reference_compare(y, g2, u1, u2, v);
+    bad += x.ndigits() != y.ndigits() || D1.count() != D2.count();
+    for (size_t k = 0; k < x.ndigits() && k < y.ndigits(); ++k)
+      bad += x.rawdigit(k) != y.rawdigit(k);
+    bad += D1(g1) != D2(g2);
+  }
+  return bad;
+}
+
+// Count the differences between the word-parallel u_rand::less_than (with
+// buffered_rand_digit<b>) and the digit-by-digit comparison in the results,
+// the digits, and the counts; this includes unit exponential deviates (which
+// use less_than)
+template<exrandom::uint_t b>
+int less_than_differences(unsigned seed) {
+  typedef exrandom::buffered_rand_digit<b> peek_gen;
+  typedef unpeekable_rand_digit<b> plain_gen;
+  std::mt19937_64 g(seed), h(seed), k(seed);
+  peek_gen DP, DR1, DR2; plain_gen DQ;
+  exrandom::u_rand<peek_gen> x(DP), y(DP), r1(DR1), r2(DR2);
+  exrandom::u_rand<plain_gen> u(DQ), v(DQ);
+  int bad = 0;
+  for (int i = 0; i < 20000; ++i) {
+    x.init(); y.init(); u.init(); v.init();
+    bad += x.less_than(g, y) != u.less_than(h, v);
+    bad += x.ndigits() != u.ndigits() || y.ndigits() != v.ndigits();
+    for (size_t j = 0; j < x.ndigits() && j < u.ndigits(); ++j)
+      bad += x.rawdigit(j) != u.rawdigit(j);
+    for (size_t j = 0; j < y.ndigits() && j < v.ndigits(); ++j)
+      bad += y.rawdigit(j) != v.rawdigit(j);
+    bad += DP.count() != DQ.count();
+    // With different digit generators, the digits of each u_rand are drawn
+    // from its own generator
+    long long c1 = DR1.count(), c2 = DR2.count();
+    r1.init(); r2.init();
+    r1.less_than(k, r2);
+    bad += DR1.count() - c1 != (long long)(r1.ndigits()) ||
+      DR2.count() - c2 != (long long)(r2.ndigits());
+  }
+  exrandom::unit_exponential_dist<peek_gen> EP(DP);
+  exrandom::unit_exponential_dist<plain_gen> EQ(DQ);
+  double sx = 0, sy = 0;
+  for (int i = 0; i < 20000; ++i) {
+    EP.generate(g, x); sx += x.template value<double>(g);
+    EQ.generate(h, u); sy += u.template value<double>(h);
+  }
+  bad += sx != sy || DP.count() != DQ.count();
+  return bad;
+}
+
+// chisq for num samples of unit_exponential_lanes<digit_gen, L> in batches of
+// 1000 with bins [i/4, (i+1)/4) for i in [0, 20) and the rest (20 DOF)
+template<typename RealType, typename digit_gen, int L>
+double exponential_lanes_chisq(std::mt19937& g, long long num) {
+  digit_gen D;
+  exrandom::unit_exponential_lanes<digit_gen, L> E(D);
+  std::vector<RealType> v(1000);
+  long long hist[21] = {0};
+  for (long long i = 0; i < num; i += 1000) {
+    E.generate(g, &v[0], 1000);
+    for (int j = 0; j < 1000; ++j) {
+      int k = int(4 * v[j]);
+      ++hist[k < 20 ? k : 20];
+    }
+  }
+  double chisq = 0;
+  for (int k = 0; k <= 20; ++k) {
+    double p = k < 20 ? std::exp(-k/4.0) - std::exp(-(k+1)/4.0) :
+      std::exp(-20/4.0);
+    chisq += (hist[k] - num*p) * (hist[k] - num*p) / (num*p);
+  }
+  return chisq;
+}
 
 int main() {
   static_assert(std::numeric_limits<double>::radix == 2 &&
@@ -75,6 +319,1312 @@ int main() {
                 << "  expected 316205, got " << x << "\n";
     }
   }
+  {
+    // buffered_rand_digit<2> should return the bits of the engine, most
+    // significant first
+    std::mt19937_64 g64(5u), h64(5u);
+    exrandom::buffered_rand_digit<2> D;
+    int bad = 0;
+    for (unsigned i = 0; i < 1000; ++i) {
+      unsigned long long w = h64();
+      for (int k = 64; k--;)
+        bad += D(g64) != ((w >> k) & 1U) ? 1 : 0;
+    }
+    if (bad || D.count() != 64000) {
+      ++retval;
+      std::cerr << "Error in exrandom::buffered_rand_digit:\n"
+                << "  " << bad << " digits differ from engine output\n";
+    }
+  }
+  {
+    // buffered_rand_digit<10> should produce balanced digits while calling
+    // the engine about log2(10)/64 times per digit
+    std::mt19937_64 g64(6u), h64(6u);
+    exrandom::buffered_rand_digit<10> D;
+    long long hist[10] = {0};
+    const long long num = 1000000;
+    for (long long i = 0; i < num; ++i)
+      ++hist[D(g64)];
+    double chisq = 0;
+    for (int k = 0; k < 10; ++k)
+      chisq += (hist[k] - num/10.0) * (hist[k] - num/10.0) / (num/10.0);
+    long long calls = 0;
+    while (h64 != g64) { h64(); ++calls; }
+    // chisq with 9 DOF is less than 27.88 with probability 0.999
+    if (!(chisq < 27.88 && calls == 51906)) {
+      ++retval;
+      std::cerr << "Error in exrandom::buffered_rand_digit<10>:\n"
+                << "  chisq = " << chisq << ", calls = " << calls << "\n";
+    }
+  }
+  {
+    // A u_rand using inline_digits shouldn't allocate memory and should
+    // give the same results as one using std::vector
+    typedef exrandom::rand_digit<0> digit_gen;
+    typedef counting_allocator<exrandom::uint_t> alloc;
+    digit_gen D;
+    exrandom::unit_normal_dist<digit_gen> N(D);
+    double x = 0, y = 0;
+    g.seed(7u);
+    for (unsigned i = 0; i < 100000; ++i) {
+      exrandom::u_rand<digit_gen, exrandom::inline_digits<8, alloc> > u(D);
+      N.generate(g, u);
+      x += u.value<double>(g);
+    }
+    long long inline_count = alloc::count;
+    g.seed(7u);
+    for (unsigned i = 0; i < 100000; ++i) {
+      exrandom::u_rand<digit_gen, std::vector<exrandom::uint_t, alloc> > u(D);
+      N.generate(g, u);
+      y += u.value<double>(g);
+    }
+    if (inline_count != 0 || alloc::count == 0 || x != y) {
+      ++retval;
+      std::cerr << "Error in exrandom::inline_digits:\n"
+                << "  " << inline_count << " allocations, sums "
+                << x << " " << y << "\n";
+    }
+  }
+  {
+    // The batch interface should give the same results as operator()
+    const size_t num = 10000;
+    std::vector<double> a(num), b(num);
+    std::vector<int> c(num), d(num);
+    exrandom::unit_normal_distribution<double> N;
+    exrandom::discrete_normal_distribution D(1,3,129,2);
+    g.seed(8u);
+    N.generate(a.begin(), a.end(), g);
+    D.generate(c.data(), num, g);
+    g.seed(8u);
+    for (size_t i = 0; i < num; ++i) b[i] = N(g);
+    for (size_t i = 0; i < num; ++i) d[i] = D(g);
+    if (a != b || c != d) {
+      ++retval;
+      std::cerr << "Error in batch generate:\n"
+                << "  results differ from operator()\n";
+    }
+  }
+  {
+    // The word-parallel u_rand::less_than should consume the same digits as
+    // the digit-by-digit comparison, including bases whose bits don't divide
+    // 32
+    int bad =
+      less_than_differences<2U>(9u) + less_than_differences<8U>(9u) +
+      less_than_differences<32U>(9u) + less_than_differences<256U>(9u) +
+      less_than_differences<1024U>(9u);
+    if (bad) {
+      ++retval;
+      std::cerr << "Error in word-parallel u_rand::less_than:\n"
+                << "  " << bad << " differences\n";
+    }
+  }
+  {
+    // Sampling with a prepared_param should give the same results as
+    // sampling from a distribution constructed with the parameters.
+    // Sampling with a param_type uses Algorithm D (without a
+    // discrete_normal_table for the small sigma of p2), as does the varying
+    // mu interface of discrete_normal_dist.
+    typedef exrandom::discrete_normal_distribution dist;
+    typedef exrandom::discrete_normal_dist<exrandom::rand_digit<1U<<16> > di;
+    dist::param_type p1(1,3,129,2), p2(-5,1,7,3);
+    dist::prepared_param q1(p1), q2(p2);
+    dist D, D1(p1), D2(p2);
+    exrandom::rand_digit<1U<<16> DI;
+    di N(DI);
+    di::prepared_param r1(p1), r2(p2);
+    long x = 0, y = 0, z = 0, w = 0;
+    g.seed(10u);
+    for (unsigned i = 0; i < 100000; ++i)
+      x += D(g, i % 2 ? q2 : q1);
+    g.seed(10u);
+    for (unsigned i = 0; i < 100000; ++i)
+      y += i % 2 ? D2(g) : D1(g);
+    g.seed(10u);
+    for (unsigned i = 0; i < 100000; ++i)
+      z += D(g, i % 2 ? p2 : p1);
+    g.seed(10u);
+    for (unsigned i = 0; i < 100000; ++i)
+      w += i % 2 ? N(g, r2, p2.mu_num(), p2.mu_den()) :
+        N(g, r1, p1.mu_num(), p1.mu_den());
+    if (x != y || z != w || !(D.param() == dist::param_type())) {
+      ++retval;
+      std::cerr << "Error in discrete_normal_distribution::prepared_param:\n"
+                << "  sums " << x << " " << y << " " << z << " " << w
+                << "\n";
+    }
+  }
+  {
+    // normal_k_table should select k with probability (1 - exp(-1/2)) *
+    // exp(-k^2/2); bins are k = 0, 1, 2, 3, [4, K], and rejected
+    typedef exrandom::rand_digit<0> digit_gen;
+    typedef exrandom::normal_k_table<0> table;
+    digit_gen D;
+    exrandom::u_rand<digit_gen> u(D);
+    long long hist[6] = {0};
+    const long long num = 1000000;
+    g.seed(12u);
+    for (long long i = 0; i < num; ++i) {
+      int k = table::standard()(g, u);
+      ++hist[k < 4 ? k : (k <= table::K ? 4 : 5)];
+    }
+    double p[6], q = 1 - std::exp(-0.5), s = 0, chisq = 0;
+    for (int k = 0; k < table::K; ++k) {
+      if (k < 4) p[k] = q * std::exp(-k*k/2.0);
+      s += q * std::exp(-k*k/2.0);
+    }
+    p[5] = 1 - s - std::exp(-table::K/2.0);
+    p[4] = 1 - p[0] - p[1] - p[2] - p[3] - p[5];
+    for (int k = 0; k < 6; ++k)
+      chisq += (hist[k] - num*p[k]) * (hist[k] - num*p[k]) / (num*p[k]);
+    // chisq with 5 DOF is less than 20.52 with probability 0.999
+    if (!(chisq < 20.52 && D.count() == num)) {
+      ++retval;
+      std::cerr << "Error in exrandom::normal_k_table:\n"
+                << "  chisq = " << chisq << ", digits = " << D.count() << "\n";
+    }
+  }
+  {
+    // scaled_u_rand: with mu = 0 the result matches u_rand::value (scaled by
+    // 2^-3 if sigma = 1/8); with mu = -1/3 and sigma = 7/5 the result is
+    // within 1 ulp of the long double result (allowing for its error).
+    typedef exrandom::rand_digit<0U> digit_gen;
+    digit_gen D;
+    exrandom::unit_normal_dist<digit_gen> N(D);
+    exrandom::u_rand<digit_gen> x(D), y(D);
+    exrandom::scaled_u_rand<digit_gen> X1(x, 0, 1, 1, 1), X8(x, 0, 1, 1, 8),
+      X(x, -1, 3, 7, 5);
+    std::mt19937 g1;
+    int bad = 0;
+    g.seed(19u);
+    for (int i = 0; i < 100000; ++i) {
+      int flag;
+      N.generate(g, x);
+      y = x; g1 = g;
+      double a = X1.value<double>(g), b = y.value<double>(g1);
+      y = x; g1 = g;
+      float c = X1.value<float>(g, std::round_toward_zero),
+        d = y.value<float>(g1, std::round_toward_zero, flag);
+      double e = X8.value<double>(g);
+      if (!(a == b && c == d && e == std::ldexp(a, -3))) ++bad;
+      double z = X.value<double>(g);
+      x.digit(g, x.ndigits() + 1);
+      long double m = x.midpoint<long double>(), t = -1/3.0L + 1.4L * m,
+        err = 4 * std::numeric_limits<long double>::epsilon() *
+        (1/3.0L + 1.4L * std::abs(m));
+      if (!(std::abs(z - t) <= std::ldexp(1.0, std::ilogb(z) - 52) + err))
+        ++bad;
+    }
+    if (bad) {
+      ++retval;
+      std::cerr << "Error in exrandom::scaled_u_rand:\n"
+                << "  " << bad << " mismatches\n";
+    }
+  }
+  {
+    // i_rand<digit_gen, long long> with m = 3 * 2^60 (so that init uses
+    // 128-bit arithmetic if available); bins are x mod 3 and x / (m/4).
+    // discrete_normal_dist<..., long long> with mu = 1/2, sigma = 2^40.
+    typedef exrandom::rand_digit<1U<<16> digit_gen;
+    digit_gen D;
+    exrandom::i_rand<digit_gen, long long> j(D);
+    exrandom::discrete_normal_dist<digit_gen, true, exrandom::no_stats,
+                                   long long> V(D, 1LL, 2LL, 1LL<<40, 1LL);
+    const long long m = 3LL << 60, num = 1200000;
+    long long hist[12] = {0}, bad = 0;
+    g.seed(20u);
+    for (long long i = 0; i < num; ++i) {
+      long long x = j.init(g, m)(g);
+      if (x < 0 || x >= m) ++bad; else ++hist[(x % 3) * 4 + x / (m / 4)];
+    }
+    double chisq = 0;
+    for (int k = 0; k < 12; ++k)
+      chisq += (hist[k] - num/12.0) * (hist[k] - num/12.0) / (num/12.0);
+    const long long nv = 100000;
+    double s1 = 0, s2 = 0;
+    for (long long i = 0; i < nv; ++i) {
+      double x = (double(V(g)) - 0.5) / std::ldexp(1.0, 40);
+      s1 += x; s2 += x * x;
+    }
+    s1 /= nv; s2 = s2 / nv - s1 * s1;
+    // chisq with 11 DOF is less than 31.26 with probability 0.999; the
+    // mean and variance are within 5 standard deviations
+    if (!(bad == 0 && chisq < 31.26 &&
+          std::abs(s1) < 5 / std::sqrt(double(nv)) &&
+          std::abs(s2 - 1) < 5 * std::sqrt(2.0 / nv))) {
+      ++retval;
+      std::cerr << "Error in exrandom::i_rand<digit_gen, long long>:\n"
+                << "  bad = " << bad << ", chisq = " << chisq
+                << ", mean = " << s1 << ", var = " << s2 << "\n";
+    }
+  }
+  {
+    // discrete_normal_dist with a varying mu: mu = 0.3 and sigma = 1.6 as
+    // doubles (with long long), and mu = 1/3 and sigma = 8/5 as rationals;
+    // bins are i in [-3, 3] and the rest.  Check param_type::dyadic.
+    typedef exrandom::rand_digit<1U<<16> digit_gen;
+    typedef exrandom::discrete_normal_dist<digit_gen, true,
+                                           exrandom::no_stats, long long> dl;
+    typedef exrandom::discrete_normal_dist<digit_gen> di;
+    digit_gen D;
+    dl V(D);
+    di W(D);
+    const dl::prepared_param pv(dl::param_type::dyadic(0, 1.6));
+    const di::prepared_param pw(di::param_type(0, 1, 8, 5));
+    const long long num = 500000;
+    long long hv[8] = {0}, hw[8] = {0};
+    g.seed(21u);
+    for (long long i = 0; i < num; ++i) {
+      long long k = V(g, pv, 0.3);
+      ++hv[k >= -3 && k <= 3 ? k + 3 : 7];
+      k = W(g, pw, 1, 3);
+      ++hw[k >= -3 && k <= 3 ? k + 3 : 7];
+    }
+    double chisq[2] = {0, 0}, mu[2] = {0.3, 1/3.0}, sigma[2] = {1.6, 1.6};
+    for (int j = 0; j < 2; ++j) {
+      double p[8], s = 0;
+      for (int k = -50; k <= 50; ++k)
+        s += std::exp(-std::pow((k - mu[j]) / sigma[j], 2) / 2);
+      p[7] = 1;
+      for (int k = -3; k <= 3; ++k) {
+        p[k + 3] = std::exp(-std::pow((k - mu[j]) / sigma[j], 2) / 2) / s;
+        p[7] -= p[k + 3];
+      }
+      const long long* h = j ? hw : hv;
+      for (int k = 0; k < 8; ++k)
+        chisq[j] += (h[k] - num*p[k]) * (h[k] - num*p[k]) / (num*p[k]);
+    }
+    long long n, d;
+    dl::param_type::dyadic(-0.3, n, d);
+    bool ok = n == -5404319552844595LL && d == 1LL << 54;
+    dl::param_type::dyadic(1e12, n, d);
+    ok = ok && n == 1000000000000LL && d == 1;
+    try { dl::param_type::dyadic(1e-30, n, d); ok = false; }
+    catch (const std::runtime_error&) {}
+    // chisq with 7 DOF is less than 24.32 with probability 0.999
+    if (!(chisq[0] < 24.32 && chisq[1] < 24.32 && ok)) {
+      ++retval;
+      std::cerr << "Error in exrandom::discrete_normal_dist with varying mu:\n"
+                << "  chisq = " << chisq[0] << " " << chisq[1]
+                << ", dyadic " << (ok ? "ok" : "wrong") << "\n";
+    }
+  }
+  {
+    // Distributions sharing a u_rand_workspace (and copies of them) give
+    // the same results as those with their own temporary storage.
+    typedef exrandom::rand_digit<2U> digit_gen;
+    typedef exrandom::discrete_normal_dist<digit_gen> discrete;
+    digit_gen D1, D2;
+    exrandom::u_rand_workspace<digit_gen> w(D2);
+    exrandom::unit_normal_dist<digit_gen> N1(D1), N2(w);
+    exrandom::unit_exponential_dist<digit_gen> E1(D1), E2(w);
+    exrandom::unit_normal_kahn<digit_gen> K1(D1), K2(w);
+    exrandom::unit_uniform_dist<digit_gen> U1(D1), U2(w);
+    discrete X1(D1, 1, 3, 5, 2), X2(w, discrete::param_type(1, 3, 5, 2));
+    exrandom::unit_normal_dist<digit_gen> N3(N1), N4(N2);
+    std::mt19937 g1, g2;
+    g.seed(22u); g1 = g; g2 = g;
+    int bad = 0;
+    for (int i = 0; i < 20000; ++i) {
+      if (N1.value<double>(g1) != N2.value<double>(g2)) ++bad;
+      if (E1.value<double>(g1) != E2.value<double>(g2)) ++bad;
+      if (K1.value<double>(g1) != K2.value<double>(g2)) ++bad;
+      if (U1.value<float>(g1) != U2.value<float>(g2)) ++bad;
+      if (X1(g1) != X2(g2)) ++bad;
+      if (N3.value<double>(g1) != N4.value<double>(g2)) ++bad;
+    }
+    if (!(bad == 0 && D1.count() == D2.count())) {
+      ++retval;
+      std::cerr << "Error in exrandom::u_rand_workspace:\n"
+                << "  " << bad << " mismatches, digits "
+                << D1.count() << " " << D2.count() << "\n";
+    }
+  }
+  {
+    // normal_tail_dist (|x| for t = 5/2 and t = 1/2) and
+    // truncated_exponential_dist ([1, 5/4) and [2, inf)); bins of width
+    // 1/10, 1/5, 1/32, 1/3 with the last bin holding the rest.  Also check
+    // u_rand::less_than with multipliers and u_rand::compare with base 2^32.
+    typedef exrandom::rand_digit<0U> digit_gen;
+    digit_gen D;
+    exrandom::normal_tail_dist<digit_gen> T1(D, 5, 2), T2(D, 1, 2);
+    exrandom::truncated_exponential_dist<digit_gen> X1(D, 1, 1, 5, 4),
+      X2(D, 2, 1);
+    const long long num = 200000;
+    long long h[4][8] = {{0}};
+    double x0[4] = {2.5, 0.5, 1, 2}, dx[4] = {0.1, 0.2, 1/32.0, 1/3.0};
+    g.seed(23u);
+    for (long long i = 0; i < num; ++i) {
+      double x[4] = {std::fabs(T1.value<double>(g)),
+                     std::fabs(T2.value<double>(g)),
+                     X1.value<double>(g), X2.value<double>(g)};
+      for (int j = 0; j < 4; ++j) {
+        int k = int(std::floor((x[j] - x0[j]) / dx[j]));
+        ++h[j][k >= 0 && k < 7 ? k : 7];
+      }
+    }
+    double chisq[4] = {0, 0, 0, 0};
+    for (int j = 0; j < 4; ++j) {
+      double p[8], c0 = 0;
+      p[7] = 1;
+      for (int k = 0; k < 7; ++k) {
+        double x = x0[j] + (k + 1) * dx[j],
+          c = j < 2 ? 1 - std::erfc(x / std::sqrt(2.0)) /
+          std::erfc(x0[j] / std::sqrt(2.0)) :
+          (j == 2 ? std::expm1(x0[j] - x) / std::expm1(-0.25) :
+           -std::expm1(x0[j] - x));
+        p[k] = c - c0; c0 = c; p[7] -= p[k];
+      }
+      for (int k = 0; k < 8; ++k)
+        chisq[j] += (h[j][k] - num*p[k]) * (h[j][k] - num*p[k]) / (num*p[k]);
+    }
+    int bad = 0;
+    {
+      typedef exrandom::rand_digit<10U> digit_gen10;
+      digit_gen10 D10;
+      exrandom::u_rand<digit_gen> x(D), y(D);
+      exrandom::u_rand<digit_gen10> u(D10), v(D10);
+      long long half = 0;
+      for (int i = 0; i < 10000; ++i) {
+        x.init(); y.init(); u.init(); v.init();
+        if (i & 1) y.negate();
+        bool b1 = x.less_than(g, 3, y, 5), b2 = u.less_than(g, 7, v, 3);
+        bad += b1 != (3 * x.value<double>(g) < 5 * y.value<double>(g));
+        u.extend(g, 20); v.extend(g, 20);
+        bad += b2 != (7 * u.midpoint<double>() < 3 * v.midpoint<double>());
+        half += x.compare(g, 1, 1, 2) < 0;
+      }
+      bad += std::abs(half - 5000) > 200;
+    }
+    // chisq with 7 DOF is less than 24.32 with probability 0.999
+    if (!(chisq[0] < 24.32 && chisq[1] < 24.32 && chisq[2] < 24.32 &&
+          chisq[3] < 24.32 && bad == 0)) {
+      ++retval;
+      std::cerr << "Error in exrandom::normal_tail_dist, "
+                << "truncated_exponential_dist:\n"
+                << "  chisq = " << chisq[0] << " " << chisq[1] << " "
+                << chisq[2] << " " << chisq[3] << ", " << bad
+                << " mismatches\n";
+    }
+  }
+  {
+    // u_rand::compare with several digits per step (peeked or already
+    // generated) consumes the same digits as the digit-by-digit comparison
+    int bad = compare_differences<exrandom::rand_digit<2U> >(24u) +
+      compare_differences<exrandom::buffered_rand_digit<2U> >(24u) +
+      compare_differences<exrandom::buffered_rand_digit<16U> >(24u) +
+      compare_differences<exrandom::buffered_rand_digit<1U<<8> >(24u) +
+      compare_differences<exrandom::rand_digit<1U<<16> >(24u) +
+      compare_differences<exrandom::rand_digit<10U> >(24u);
+    if (bad) {
+      ++retval;
+      std::cerr << "Error in exrandom::u_rand::compare:\n"
+                << "  " << bad << " differences\n";
+    }
+  }
+  {
+    // u_rand::reduced_value to 24 bits matches value<float> (as a double)
+    // for all rounding modes and consumes the same digits; 8 bits consume
+    // fewer digits than 53.
+    const std::float_round_style rnds[] =
+      {std::round_to_nearest, std::round_toward_zero,
+       std::round_toward_infinity, std::round_toward_neg_infinity,
+       std::round_indeterminate};
+    std::mt19937 g1(25u), g2(25u);
+    exrandom::rand_digit<2U> D1, D2;
+    exrandom::unit_normal_dist<exrandom::rand_digit<2U> > N(D1);
+    exrandom::u_rand<exrandom::rand_digit<2U> > x(D1), y(D2);
+    int bad = 0;
+    for (int i = 0; i < 20000; ++i) {
+      N.generate(g1, x);
+      y = x; g2 = g1;
+      long long c1 = D1.count(), c2 = D2.count();
+      int f1, f2;
+      double v1 = x.reduced_value<double>(g1, 24, rnds[i % 5], f1),
+        v2 = y.value<float>(g2, rnds[i % 5], f2);
+      bad += v1 != v2 || f1 != f2 || D1.count() - c1 != D2.count() - c2;
+    }
+    long long c8 = 0, c53 = 0;
+    for (int i = 0; i < 10000; ++i) {
+      N.generate(g1, x); y = x; g2 = g1;
+      long long c1 = D1.count(), c2 = D2.count();
+      x.reduced_value<double>(g1, 8); c8 += D1.count() - c1;
+      y.value<double>(g2); c53 += D2.count() - c2;
+    }
+    exrandom::unit_uniform_distribution<double> U(12), V;
+    std::stringstream str; str << U; str >> V;
+    double u = U(g1);
+    if (bad || !(c8 < c53) || !(U == V && V.param().precision() == 12) ||
+        !(u == float(u) && std::ldexp(u, 12 - std::ilogb(u) - 1) ==
+          std::floor(std::ldexp(u, 12 - std::ilogb(u) - 1)))) {
+      ++retval;
+      std::cerr << "Error in exrandom::u_rand::reduced_value:\n"
+                << "  " << bad << " differences, " << c8 << " vs " << c53
+                << " digits, " << u << "\n";
+    }
+  }
+  {
+    // u_rand::value for half, bfloat16, and fixed_q<int16_t, 8> agrees with
+    // rounding the value truncated to a double, including subnormals (from
+    // leading zero digits), overflow, and saturation.
+    const std::float_round_style rnds[] =
+      {std::round_to_nearest, std::round_toward_zero,
+       std::round_indeterminate};
+    const unsigned ns[] = {0, 0, 0, 0, 1, 2, 127, 130, 65503, 65519, 70000};
+    zero_prefix_engine g1(26u), g2(26u);
+    exrandom::rand_digit<2U> D1, D2;
+    exrandom::u_rand<exrandom::rand_digit<2U> > x(D1), y(D2);
+    int bad = 0;
+    for (int i = 0; i < 30000; ++i) {
+      int mode = i % 3, kind = (i / 3) % 3, f, fy;
+      x.init(); x.set_integer(ns[i % 11]);
+      if (i % 2) x.negate();
+      g1.zeros(ns[i % 11] ? 0 : i % 29);
+      y = x; g2 = g1;
+      double d = y.value<double>(g2, std::round_toward_zero, fy),
+        a = std::fabs(d), r, lim;
+      int s = i % 2 ? -1 : 1;
+      if (kind == 0) {
+        r = spaced_round(a, a < std::ldexp(1.0, -14) ? -24 :
+                         std::ilogb(a) - 10, mode);
+        lim = 65504;
+      } else if (kind == 1) {
+        r = spaced_round(a, std::ilogb(a) - 7, mode);
+        lim = std::numeric_limits<double>::max();
+      } else {
+        r = spaced_round(a, -8, mode);
+        lim = s > 0 ? 32767/256.0 : 128;
+      }
+      int fr = r > a ? 1 : -1;
+      if (r > lim) {
+        r = kind == 0 && mode != 1 ? std::numeric_limits<double>::infinity() :
+          lim;
+        fr = r > a ? 1 : -1;
+      }
+      double v = kind == 0 ?
+        double(x.value<exrandom::half>(g1, rnds[mode], f)) :
+        kind == 1 ? double(x.value<exrandom::bfloat16>(g1, rnds[mode], f)) :
+        double(x.value<exrandom::fixed_q<std::int16_t, 8> >
+               (g1, rnds[mode], f));
+      bad += v != s * r || f != s * fr;
+    }
+#if defined(__FLT16_MANT_DIG__)
+    for (int i = 0; i < 1000; ++i) {
+      x.init(); g1.zeros(i % 29); y = x; g2 = g1;
+      bad += float(x.value<_Float16>(g1)) !=
+        float(y.value<exrandom::half>(g2));
+    }
+#endif
+    // Batch output from the wrappers
+    exrandom::unit_normal_distribution<exrandom::half> N;
+    exrandom::unit_uniform_distribution<exrandom::bfloat16> U;
+    std::vector<exrandom::half> hv(10000);
+    std::vector<exrandom::bfloat16> bv(10000);
+    N.generate(hv.begin(), hv.end(), g);
+    U.generate(&bv[0], bv.size(), g);
+    double hm = 0, bm = 0;
+    for (size_t k = 0; k < hv.size(); ++k) {
+      hm += float(hv[k]); bm += float(bv[k]);
+      bad += !(float(bv[k]) >= 0 && float(bv[k]) <= 1);
+    }
+    hm /= hv.size(); bm /= bv.size();
+    if (bad || !(std::fabs(hm) < 0.05 && std::fabs(bm - 0.5) < 0.02)) {
+      ++retval;
+      std::cerr << "Error in exrandom::u_rand::value (low precision):\n"
+                << "  " << bad << " differences, means " << hm << " "
+                << bm << "\n";
+    }
+  }
+  {
+    // prefetch_gen returns the results of the underlying engine in order
+    // (checked with unit_normal_dist and a small buffer) followed by its
+    // exception
+    std::mt19937 g1(27u), g2(27u);
+    finite_engine e(1001u);
+    int bad = 0;
+    {
+      exrandom::prefetch_gen<std::mt19937> p(g1, 64, 8);
+      exrandom::rand_digit<0U> D1, D2;
+      exrandom::unit_normal_dist<exrandom::rand_digit<0U> > N1(D1), N2(D2);
+      for (int i = 0; i < 20000; ++i)
+        bad += N1.value<double>(p) != N2.value<double>(g2);
+      bad += p.consumed() != (unsigned long long)(D1.count()) ||
+        D1.count() != D2.count() || p.produced() < p.consumed() ||
+        p.depth() != 64U;
+    }
+    {
+      exrandom::prefetch_gen<finite_engine> p(e, 16, 4);
+      for (unsigned k = 1; k <= 1001u; ++k)
+        bad += p() != k;
+      try {
+        p();
+        ++bad;
+      }
+      catch (const std::runtime_error&) {}
+    }
+    if (bad) {
+      ++retval;
+      std::cerr << "Error in exrandom::prefetch_gen:\n"
+                << "  " << bad << " differences\n";
+    }
+  }
+  {
+    // engine_bits and the digits with the range of the engine known at
+    // compile time and at run time
+    int bad = 0;
+#if EXRANDOM_CONSTEXPR
+    bad += exrandom::engine_bits<std::mt19937>::value != 32;
+    bad += exrandom::engine_bits<std::mt19937_64>::value != 64;
+    bad += exrandom::engine_bits<std::ranlux24_base>::value != 24;
+    bad += exrandom::engine_bits<std::minstd_rand>::value != 0;
+#endif
+    bad += exrandom::engine_bits<runtime_range_engine>::value != -1;
+    std::mt19937 g1(28u);
+    runtime_range_engine g2(28u);
+    exrandom::rand_digit<16U> D1, D2;
+    exrandom::buffered_rand_digit<8U> B1, B2;
+    exrandom::buffered_rand_digit<10U> C1, C2;
+    exrandom::uint_t p1[100], p2[100];
+    for (int i = 0; i < 1000; ++i) {
+      bad += D1(g1) != D2(g2);
+      bad += B1(g1) != B2(g2);
+      bad += C1(g1) != C2(g2);
+    }
+    D1.generate(g1, p1, 100); D2.generate(g2, p2, 100);
+    for (int i = 0; i < 100; ++i) bad += p1[i] != p2[i];
+    B1.generate(g1, p1, 100); B2.generate(g2, p2, 100);
+    for (int i = 0; i < 100; ++i) bad += p1[i] != p2[i];
+    bad += g1() != g2();
+    if (bad) {
+      ++retval;
+      std::cerr << "Error in exrandom::engine_bits:\n"
+                << "  " << bad << " differences\n";
+    }
+  }
+  {
+    // sample_stream: samples are reproduced from their checkpoints, blocks
+    // start independently, and the streamed state resumes a block
+    typedef exrandom::sample_stream<16U> stream_t;
+    typedef exrandom::unit_normal_dist<stream_t::digit_gen> normal_t;
+    stream_t s1(29u, 5u), s2(29u, 5u);
+    normal_t N1(s1.digit_generator()), N2(s2.digit_generator());
+    std::vector<stream_t::checkpoint> c(200);
+    std::vector<double> x(200);
+    int bad = 0;
+    double y[10];
+    s1.block(1u);
+    for (int i = 0; i < 10; ++i) y[i] = N1.value<double>(s1.engine());
+    s1.block(3u);
+    bad += s1.engine().stream() != 8u || s1.engine().tell() != 0U;
+    for (int i = 0; i < 200; ++i) {
+      c[i] = s1.mark();
+      x[i] = N1.value<double>(s1.engine());
+      // Blocks 1 and 3 are different
+      bad += i < 10 && x[i] == y[i];
+      bad += c[i].block != 3U || c[i].sample != unsigned(i) ||
+        c[i].position != (unsigned long long)(c[i].count);
+    }
+    // The last 10 samples in reverse order from their checkpoints
+    for (int i = 199; i >= 190; --i) {
+      s2.seek(c[i]);
+      bad += s2.mark() != c[i];
+      bad += N2.value<double>(s2.engine()) != x[i];
+    }
+    // Block 3 directly
+    s2.block(3u);
+    for (int i = 0; i < 200; ++i) {
+      bad += s2.mark() != c[i];
+      bad += N2.value<double>(s2.engine()) != x[i];
+    }
+    // Save the state in the middle of block 3 and resume
+    std::stringstream str;
+    s1.seek(c[100]);
+    str << s1;
+    stream_t s3(0u);
+    normal_t N3(s3.digit_generator());
+    str >> s3;
+    bad += !str || s3.key() != 29u || s3.stream0() != 5u;
+    for (int i = 100; i < 200; ++i) {
+      bad += s3.mark() != c[i];
+      bad += N3.value<double>(s3.engine()) != x[i];
+    }
+    std::stringstream str2;
+    stream_t::checkpoint c2;
+    str2 << c[150];
+    str2 >> c2;
+    bad += c2 != c[150];
+    if (bad) {
+      ++retval;
+      std::cerr << "Error in exrandom::sample_stream:\n"
+                << "  " << bad << " differences\n";
+    }
+  }
+  {
+    // perf_stats gives the same samples and digit counts as sample_stats
+    // (the hardware counters may not be available)
+    std::mt19937 g1(30u), g2(30u);
+    exrandom::rand_digit<0U> D1, D2;
+    exrandom::unit_normal_dist<exrandom::rand_digit<0U>, false,
+                               exrandom::sample_stats> N1(D1);
+    exrandom::unit_normal_dist<exrandom::rand_digit<0U>, false,
+                               exrandom::perf_stats> N2(D2);
+    int bad = 0;
+    for (int i = 0; i < 10000; ++i)
+      bad += N1.value<double>(g1) != N2.value<double>(g2);
+    const exrandom::perf_stats& s = N2.statistics();
+    for (int i = 0; i < exrandom::sample_stage::num; ++i) {
+      exrandom::sample_stage::type t = exrandom::sample_stage::type(i);
+      bad += N1.statistics().digits(t) != s.digits(t);
+      for (int k = 0; k < exrandom::perf_stats::num; ++k)
+        bad += s.count(exrandom::perf_stats::counter(k), t) < 0 ||
+          (!s.available() && s.count(exrandom::perf_stats::counter(k), t));
+    }
+    bad += s.samples() != 10000 || s.restarts() != N1.statistics().restarts();
+    if (bad) {
+      ++retval;
+      std::cerr << "Error in exrandom::perf_stats:\n"
+                << "  " << bad << " differences\n";
+    }
+  }
+  {
+    // bernoulli_rational and bernoulli_exp: the frequencies agree with the
+    // probabilities to within 5 standard deviations and generate matches
+    // the single trials
+    typedef exrandom::rand_digit<(1U << 20)> digit_gen;
+    std::mt19937 g1(31u), g2(31u);
+    digit_gen D1, D2;
+    exrandom::bernoulli_rational<digit_gen> R1(D1), R2(D2);
+    exrandom::bernoulli_exp<digit_gen> E1(D1), E2(D2);
+    exrandom::u_rand<digit_gen> x(D1);
+    const int n = 100000;
+    std::unique_ptr<bool[]> b(new bool[n]);
+    bool* p = b.get();
+    int bad = 0;
+    double q[6];
+    int k[6] = {0, 0, 0, 0, 0, 0};
+    R1.generate(g1, 3, 7, p, n);
+    for (int i = 0; i < n; ++i) {
+      k[0] += b[i] ? 1 : 0;
+      bad += R2(g2, 3, 7) != b[i];
+    }
+    q[0] = 3/7.0;
+    E1.generate(g1, 5, 2, p, n);
+    for (int i = 0; i < n; ++i) {
+      k[1] += b[i] ? 1 : 0;
+      bad += E2(g2, 5, 2) != b[i];
+    }
+    q[1] = std::exp(-2.5);
+    for (int i = 0; i < n; ++i) {
+      k[2] += E1(g1, 1, 3) ? 1 : 0;
+      k[3] += E1.half(g1) ? 1 : 0;
+      k[4] += E1.half_n(g1, 3) ? 1 : 0;
+      x.init();
+      k[5] += E1(g1, x) ? 1 : 0;  // x uniform, so Pr = 1 - exp(-1)
+    }
+    q[2] = std::exp(-1/3.0); q[3] = std::exp(-0.5); q[4] = std::exp(-1.5);
+    q[5] = 1 - std::exp(-1.0);
+    for (int j = 0; j < 6; ++j)
+      bad += std::abs(k[j] - n * q[j]) > 5 * std::sqrt(n * q[j] * (1 - q[j]));
+    long long c = 0;
+    for (int i = 0; i < n; ++i) c += E1.count_half(g1);
+    double m = std::exp(-0.5) / (1 - std::exp(-0.5)), // mean and variance
+      v = std::exp(-0.5) / ((1 - std::exp(-0.5)) * (1 - std::exp(-0.5)));
+    bad += std::abs(c - n * m) > 5 * std::sqrt(n * v);
+    bad += !E1(g1, 0) || R1(g1, 0, 5) || !R1(g1, 5, 5);
+    try { R1(g1, 6, 5); ++bad; } catch (const std::runtime_error&) {}
+    try { E1(g1, -1, 5); ++bad; } catch (const std::runtime_error&) {}
+    if (bad) {
+      ++retval;
+      std::cerr << "Error in exrandom::bernoulli_exp:\n"
+                << "  " << bad << " failures\n";
+    }
+  }
+  {
+    // geometric_dist and discrete_laplace_dist: the frequencies match the
+    // exact probabilities and the batch API gives the same results as single
+    // calls
+    typedef exrandom::rand_digit<16U> digit_gen;
+    digit_gen D;
+    std::mt19937 g1(32u), g2(32u);
+    exrandom::geometric_distribution G1(3, 2), G2(G1);
+    exrandom::discrete_laplace_distribution L1(1, 3, 5, 2), L2(L1);
+    const int n = 100000;
+    std::vector<int> v(n);
+    int bad = 0;
+    double chisq[2] = {0, 0};
+    G1.generate(&v[0], n, g1);
+    std::vector<long long> hist(12, 0);
+    for (int i = 0; i < n; ++i) {
+      bad += G2(g2) != v[i];
+      ++hist[v[i] < 11 ? v[i] : 11];
+    }
+    // P(k) = (1 - q) q^k, q = exp(-2/3)
+    for (int k = 0; k < 12; ++k) {
+      double p = k < 11 ? -std::expm1(-2/3.0) * std::exp(-k*2/3.0) :
+        std::exp(-11*2/3.0);
+      chisq[0] += (hist[k] - n*p) * (hist[k] - n*p) / (n*p);
+    }
+    L1.generate(v.begin(), v.end(), g1);
+    hist.assign(21, 0);
+    for (int i = 0; i < n; ++i) {
+      bad += L2(g2) != v[i];
+      ++hist[v[i] < -9 ? 0 : (v[i] > 10 ? 20 : v[i] + 10)];
+    }
+    // P(i) = exp(-|i - 1/3|*2/5) / norm, norm = (exp(-4/15) + exp(-2/15)) /
+    // (1 - exp(-2/5)); bins 0 and 20 are the tails i < -9 and i > 9
+    for (int k = 0; k <= 20; ++k) {
+      double norm = (std::exp(-4/15.0) + std::exp(-2/15.0)) /
+        -std::expm1(-0.4),
+        p = std::exp(-std::abs(k - 10 - 1/3.0) * 0.4) / norm;
+      if (k == 0 || k == 20) p /= -std::expm1(-0.4);
+      chisq[1] += (hist[k] - n*p) * (hist[k] - n*p) / (n*p);
+    }
+    // integer mu with the dist class: symmetric about mu
+    exrandom::discrete_laplace_dist<digit_gen> L3(D, -4, 1, 1, 3);
+    long long up = 0, down = 0, zero = 0;
+    for (int i = 0; i < n; ++i) {
+      int x = L3(g1);
+      if (x > -4) ++up; else if (x < -4) ++down; else ++zero;
+    }
+    // Pr(x = mu) = tanh(3/2)
+    bad += std::abs(zero - n * std::tanh(1.5)) >
+      5 * std::sqrt(n * std::tanh(1.5) * (1 - std::tanh(1.5)));
+    bad += std::abs(up - down) > 5 * std::sqrt(double(up + down));
+    std::stringstream str;
+    str << L1 << " " << G1;
+    exrandom::discrete_laplace_distribution L4;
+    exrandom::geometric_distribution G4;
+    str >> L4 >> G4;
+    bad += !(L4 == L1 && G4 == G1 && L4.mu_den() == 3 && G4.t_den() == 2);
+    try { exrandom::geometric_distribution G5(0, 1); ++bad; }
+    catch (const std::runtime_error&) {}
+    try { exrandom::geometric_distribution G5(1 << 30, 1); ++bad; }
+    catch (const std::runtime_error&) {}
+    try { exrandom::discrete_laplace_distribution L5(1, 0, 1, 1); ++bad; }
+    catch (const std::runtime_error&) {}
+    // chisq with 11 and 20 DOF is less than 31.26 and 45.31 with probability
+    // 0.999
+    if (bad || !(chisq[0] < 31.26 && chisq[1] < 45.31)) {
+      ++retval;
+      std::cerr << "Error in exrandom::discrete_laplace_dist:\n"
+                << "  " << bad << " differences, chisq = " << chisq[0]
+                << " " << chisq[1] << "\n";
+    }
+  }
+  {
+    // unit_exponential_lanes; base 4 exercises the exact fallback for ties
+    g.seed(18u);
+    double c1 = exponential_lanes_chisq<double, exrandom::rand_digit<0U>, 8>
+      (g, 1000000),
+      c2 = exponential_lanes_chisq<float, exrandom::rand_digit<0U>, 16>
+      (g, 1000000),
+      c3 = exponential_lanes_chisq<double, exrandom::rand_digit<4U>, 8>
+      (g, 200000);
+    // chisq with 20 DOF is less than 45.31 with probability 0.999
+    if (!(c1 < 45.31 && c2 < 45.31 && c3 < 45.31)) {
+      ++retval;
+      std::cerr << "Error in exrandom::unit_exponential_lanes:\n"
+                << "  chisq = " << c1 << " " << c2 << " " << c3 << "\n";
+    }
+  }
+  {
+    // discrete_normal_distribution with small sigma samples with a
+    // discrete_normal_table; bins are i in [-3, 3] and the rest
+    exrandom::discrete_normal_distribution D(1,3,16,10), D1(1,3,129,2);
+    const long long num = 1000000;
+    long long hist[8] = {0};
+    g.seed(15u);
+    for (long long i = 0; i < num; ++i) {
+      int k = D(g);
+      ++hist[k >= -3 && k <= 3 ? k + 3 : 7];
+    }
+    double p[8], s = 0, chisq = 0;
+    for (int k = -50; k <= 50; ++k)
+      s += std::exp(-std::pow((k - 1/3.0) / 1.6, 2) / 2);
+    p[7] = 1;
+    for (int k = -3; k <= 3; ++k) {
+      p[k + 3] = std::exp(-std::pow((k - 1/3.0) / 1.6, 2) / 2) / s;
+      p[7] -= p[k + 3];
+    }
+    for (int k = 0; k < 8; ++k)
+      chisq += (hist[k] - num*p[k]) * (hist[k] - num*p[k]) / (num*p[k]);
+    // chisq with 7 DOF is less than 24.32 with probability 0.999
+    if (!(chisq < 24.32 && D.table_bytes() > 0 && D1.table_bytes() == 0)) {
+      ++retval;
+      std::cerr << "Error in exrandom::discrete_normal_table:\n"
+                << "  chisq = " << chisq << ", table bytes "
+                << D.table_bytes() << " " << D1.table_bytes() << "\n";
+    }
+  }
+  {
+    // Sampling discrete_normal_distribution with a param_type with small
+    // sigma doesn't build (or allocate) a discrete_normal_table; it uses
+    // Algorithm D like the varying mu interface of discrete_normal_dist.
+    typedef exrandom::discrete_normal_distribution dist;
+    typedef exrandom::discrete_normal_dist<exrandom::rand_digit<1U<<16> > di;
+    dist D;
+    exrandom::rand_digit<1U<<16> DI;
+    di N(DI);
+    dist::param_type p(1, 7, 16, 1);
+    di::prepared_param q(p);
+    std::mt19937 g1(34u), g2(34u);
+    for (int i = 0; i < 10000; ++i) D(g1, p); // warm up the temporaries
+    for (int i = 0; i < 10000; ++i) N(g2, q, 1, 7);
+    int bad = 0;
+    const long long n0 = new_count;
+    for (int i = 0; i < 10000; ++i) bad += D(g1, p) != N(g2, q, 1, 7);
+    const long long n = new_count - n0;
+    if (bad || n || q.table_bytes() == 0) {
+      ++retval;
+      std::cerr << "Error in discrete_normal_distribution with param_type:\n"
+                << "  " << bad << " differences, " << n << " allocations\n";
+    }
+  }
+  {
+    // discrete_normal_table with small sigma and mu far from an integer: the
+    // weights are normalized to the largest so the acceptance is near 1.
+    // With mu = 1/2 and sigma = 1/20, 0 and 1 are equally likely (the other
+    // probabilities are less than exp(-400)); with mu = 1/3 and sigma =
+    // 1/256, the result is 0.
+    typedef exrandom::rand_digit<2U> digit_gen;
+    typedef exrandom::discrete_normal_dist<digit_gen> dist;
+    digit_gen D;
+    dist N1(D, dist::param_type(1, 2, 1, 20)),
+      N2(D, dist::param_type(1, 3, 1, 256));
+    std::mt19937 g1(33u);
+    const int n = 100000;
+    long long ones = 0, other = 0;
+    for (int i = 0; i < n; ++i) {
+      int k = N1(g1);
+      if (k == 1) ++ones; else if (k != 0) ++other;
+      other += N2(g1) != 0;
+    }
+    // Each sample needs a few digits for the alias table and the acceptance
+    if (!(N1.prepared().table_bytes() > 0 && N2.prepared().table_bytes() > 0 &&
+          other == 0 && std::abs(ones - n/2.0) < 5 * std::sqrt(n/4.0) &&
+          D.count() < 100LL * n)) {
+      ++retval;
+      std::cerr << "Error in exrandom::discrete_normal_table (small sigma):\n"
+                << "  ones = " << ones << ", other = " << other
+                << ", digits = " << D.count() << "\n";
+    }
+  }
+  {
+    // discrete_normal_ct uses a fixed number of digits per sample; bins are
+    // i in [-3, 3] and the rest.  generate gives the same results.
+    typedef exrandom::rand_digit<1U<<16> digit_gen;
+    typedef exrandom::discrete_normal_ct<digit_gen> ct;
+    digit_gen D;
+    ct C(D, 1, 3, 16, 10);
+    const long long num = 1000000;
+    long long hist[8] = {0};
+    g.seed(16u);
+    for (long long i = 0; i < num; ++i) {
+      int k = C(g);
+      ++hist[k >= -3 && k <= 3 ? k + 3 : 7];
+    }
+    bool fixed = D.count() == num * ct::digits;
+    double p[8], s = 0, chisq = 0;
+    for (int k = -50; k <= 50; ++k)
+      s += std::exp(-std::pow((k - 1/3.0) / 1.6, 2) / 2);
+    p[7] = 1;
+    for (int k = -3; k <= 3; ++k) {
+      p[k + 3] = std::exp(-std::pow((k - 1/3.0) / 1.6, 2) / 2) / s;
+      p[7] -= p[k + 3];
+    }
+    for (int k = 0; k < 8; ++k)
+      chisq += (hist[k] - num*p[k]) * (hist[k] - num*p[k]) / (num*p[k]);
+    int a[100], b[100];
+    g.seed(17u);
+    for (int i = 0; i < 100; ++i) a[i] = C(g);
+    g.seed(17u);
+    C.generate(g, b, 100);
+    bool same = true;
+    for (int i = 0; i < 100; ++i) same = same && a[i] == b[i];
+    // chisq with 7 DOF is less than 24.32 with probability 0.999
+    if (!(chisq < 24.32 && fixed && same)) {
+      ++retval;
+      std::cerr << "Error in exrandom::discrete_normal_ct:\n"
+                << "  chisq = " << chisq << ", digits = " << D.count()
+                << ", generate " << (same ? "agrees" : "differs") << "\n";
+    }
+  }
+  {
+    // normal_ziggurat_table should accept x in [0,1) with probability
+    // exp(-x*(2*k+x)/2); bins are x in [i/10, (i+1)/10) for accepted x and
+    // rejected.  Use base 2^8 so that the exact fallback is exercised.
+    typedef exrandom::rand_digit<1U<<8> digit_gen;
+    typedef exrandom::normal_ziggurat_table<1U<<8> table;
+    digit_gen D;
+    const long long num = 100000;
+    double chisq = 0;
+    g.seed(13u);
+    for (int k = 0; k < table::K; ++k) {
+      long long hist[11] = {0};
+      for (long long i = 0; i < num; ++i) {
+        exrandom::u_rand<digit_gen> x(D), y(D);
+        if (table::standard()(g, k, x, y))
+          ++hist[int(10 * x.value<double>(g))];
+        else
+          ++hist[10];
+      }
+      double p[11], s = 0, c = std::sqrt(std::atan(1.0) * 2) *
+        std::exp(k*k/2.0), r = 1/std::sqrt(2.0);
+      for (int i = 0; i < 10; ++i) {
+        p[i] = c * (std::erf(((i + 1)/10.0 + k) * r) -
+                    std::erf((i/10.0 + k) * r));
+        s += p[i];
+      }
+      p[10] = 1 - s;
+      for (int i = 0; i < 11; ++i)
+        chisq += (hist[i] - num*p[i]) * (hist[i] - num*p[i]) / (num*p[i]);
+    }
+    // chisq with 40 DOF is less than 73.40 with probability 0.999
+    if (!(chisq < 73.40)) {
+      ++retval;
+      std::cerr << "Error in exrandom::normal_ziggurat_table:\n"
+                << "  chisq = " << chisq << "\n";
+    }
+  }
+  {
+    // unit_normal_distribution with ziggurat_normal: |x| < 1 with
+    // probability erf(1/sqrt(2))
+    exrandom::unit_normal_distribution<double, exrandom::ziggurat_normal> n;
+    const long long num = 1000000;
+    long long m = 0;
+    double s = 0;
+    g.seed(14u);
+    for (long long i = 0; i < num; ++i) {
+      double x = n(g);
+      s += x; m += std::abs(x) < 1;
+    }
+    double p = std::erf(1/std::sqrt(2.0)),
+      z = (m - num * p) / std::sqrt(num * p * (1 - p));
+    // |z| and |s/sqrt(num)| are less than 3.29 with probability 0.999
+    if (!(std::abs(z) < 3.29 && std::abs(s / std::sqrt(double(num))) < 3.29)) {
+      ++retval;
+      std::cerr << "Error in exrandom::unit_normal_distribution"
+                << "<double, ziggurat_normal>:\n"
+                << "  z = " << z << ", sum = " << s << "\n";
+    }
+  }
+  {
+    g.seed(11u);
+    volatile double x = 0;
+    typedef exrandom::rand_digit<0> digit_gen;
+    digit_gen D;
+    exrandom::unit_normal_dist<digit_gen, true> N(D);
+    for (unsigned i = 0; i < 1000000; ++i)
+      x += N.value<double>(g);
+    if (std::abs(x - 260.56937818372) > 0.000000000005) {
+      ++retval;
+      std::cerr << "Error in tabulated exrandom::unit_normal_dist:\n"
+                << "  expected 260.56937818372, got " << x << "\n";
+    }
+  }
+  {
+    // Collecting statistics shouldn't change the results; the statistics
+    // should account for all the digits used, every sample, and every
+    // restart
+    typedef exrandom::rand_digit<0> digit_gen;
+    typedef exrandom::sample_stats stats;
+    typedef exrandom::rand_digit<1U<<16> discrete_gen;
+    digit_gen D, DS; discrete_gen DT;
+    exrandom::unit_normal_dist<digit_gen> N(D);
+    exrandom::unit_normal_dist<digit_gen, false, stats> NS(DS);
+    exrandom::discrete_normal_dist<discrete_gen, false, stats>
+      DN(DT, 1,3,129,2);
+    const long long num = 100000;
+    double x = 0, y = 0;
+    g.seed(13u);
+    for (long long i = 0; i < num; ++i) x += N.value<double>(g);
+    g.seed(13u);
+    for (long long i = 0; i < num; ++i) y += NS.value<double>(g);
+    for (long long i = 0; i < num; ++i) DN(g);
+    stats s = NS.statistics() + DN.statistics();
+    long long hist = 0, restarts = 0;
+    for (int k = 0; k < stats::nhist; ++k) hist += s.restart_histogram(k);
+    for (int k = 0; k <= stats::maxstep; ++k) restarts += s.rejects(k);
+    if (x != y || D.count() != DS.count() ||
+        NS.statistics().digits() != DS.count() ||
+        DN.statistics().digits() != DT.count() ||
+        s.samples() != 2 * num || hist != s.samples() ||
+        restarts != s.restarts() || s.rejects(3) == 0 ||
+        NS.statistics().rejects(3) != 0) {
+      ++retval;
+      std::cerr << "Error in exrandom::sample_stats:\n" << s;
+    }
+  }
+  {
+    // The rejected rounds of Algorithm E are the multiples of 1/2 in the
+    // results
+    typedef exrandom::rand_digit<0> digit_gen;
+    digit_gen D;
+    exrandom::unit_exponential_dist<digit_gen, true, exrandom::sample_stats>
+      E(D);
+    exrandom::u_rand<digit_gen> x(D);
+    const long long num = 100000;
+    long long halves = 0;
+    g.seed(14u);
+    for (long long i = 0; i < num; ++i) {
+      E.generate(g, x);
+      halves += 2 * x.integer() + (x.rawdigit(0) >> 31);
+    }
+    const exrandom::sample_stats& s = E.statistics();
+    if (s.samples() != num || s.rejects(1) != halves ||
+        s.restarts() != halves || s.digits() != D.count()) {
+      ++retval;
+      std::cerr << "Error in exrandom::unit_exponential_dist stats:\n" << s;
+    }
+  }
+  {
+    // exrandom::normal and exrandom::discrete_normal should give the same
+    // results as the distributions, and so should copies of distributions
+    const size_t num = 10000;
+    std::vector<double> a(num), b(num), c(num);
+    std::vector<int> i(num), j(num), k(num);
+    exrandom::unit_normal_distribution<double> N;
+    exrandom::discrete_normal_distribution D(1,3,129,2);
+    exrandom::discrete_normal_distribution::param_type p(1,3,129,2);
+    g.seed(14u);
+    for (size_t n = 0; n < num; ++n) a[n] = N(g);
+    for (size_t n = 0; n < num; ++n) i[n] = D(g);
+    g.seed(14u);
+    for (size_t n = 0; n < num; ++n) b[n] = exrandom::normal<double>(g);
+    for (size_t n = 0; n < num; ++n) j[n] = exrandom::discrete_normal(g, p);
+    exrandom::unit_normal_distribution<double> N1(N);
+    exrandom::discrete_normal_distribution D1(D), D2;
+    D2 = D1;
+    g.seed(14u);
+    for (size_t n = 0; n < num; ++n) c[n] = N1(g);
+    for (size_t n = 0; n < num; ++n) k[n] = D2(g);
+    if (a != b || a != c || i != j || i != k || D2 != D) {
+      ++retval;
+      std::cerr << "Error in exrandom::normal or copied distributions:\n"
+                << "  results differ from the distributions\n";
+    }
+  }
+  {
+    // exrandom::discrete_normal with a small sigma param_type doesn't build
+    // a discrete_normal_table (or allocate) for each call
+    exrandom::discrete_normal_distribution::param_type p(1,7,16,1);
+    g.seed(15u);
+    long long x = 0;
+    for (int n = 0; n < 10000; ++n) x += exrandom::discrete_normal(g, p);
+    const long long n0 = new_count;
+    for (int n = 0; n < 10000; ++n) x += exrandom::discrete_normal(g, p);
+    const long long n1 = new_count - n0;
+    if (n1) {
+      ++retval;
+      std::cerr << "Error in exrandom::discrete_normal with param_type:\n"
+                << "  " << n1 << " allocations (sum " << x << ")\n";
+    }
+  }
+  {
+    // philox_engine should match the Random123 known-answer tests, discard
+    // should skip results, and a sample should be reproducible from the
+    // position of the engine when it was generated
+    typedef exrandom::philox_engine engine;
+    engine e0(0ULL, 0ULL), e1(0xa4093822299f31d0ULL, 0x13198a2e03707344ULL);
+    e1.seek(0x243f6a8885a308d3ULL * 4);
+    bool kat = e0() == 0xca00a0459843d731ULL && e0() == 0x66c24222c9a845b5ULL
+      && e1() == 0x0a5e742c2997341cULL && e1() == 0xb0f883d38000de5dULL;
+    engine e2(15u), e3(15u);
+    for (int i = 0; i < 1001; ++i) e2();
+    e3.discard(1001);
+    bool disc = e2 == e3 && e2() == e3();
+    typedef exrandom::rand_digit<0> digit_gen;
+    digit_gen D;
+    exrandom::unit_normal_dist<digit_gen> N(D);
+    e3.jump();
+    unsigned long long pos = 0, p0 = e3.tell();
+    double x = 0, y = 0;
+    for (int i = 0; i < 1000; ++i) {
+      if (i == 500) pos = e3.tell();
+      double t = N.value<double>(e3);
+      if (i == 500) x = t;
+    }
+    bool counts = e3.tell() - p0 == (unsigned long long)(D.count());
+    engine e4(15u, 1u);
+    e4.seek(pos);
+    y = N.value<double>(e4);
+    if (!(kat && disc && counts && x == y)) {
+      ++retval;
+      std::cerr << "Error in exrandom::philox_engine:\n"
+                << "  " << kat << disc << counts << " replay "
+                << x << " " << y << "\n";
+    }
+  }
+  {
+    // u_rands written with u_rand_writer should be read back unchanged by
+    // u_rand_reader and then be extended in the same way as the originals;
+    // a truncated stream should be detected
+    typedef exrandom::rand_digit<2> digit_gen;
+    typedef exrandom::u_rand<digit_gen> u_rand;
+    digit_gen D;
+    exrandom::unit_normal_dist<digit_gen> N(D);
+    std::vector<u_rand> a;
+    g.seed(16u);
+    for (int i = 0; i < 1000; ++i) {
+      a.push_back(u_rand(D)); N.generate(g, a.back());
+    }
+    std::ostringstream os;
+    {
+      exrandom::u_rand_writer<digit_gen> w(os, 64);
+      for (size_t i = 0; i < a.size(); ++i) w.write(a[i]);
+    }
+    std::string data = os.str();
+    std::istringstream is(data);
+    exrandom::u_rand_reader<digit_gen> r(is, 16);
+    u_rand x(D);
+    std::mt19937 h(17u), k(17u);
+    int bad = 0; size_t n = 0;
+    for (; r.read(x); ++n)
+      bad += n >= a.size() || x.print() != a[n].print() ||
+        x.value<double>(h) != a[n].value<double>(k) ? 1 : 0;
+    bool truncated = false;
+    try {
+      std::istringstream ist(data.substr(0, data.size() - 1));
+      exrandom::u_rand_reader<digit_gen> rt(ist);
+      while (rt.read(x)) {}
+    } catch (const std::runtime_error&) {
+      truncated = true;
+    }
+    if (bad || n != a.size() || !truncated) {
+      ++retval;
+      std::cerr << "Error in exrandom::u_rand_writer/u_rand_reader:\n"
+                << "  " << bad << " differences, " << n << " read\n";
+    }
+  }
+  {
+    // mapped_file_gen should return the bits of a file in order, remember
+    // its position in a state file, and apply the end-of-file policy
+    typedef exrandom::mapped_file_gen engine;
+    const char* file = "exrandom_test.bits", * state = "exrandom_test.pos";
+    std::mt19937_64 h64(18u);
+    std::vector<unsigned long long> w(1000);
+    {
+      std::ofstream f(file, std::ios::binary);
+      for (size_t i = 0; i < w.size(); ++i) {
+        w[i] = h64();
+        for (int k = 8; k--;) f.put(char((w[i] >> (8 * k)) & 0xffU));
+      }
+    }
+    std::remove(state);
+    int bad = 0;
+    {
+      engine e(file, engine::wrap, state);
+      exrandom::buffered_rand_digit<2> D;
+      for (size_t i = 0; i < 100; ++i)
+        for (int k = 64; k--;)
+          bad += D(e) != ((w[i] >> k) & 1U) ? 1 : 0;
+    }
+    bool exhausted;
+    {
+      engine e(file, engine::wrap, state);
+      bad += e() != w[100] ? 1 : 0;
+      e.discard(w.size());
+      exhausted = e() == w[101] && e.exhausted();
+    }
+    std::remove(file); std::remove(state);
+    if (bad || !exhausted) {
+      ++retval;
+      std::cerr << "Error in exrandom::mapped_file_gen:\n"
+                << "  " << bad << " bits differ\n";
+    }
+  }
+  {
+    // A sampler driven past the end of a short capture (131 bytes, so the
+    // last 3 bytes are ignored) with mapped_file_gen should throw with fail
+    // and keep going (setting exhausted()) with wrap
+    typedef exrandom::mapped_file_gen engine;
+    typedef exrandom::buffered_rand_digit<2> digit_gen;
+    const char* file = "exrandom_test.bits";
+    {
+      std::mt19937 h(19u);
+      std::ofstream f(file, std::ios::binary);
+      for (int i = 0; i < 131; ++i) f.put(char(h() & 0xffU));
+    }
+    const int num = 1000;
+    int nfail = -1, nwrap = 0;
+    bool ok = true;
+    {
+      engine e(file, engine::fail);
+      ok = ok && e.size() == 16U;
+      digit_gen D;
+      exrandom::unit_exponential_dist<digit_gen> E(D);
+      try {
+        for (int i = 0; i < num; ++i) E.value<double>(e);
+      }
+      catch (const std::runtime_error&) {
+        nfail = int(e.tell());
+      }
+    }
+    {
+      engine e(file, engine::wrap);
+      digit_gen D;
+      exrandom::unit_exponential_dist<digit_gen> E(D);
+      for (; nwrap < num; ++nwrap) E.value<double>(e);
+      ok = ok && e.exhausted();
+    }
+    std::remove(file);
+    if (!(ok && nfail == 16 && nwrap == num)) {
+      ++retval;
+      std::cerr << "Error in exrandom::mapped_file_gen at end of file:\n"
+                << "  fail at " << nfail << ", " << nwrap << " samples\n";
+    }
+  }
+  {
+    // u_rand::extend should give the same digits as digit(g, k) one at a
+    // time for rand_digit and buffered_rand_digit
+    int bad = 0;
+    {
+      typedef exrandom::rand_digit<10> digit_gen;
+      digit_gen D, E;
+      exrandom::u_rand<digit_gen> x(D), y(E);
+      std::mt19937 g(19u), h(19u);
+      x.extend(g, 50); y.digit(h, 49);
+      for (size_t k = 0; k < 50; ++k) bad += x.digit(g, k) != y.digit(h, k);
+      bad += D.count() != E.count() || x.ndigits() != 50 || g != h;
+    }
+    for (int b = 0; b < 3; ++b) {
+      typedef exrandom::buffered_rand_digit<8> digit_gen;
+      digit_gen D, E;
+      exrandom::u_rand<digit_gen> x(D), y(E);
+      std::mt19937_64 g(20u + b), h(20u + b);
+      y.digit(h, 2);
+      x.extend(g, 3); x.extend(g, 200 + 7 * b);
+      for (size_t k = 0; k < x.ndigits(); ++k)
+        bad += x.digit(g, k) != y.digit(h, k);
+      bad += D.count() != E.count() || D(g) != E(h);
+    }
+    if (bad) {
+      ++retval;
+      std::cerr << "Error in exrandom::u_rand::extend:\n"
+                << "  " << bad << " differences\n";
+    }
+  }
+  {
+    // unit_normal_distribution with the kahn_normal policy should give the
+    // same results as unit_normal_kahn with base 2; the default policy
+    // should be von_neumann_normal
+    exrandom::unit_normal_distribution<double, exrandom::kahn_normal> K;
+    exrandom::unit_normal_distribution<double,
+                                       exrandom::von_neumann_normal> V;
+    exrandom::unit_normal_distribution<double> N;
+    exrandom::rand_digit<2> D;
+    exrandom::unit_normal_kahn<exrandom::rand_digit<2> > Kd(D);
+    std::mt19937 g1(22u), g2(22u), g3(23u), g4(23u);
+    int bad = 0;
+    for (int i = 0; i < 1000; ++i) {
+      bad += K(g1) != Kd.value<double>(g2);
+      bad += V(g3) != N(g4);
+    }
+    if (bad) {
+      ++retval;
+      std::cerr << "Error in exrandom::unit_normal_distribution policies:\n"
+                << "  " << bad << " differences\n";
+    }
+  }
   if (retval > 0)
     std::cerr << "Some tests failed" << "\n";
   else
@@ -0,0 +1,46 @@
+#include <iostream>
+#include <random>
+#include <thread>
+#include <vector>
+#include <exrandom/exrandom_config.hpp>
+#if EXRANDOM_THREAD_LOCAL
+#include <exrandom/samplers.hpp>
+#endif
+
+int main() {
+#if EXRANDOM_THREAD_LOCAL
+  unsigned s = std::random_device()(); // Set seed from random_device
+  std::cout << "Seed set to " << s << "\n\n";
+
+  const int nthreads = 4;
+  const long long num = 1000000LL;
+  std::vector<double> sum(nthreads), sum2(nthreads);
+  std::vector<std::thread> threads;
+  // Each thread has its own engine; exrandom::normal supplies the
+  // distribution for the thread.
+  for (int t = 0; t < nthreads; ++t)
+    threads.push_back(std::thread([&sum, &sum2, s, t, num]() {
+          std::seed_seq seq{s, unsigned(t)};
+          std::mt19937_64 g(seq);
+          double x = 0, x2 = 0;
+          for (long long i = 0; i < num; ++i) {
+            double y = exrandom::normal<double>(g);
+            x += y; x2 += y * y;
+          }
+          sum[t] = x; sum2[t] = x2;
+        }));
+  for (int t = 0; t < nthreads; ++t)
+    threads[t].join();
+  double x = 0, x2 = 0;
+  for (int t = 0; t < nthreads; ++t) {
+    x += sum[t]; x2 += sum2[t];
+  }
+  long long n = nthreads * num;
+  std::cout << "Sampled " << n << " normal deviates in " << nthreads
+            << " threads:\n"
+            << "mean = " << x/n << ", variance = " << x2/n - (x/n)*(x/n)
+            << "\n";
+#else
+  std::cout << "This compiler does not support thread_local\n";
+#endif
+}
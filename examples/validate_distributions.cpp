@@ -0,0 +1,348 @@
+// Statistical validation of the distributions using several threads.
+//
+// Each distribution is sampled with several bases.  For the continuous
+// distributions, the samples x are transformed to F(x), where F is the
+// cumulative distribution, and F(x) is histogrammed in 4096 equal bins;
+// these are merged into 64 bins for the chi-squared test and the
+// Kolmogorov-Smirnov statistic is evaluated at the 4097 bin edges (which
+// makes the KS p-value conservative).  The digit test is a chi-squared
+// test that the low 8 bits of the significand of x are uniformly
+// distributed (these are only filled correctly if the result is rounded
+// correctly).  For the discrete normal distribution, the chi-squared test
+// uses the exact probabilities (with bins merged so that the expected
+// count is at least 20) and the KS statistic is evaluated at the integers.
+//
+// Each thread has its own digit generator and distribution and a
+// philox_engine with its own stream; it accumulates flat histograms which
+// are merged when all the threads are done.  A test fails if any of its
+// p-values is less than 10^-6 and the program then returns 1.
+//
+// Usage: validate_distributions [--samples N] [--threads T] [--seed S]
+//
+// N (default 10^7) is the number of samples for each distribution and
+// base; T (default the number of hardware threads) is the number of
+// threads.  The results depend on S and T.
+
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <random>
+#include <limits>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstdint>
+#include <exrandom/rand_digit.hpp>
+#include <exrandom/philox_engine.hpp>
+#include <exrandom/unit_uniform_dist.hpp>
+#include <exrandom/unit_exponential_dist.hpp>
+#include <exrandom/unit_normal_dist.hpp>
+#include <exrandom/discrete_normal_dist.hpp>
+#include <exrandom/normal_tail_dist.hpp>
+#include <exrandom/truncated_exponential_dist.hpp>
+
+typedef exrandom::philox_engine engine;
+
+long long samples = 10000000LL;
+int nthreads = 0;
+unsigned long long seed = 0;
+int failures = 0, ntests = 0;
+const double pmin = 1e-6;
+const int nfine = 4096, nchisq = 64, ndigit = 256;
+
+// The regularized upper incomplete gamma function Q(a, x), Numerical
+// Recipes, Sec. 6.2
+double gammaq(double a, double x) {
+  if (x <= 0) return 1;
+  double lg = std::lgamma(a);
+  if (x < a + 1) {
+    double ap = a, sum = 1/a, del = sum;
+    for (int n = 0; n < 10000 && std::fabs(del) > std::fabs(sum) * 1e-15;
+         ++n) {
+      ap += 1; del *= x/ap; sum += del;
+    }
+    return 1 - sum * std::exp(-x + a * std::log(x) - lg);
+  }
+  double tiny = 1e-300, b = x + 1 - a, c = 1/tiny, d = 1/b, h = d;
+  for (int i = 1; i < 10000; ++i) {
+    double an = -i * (i - a);
+    b += 2;
+    d = an * d + b; if (std::fabs(d) < tiny) d = tiny;
+    c = b + an / c; if (std::fabs(c) < tiny) c = tiny;
+    d = 1/d;
+    double del = d * c;
+    h *= del;
+    if (std::fabs(del - 1) < 1e-15) break;
+  }
+  return std::exp(-x + a * std::log(x) - lg) * h;
+}
+
+// The p-value for chi-squared with dof degrees of freedom
+double chisq_p(double chisq, int dof) { return gammaq(dof / 2.0, chisq / 2); }
+
+// The p-value for the KS statistic D with n samples, Numerical Recipes,
+// Sec. 14.3
+double ks_p(double D, long long n) {
+  double sn = std::sqrt(double(n)), l = (sn + 0.12 + 0.11/sn) * D;
+  if (l < 0.2) return 1;
+  double s = 0, sign = 1;
+  for (int k = 1; k <= 100; ++k) {
+    double t = std::exp(-2 * k * k * l * l);
+    s += sign * t; sign = -sign;
+    if (t < 1e-16) break;
+  }
+  return (std::min)(1.0, (std::max)(0.0, 2 * s));
+}
+
+long long share(int t) {
+  return samples / nthreads + (t < samples % nthreads ? 1 : 0);
+}
+
+// Run f(t, stream) in nthreads threads
+template<typename F>
+double run(F f, unsigned long long stream) {
+  std::vector<std::thread> threads;
+  auto t0 = std::chrono::steady_clock::now();
+  for (int t = 0; t < nthreads; ++t)
+    threads.push_back(std::thread(f, t, stream * 1024U + unsigned(t)));
+  for (int t = 0; t < nthreads; ++t)
+    threads[t].join();
+  auto t1 = std::chrono::steady_clock::now();
+  return double(std::chrono::duration_cast<std::chrono::milliseconds>
+                (t1 - t0).count()) / 1000;
+}
+
+void report(const std::string& name, double secs,
+            double pchi, double pks, double pdig) {
+  ++ntests;
+  bool fail = pchi < pmin || pks < pmin || (pdig >= 0 && pdig < pmin);
+  if (fail) ++failures;
+  std::ostringstream dig;
+  if (pdig >= 0) dig << std::setprecision(3) << pdig; else dig << "n/a";
+  std::cout << std::left << std::setw(48) << name << std::right
+            << std::setprecision(3) << std::setw(10) << pchi
+            << std::setw(10) << pks << std::setw(10) << dig.str()
+            << std::fixed << std::setprecision(1) << std::setw(8)
+            << samples / secs / 1e6 << (fail ? "  FAIL" : "") << std::endl;
+  std::cout.unsetf(std::ios::floatfield);
+}
+
+// Adapters for the continuous distributions: construct from a digit
+// generator, return a sample, and give the cumulative distribution.
+template<typename digit_gen> struct uniform_s {
+  exrandom::unit_uniform_dist<digit_gen> d;
+  explicit uniform_s(digit_gen& D) : d(D) {}
+  double operator()(engine& g) { return d.template value<double>(g); }
+  static double cdf(double x) { return x; }
+  static std::string name() { return "unit_uniform_dist"; }
+};
+
+template<typename digit_gen> struct exponential_s {
+  exrandom::unit_exponential_dist<digit_gen> d;
+  explicit exponential_s(digit_gen& D) : d(D) {}
+  double operator()(engine& g) { return d.template value<double>(g); }
+  static double cdf(double x) { return -std::expm1(-x); }
+  static std::string name() { return "unit_exponential_dist"; }
+};
+
+template<typename digit_gen> struct normal_s {
+  exrandom::unit_normal_dist<digit_gen> d;
+  explicit normal_s(digit_gen& D) : d(D) {}
+  double operator()(engine& g) { return d.template value<double>(g); }
+  static double cdf(double x) { return std::erfc(-x / std::sqrt(2.0)) / 2; }
+  static std::string name() { return "unit_normal_dist"; }
+};
+
+// |x| for the normal conditioned on |x| > 3
+template<typename digit_gen> struct normal_tail_s {
+  exrandom::normal_tail_dist<digit_gen> d;
+  explicit normal_tail_s(digit_gen& D) : d(D, 3, 1) {}
+  double operator()(engine& g)
+  { return std::fabs(d.template value<double>(g)); }
+  static double cdf(double x) {
+    return 1 - std::erfc(x / std::sqrt(2.0)) / std::erfc(3 / std::sqrt(2.0));
+  }
+  static std::string name() { return "normal_tail_dist(t = 3)"; }
+};
+
+// The exponential in [1/2, 5/4)
+template<typename digit_gen> struct truncated_exponential_s {
+  exrandom::truncated_exponential_dist<digit_gen> d;
+  explicit truncated_exponential_s(digit_gen& D) : d(D, 1, 2, 5, 4) {}
+  double operator()(engine& g) { return d.template value<double>(g); }
+  static double cdf(double x)
+  { return std::expm1(0.5 - x) / std::expm1(-0.75); }
+  static std::string name()
+  { return "truncated_exponential_dist[1/2,5/4)"; }
+};
+
+template<typename digit_gen> std::string base_name() {
+  std::ostringstream s;
+  if (digit_gen::power_of_two && digit_gen::bits > 1)
+    s << "2^" << digit_gen::bits;
+  else
+    s << digit_gen::base;
+  return s.str();
+}
+
+template<template<typename> class S, typename digit_gen>
+void continuous_test(unsigned long long stream) {
+  // Per-thread flat histograms: nfine bins of F(x) then ndigit bins of
+  // the low bits of the significand
+  std::vector<std::vector<long long> >
+    hist(nthreads, std::vector<long long>(nfine + ndigit, 0));
+  double secs = run([&hist](int t, unsigned long long s) {
+      engine g(seed, s);
+      digit_gen D;
+      S<digit_gen> d(D);
+      long long* h = &hist[t][0];
+      for (long long i = share(t); i; --i) {
+        double x = d(g);
+        ++h[(std::min)(nfine - 1, int(S<digit_gen>::cdf(x) * nfine))];
+        int e;
+        double m = std::frexp(x, &e);
+        ++h[nfine +
+            int(std::uint64_t(std::ldexp(std::fabs(m), 53)) % ndigit)];
+      }
+    }, stream);
+  std::vector<long long> h(nfine + ndigit, 0);
+  for (int t = 0; t < nthreads; ++t)
+    for (int k = 0; k < nfine + ndigit; ++k) h[k] += hist[t][k];
+  double n = double(samples), chisq = 0, dchisq = 0, D = 0;
+  long long c = 0;
+  for (int k = 0; k < nchisq; ++k) {
+    long long m = 0;
+    for (int j = 0; j < nfine / nchisq; ++j) m += h[k * (nfine / nchisq) + j];
+    double e = n / nchisq;
+    chisq += (m - e) * (m - e) / e;
+  }
+  for (int k = 0; k < nfine; ++k) {
+    c += h[k];
+    D = (std::max)(D, std::fabs(c / n - (k + 1) / double(nfine)));
+  }
+  for (int k = 0; k < ndigit; ++k) {
+    double e = n / ndigit;
+    dchisq += (h[nfine + k] - e) * (h[nfine + k] - e) / e;
+  }
+  report(S<digit_gen>::name() + ", base " + base_name<digit_gen>(), secs,
+         chisq_p(chisq, nchisq - 1), ks_p(D, samples),
+         chisq_p(dchisq, ndigit - 1));
+}
+
+template<typename digit_gen>
+void discrete_test(unsigned long long stream,
+                   int mu_num, int mu_den, int sigma_num, int sigma_den) {
+  double mu = mu_num / double(mu_den), sigma = sigma_num / double(sigma_den);
+  // Histogram the integers in [lo, lo + nb) and the rest
+  int lo = int(std::floor(mu - 8 * sigma)), nb = int(16 * sigma) + 2;
+  std::vector<std::vector<long long> >
+    hist(nthreads, std::vector<long long>(nb + 1, 0));
+  double secs = run([&hist, lo, nb, mu_num, mu_den, sigma_num, sigma_den]
+                    (int t, unsigned long long s) {
+      engine g(seed, s);
+      digit_gen D;
+      exrandom::discrete_normal_dist<digit_gen>
+        d(D, mu_num, mu_den, sigma_num, sigma_den);
+      long long* h = &hist[t][0];
+      for (long long i = share(t); i; --i) {
+        int k = d(g) - lo;
+        ++h[k >= 0 && k < nb ? k : nb];
+      }
+    }, stream);
+  std::vector<long long> h(nb + 1, 0);
+  for (int t = 0; t < nthreads; ++t)
+    for (int k = 0; k <= nb; ++k) h[k] += hist[t][k];
+  // The exact probabilities normalized by summing over mu +/- 40 sigma
+  std::vector<double> p(nb);
+  double norm = 0, pin = 0;
+  for (int k = int(std::floor(mu - 40 * sigma));
+       k <= int(std::ceil(mu + 40 * sigma)); ++k)
+    norm += std::exp(-std::pow((k - mu) / sigma, 2) / 2);
+  for (int k = 0; k < nb; ++k) {
+    p[k] = std::exp(-std::pow((lo + k - mu) / sigma, 2) / 2) / norm;
+    pin += p[k];
+  }
+  double n = double(samples), chisq = 0, D = 0, cp = (1 - pin) / 2;
+  long long c = h[nb] / 2;      // half of the rest lie below lo
+  // Merge bins so that each has an expected count of at least 20 (the
+  // leftover bins are merged into the last one)
+  std::vector<double> e(1, n * (1 - pin));
+  std::vector<long long> m(1, h[nb]);
+  for (int k = 0; k < nb; ++k) {
+    if (e.back() >= 20) { e.push_back(0); m.push_back(0); }
+    e.back() += n * p[k]; m.back() += h[k];
+  }
+  if (e.size() > 1 && e.back() < 20) {
+    e[e.size() - 2] += e.back(); m[m.size() - 2] += m.back();
+    e.pop_back(); m.pop_back();
+  }
+  for (size_t k = 0; k < e.size(); ++k)
+    chisq += (m[k] - e[k]) * (m[k] - e[k]) / e[k];
+  int dof = int(e.size()) - 1;
+  for (int k = 0; k < nb; ++k) {
+    c += h[k]; cp += p[k];
+    D = (std::max)(D, std::fabs(c / n - cp));
+  }
+  std::ostringstream name;
+  name << "discrete_normal_dist(" << mu_num << "/" << mu_den << ","
+       << sigma_num << "/" << sigma_den << "), base "
+       << base_name<digit_gen>();
+  report(name.str(), secs, chisq_p(chisq, dof), ks_p(D, samples), -1);
+}
+
+template<typename digit_gen>
+void continuous_tests(unsigned long long& stream) {
+  continuous_test<uniform_s, digit_gen>(++stream);
+  continuous_test<exponential_s, digit_gen>(++stream);
+  continuous_test<normal_s, digit_gen>(++stream);
+  continuous_test<normal_tail_s, digit_gen>(++stream);
+  continuous_test<truncated_exponential_s, digit_gen>(++stream);
+}
+
+template<typename digit_gen>
+void discrete_tests(unsigned long long& stream) {
+  discrete_test<digit_gen>(++stream, 1, 3, 6, 1);
+  discrete_test<digit_gen>(++stream, -5, 7, 1301, 2);
+}
+
+int main(int argc, char* argv[]) {
+  seed = std::random_device()();
+  nthreads = int(std::thread::hardware_concurrency());
+  for (int i = 1; i < argc; ++i) {
+    std::string a(argv[i]);
+    if (a == "--samples" && i + 1 < argc)
+      samples = (std::max)(1000LL, std::atoll(argv[++i]));
+    else if (a == "--threads" && i + 1 < argc)
+      nthreads = std::atoi(argv[++i]);
+    else if (a == "--seed" && i + 1 < argc)
+      seed = std::strtoull(argv[++i], 0, 10);
+    else {
+      std::cerr << "Usage: " << argv[0]
+                << " [--samples N] [--threads T] [--seed S]\n";
+      return 1;
+    }
+  }
+  nthreads = (std::max)(1, nthreads);
+  std::cout << "Seed set to " << seed << ", " << nthreads << " threads, "
+            << samples << " samples per test\n"
+            << "A test fails if a p-value is less than " << pmin << "\n"
+            << std::left << std::setw(48) << "distribution, base"
+            << std::right << std::setw(10) << "chisq p" << std::setw(10)
+            << "KS p" << std::setw(10) << "digit p" << std::setw(8)
+            << "Ms/s" << std::endl;
+  unsigned long long stream = 0;
+  continuous_tests<exrandom::rand_digit<2U> >(stream);
+  continuous_tests<exrandom::rand_digit<1U<<16> >(stream);
+  continuous_tests<exrandom::rand_digit<0U> >(stream);
+  discrete_tests<exrandom::rand_digit<2U> >(stream);
+  discrete_tests<exrandom::rand_digit<10U> >(stream);
+  discrete_tests<exrandom::rand_digit<1U<<16> >(stream);
+  discrete_tests<exrandom::rand_digit<1U<<24> >(stream);
+  std::cout << failures << " failures in " << ntests << " tests"
+            << std::endl;
+  return failures ? 1 : 0;
+}
@@ -0,0 +1,416 @@
+/**
+ * @file bernoulli.hpp
+ * @author Charles Karney <charles.karney@sri.com>
+ * @brief Definition of bernoulli_rational and bernoulli_exp
+ *
+ * Copyright (c) Charles Karney (2016) and licensed under the MIT/X11 License.
+ * For more information, see http://exrandom.sourceforge.net/
+ */
+
+#if !defined(EXRANDOM_BERNOULLI_HPP)
+#define EXRANDOM_BERNOULLI_HPP 1
+
+#include <algorithm>            // for std::min, std::max
+#include <cstddef>              // for size_t
+#include <stdexcept>            // for std::runtime_error
+
+#include <exrandom/u_rand.hpp>
+#include <exrandom/u_rand_workspace.hpp>
+
+namespace exrandom {
+
+  /**
+   * @brief Exact Bernoulli trials with rational probabilities.
+   *
+   * @tparam digit_gen the type of digit generator.
+   *
+   * A trial with probability @e num/@e den compares a uniform deviate U,
+   * whose digits are drawn one at a time, with @e num/@e den; it returns as
+   * soon as the comparison is decided, so the expected number of digits is
+   * at most base/(base &minus; 1).  For a base which is a power of two
+   * greater than 2<sup>15</sup>, only the top 15 bits of each digit are
+   * used (to avoid overflow).  The static member functions, which take the
+   * digit generator as an argument, are the building blocks used by
+   * unit_normal_dist (Algorithm C).
+   */
+  template<typename digit_gen> class bernoulli_rational {
+  public:
+    /**
+     * The constructor.
+     *
+     * @param D a reference to the digit generator to be used.
+     */
+    explicit bernoulli_rational(digit_gen& D) : _D(D) {}
+    /**
+     * Perform a Bernoulli trial.
+     *
+     * @tparam Generator the type of g.
+     * @param g the random generator engine.
+     * @param num the numerator of the probability.
+     * @param den the denominator of the probability.
+     * @exception std::runtime_error if not 0 &le; @e num &le; @e den and
+     *   @e den &gt; 0.
+     * @return true with probability @e num/@e den.
+     */
+    template<typename Generator>
+    bool operator()(Generator& g, int num, int den) {
+      check(num, den);
+      return trial(g, _D, num, den);
+    }
+    /**
+     * Perform several Bernoulli trials with the same probability.
+     *
+     * @tparam Generator the type of g.
+     * @param g the random generator engine.
+     * @param num the numerator of the probability.
+     * @param den the denominator of the probability.
+     * @param[out] p where to put the results.
+     * @param n the number of trials.
+     * @exception std::runtime_error if not 0 &le; @e num &le; @e den and
+     *   @e den &gt; 0.
+     *
+     * The results are the same as @e n calls to operator()().
+     */
+    template<typename Generator>
+    void generate(Generator& g, int num, int den, bool* p, size_t n) {
+      check(num, den);
+      for (bool* e = p + n; p != e; ++p) *p = trial(g, _D, num, den);
+    }
+    /**
+     * @return a reference to the digit generator used in the constructor.
+     */
+    digit_gen& digit_generator() const { return _D; }
+
+    /**
+     * A Bernoulli trial with a specified digit generator.
+     *
+     * @tparam Generator the type of g.
+     * @param g the random generator engine.
+     * @param D the digit generator.
+     * @param num the numerator of the probability.
+     * @param den the denominator of the probability.
+     * @return true with probability @e num/@e den.
+     *
+     * This requires 0 &le; @e num &le; @e den and @e den &gt; 0 (which is
+     * not checked).
+     */
+    template<typename Generator>
+    static bool trial(Generator& g, digit_gen& D, int num, int den) {
+      return num >= den ? true : num <= 0 ? false :
+        compare(g, D, num, num, den) < 0;
+    }
+    /**
+     * Compare a new uniform deviate with two fractions.
+     *
+     * @tparam Generator the type of g.
+     * @param g the random generator engine.
+     * @param D the digit generator.
+     * @param u1 the numerator of the first fraction.
+     * @param u2 the numerator of the second fraction.
+     * @param v the denominator of the fractions.
+     * @return &minus;1 if U &lt; @e u1/@e v, +1 if U &gt; @e u2/@e v, and
+     *   0 otherwise, where U is a uniform deviate in (0,1).
+     *
+     * This requires 0 &le; @e u1 &le; @e u2 &le; @e v and @e v &gt; 0.  At
+     * least one digit is used.  With @e u1 = 1, @e u2 = 2, and @e v = @e m,
+     * this is Algorithm C (step 4 of Algorithm N) which returns (&minus;1,
+     * 0, 1) with probabilities (1/@e m, 1/@e m, 1 &minus; 2/@e m).
+     */
+    template<typename Generator>
+    EXRANDOM_PROFILE_STEP
+    static int compare(Generator& g, digit_gen& D,
+                       long long u1, long long u2, int v) {
+      // Limit temporary base to 2^maxbits to avoid integer overflow
+      const int maxbits = 15;
+      const int shift = (power_of_two && bits > maxbits) ? bits - maxbits : 0;
+      const long long tbase = (power_of_two && bits > maxbits) ?
+        (1LL << maxbits) : (long long)(base);
+      for (;;) {
+        long long d = (long long)(D(g) >> shift);
+        if ((u1 = (std::max)(0LL, u1 * tbase - d * v)) >= v) return -1;
+        if ((u2 = (std::min)((long long)(v), u2 * tbase - d * v)) <= 0)
+          return +1;
+        if (u1 <= 0 && u2 >= v) return 0;
+      }
+    }
+  private:
+    static const uint_t base = digit_gen::base;
+    static const int bits = digit_gen::bits;
+    static const bool power_of_two = digit_gen::power_of_two;
+    digit_gen& _D;
+    static void check(int num, int den) {
+      if (!(den > 0 && num >= 0 && num <= den))
+        throw std::runtime_error
+          ("bernoulli_rational: need den > 0, 0 <= num <= den");
+    }
+  };
+
+  /**
+   * @brief Exact Bernoulli trials with probability exp(&minus;@e x).
+   *
+   * @tparam digit_gen the type of digit generator.
+   *
+   * The trials use von Neumann's algorithm: for @e x &le; 1, generate
+   * uniform deviates, the first compared with @e x, until they stop
+   * decreasing, and return true if the number of decreasing deviates is
+   * even.  For @e x &gt; 1, exp(&minus;@e x) is the product of floor(@e x)
+   * trials with @e x = 1 and one with the fractional part.  The deviates
+   * are u_rands so the trials are exact for rational @e x and for exact
+   * deviates @e x given as u_rands; the expected number of digits is
+   * bounded.
+   *
+   * The special case @e x = 1/2 is Algorithm H of Karney (2016) and
+   * count_half() and half_n() are steps 1 and 2 of Algorithms N and D.  The
+   * static member functions, which take the temporary u_rands as arguments,
+   * are the building blocks used by unit_normal_dist and
+   * discrete_normal_dist.
+   *
+   * This uses 2 u_rands as temporary storage; by default these are held by
+   * the object, but they may be supplied by a u_rand_workspace.
+   */
+  template<typename digit_gen> class bernoulli_exp {
+  public:
+    /**
+     * The constructor.
+     *
+     * @param D a reference to the digit generator to be used.
+     */
+    explicit bernoulli_exp(digit_gen& D)
+      : _D(D), _y0(D), _z0(D), _y(_y0), _z(_z0) {}
+    /**
+     * Construct using the temporary storage of a u_rand_workspace.
+     *
+     * @param w the workspace; its digit generator is used.
+     * @param first the first of the 2 slots of @e w to use (default 0).
+     */
+    explicit bernoulli_exp(u_rand_workspace<digit_gen>& w, int first = 0)
+      : _D(w.digit_generator()), _y0(_D), _z0(_D)
+      , _y(w.slot(first)), _z(w.slot(first + 1)) {}
+    /**
+     * The copy constructor.
+     *
+     * @param b the object to copy.
+     *
+     * The copy uses the same workspace as @e b (if any).
+     */
+    bernoulli_exp(const bernoulli_exp& b)
+      : _D(b._D), _y0(b._y0), _z0(b._z0)
+      , _y(b.owned() ? _y0 : b._y), _z(b.owned() ? _z0 : b._z) {}
+    /**
+     * Perform a Bernoulli trial with rational @e x.
+     *
+     * @tparam Generator the type of g.
+     * @param g the random generator engine.
+     * @param num the numerator of @e x.
+     * @param den the denominator of @e x.
+     * @exception std::runtime_error if not @e num &ge; 0 and @e den &gt; 0.
+     * @return true with probability exp(&minus;@e num/@e den).
+     */
+    template<typename Generator>
+    bool operator()(Generator& g, int num, int den = 1) {
+      check(num, den);
+      return trial(g, num / den, num % den, den, _y, _z);
+    }
+    /**
+     * Perform a Bernoulli trial with @e x given by a u_rand.
+     *
+     * @tparam Generator the type of g.
+     * @tparam store the digit_store for @e x.
+     * @param g the random generator engine.
+     * @param x a u_rand in [0, 1] (additional digits of @e x are generated
+     *   as necessary).
+     * @return true with probability exp(&minus;@e x).
+     */
+    template<typename Generator, typename store>
+    bool operator()(Generator& g, u_rand<digit_gen, store>& x)
+    { return trial(g, x, _y, _z); }
+    /**
+     * Perform several Bernoulli trials with the same rational @e x.
+     *
+     * @tparam Generator the type of g.
+     * @param g the random generator engine.
+     * @param num the numerator of @e x.
+     * @param den the denominator of @e x.
+     * @param[out] p where to put the results.
+     * @param n the number of trials.
+     * @exception std::runtime_error if not @e num &ge; 0 and @e den &gt; 0.
+     *
+     * The results are the same as @e n calls to operator()(); the parameters
+     * are checked and split into integer and fractional parts once.
+     */
+    template<typename Generator>
+    void generate(Generator& g, int num, int den, bool* p, size_t n) {
+      check(num, den);
+      const int q = num / den, r = num % den;
+      for (bool* e = p + n; p != e; ++p)
+        *p = trial(g, q, r, den, _y, _z);
+    }
+    /**
+     * @tparam Generator the type of g.
+     * @param g the random generator engine.
+     * @return true with probability exp(&minus;1/2).
+     */
+    template<typename Generator>
+    bool half(Generator& g) { return half(g, _y, _z); }
+    /**
+     * @tparam Generator the type of g.
+     * @param g the random generator engine.
+     * @return @e n &ge; 0 with probability exp(&minus;@e n/2) (1 &minus;
+     *   exp(&minus;1/2)), the number of successful trials with probability
+     *   exp(&minus;1/2) before the first failure.
+     */
+    template<typename Generator>
+    int count_half(Generator& g) { return count_half(g, _y, _z); }
+    /**
+     * @tparam Generator the type of g.
+     * @param g the random generator engine.
+     * @param n a nonnegative integer.
+     * @return true with probability exp(&minus;@e n/2).
+     */
+    template<typename Generator>
+    bool half_n(Generator& g, int n) { return half_n(g, n, _y, _z); }
+    /**
+     * @return a reference to the digit generator used in the constructor.
+     */
+    digit_gen& digit_generator() const { return _D; }
+
+    /**
+     * A trial with probability exp(&minus;1/2) using specified temporaries
+     * (Algorithm H).
+     *
+     * @tparam Generator the type of g.
+     * @tparam store the digit_store for the temporaries.
+     * @param g the random generator engine.
+     * @param y a temporary u_rand.
+     * @param z a temporary u_rand.
+     * @return true with probability exp(&minus;1/2).
+     */
+    template<typename Generator, typename store>
+    EXRANDOM_PROFILE_STEP
+    static bool half(Generator& g, u_rand<digit_gen, store>& y,
+                     u_rand<digit_gen, store>& z) {
+      if (!y.init().less_than_half(g)) return true;
+      for (;;) {
+        if (!z.init().less_than(g, y)) return false;
+        if (!y.init().less_than(g, z)) return true;
+      }
+    }
+    /**
+     * The number of successful trials with probability exp(&minus;1/2)
+     * before the first failure using specified temporaries (step 1 of
+     * Algorithms N and D).
+     *
+     * @tparam Generator the type of g.
+     * @tparam store the digit_store for the temporaries.
+     * @param g the random generator engine.
+     * @param y a temporary u_rand.
+     * @param z a temporary u_rand.
+     * @return @e n &ge; 0 with probability exp(&minus;@e n/2) (1 &minus;
+     *   exp(&minus;1/2)).
+     */
+    template<typename Generator, typename store>
+    EXRANDOM_PROFILE_STEP
+    static int count_half(Generator& g, u_rand<digit_gen, store>& y,
+                          u_rand<digit_gen, store>& z)
+    { int n = 0; while (half(g, y, z)) ++n; return n; }
+    /**
+     * A trial with probability exp(&minus;@e n/2) using specified
+     * temporaries (step 2 of Algorithms N and D).
+     *
+     * @tparam Generator the type of g.
+     * @tparam store the digit_store for the temporaries.
+     * @param g the random generator engine.
+     * @param n a nonnegative integer.
+     * @param y a temporary u_rand.
+     * @param z a temporary u_rand.
+     * @return true with probability exp(&minus;@e n/2).
+     */
+    template<typename Generator, typename store>
+    EXRANDOM_PROFILE_STEP
+    static bool half_n(Generator& g, int n, u_rand<digit_gen, store>& y,
+                       u_rand<digit_gen, store>& z)
+    { while (n-- && half(g, y, z)) {}; return n < 0; }
+    /**
+     * A trial with probability exp(&minus;(@e q + @e r/@e den)) using
+     * specified temporaries.
+     *
+     * @tparam Generator the type of g.
+     * @tparam store the digit_store for the temporaries.
+     * @param g the random generator engine.
+     * @param q the integer part of @e x.
+     * @param r the numerator of the fractional part of @e x.
+     * @param den the denominator of the fractional part of @e x.
+     * @param y a temporary u_rand.
+     * @param z a temporary u_rand.
+     * @return true with probability exp(&minus;(@e q + @e r/@e den)).
+     *
+     * This requires @e q &ge; 0, 0 &le; @e r &le; @e den, and @e den &gt;
+     * 0 (which is not checked).
+     */
+    template<typename Generator, typename store>
+    EXRANDOM_PROFILE_STEP
+    static bool trial(Generator& g, int q, int r, int den,
+                      u_rand<digit_gen, store>& y,
+                      u_rand<digit_gen, store>& z) {
+      for (; q > 0; --q)
+        if (!frac(g, den, den, y, z)) return false;
+      return frac(g, r, den, y, z);
+    }
+    /**
+     * A trial with probability exp(&minus;@e x), @e x a u_rand, using
+     * specified temporaries.
+     *
+     * @tparam Generator the type of g.
+     * @tparam store the digit_store for the temporaries.
+     * @tparam xstore the digit_store for @e x.
+     * @param g the random generator engine.
+     * @param x a u_rand in [0, 1] distinct from @e y and @e z.
+     * @param y a temporary u_rand.
+     * @param z a temporary u_rand.
+     * @return true with probability exp(&minus;@e x).
+     */
+    template<typename Generator, typename store, typename xstore>
+    EXRANDOM_PROFILE_STEP
+    static bool trial(Generator& g, u_rand<digit_gen, xstore>& x,
+                      u_rand<digit_gen, store>& y,
+                      u_rand<digit_gen, store>& z) {
+      int n = 0;
+      for (;; ++n) {
+        if (!(n ? z.init().less_than(g, y) : z.init().less_than(g, x)))
+          break;
+        y.swap(z);              // an efficient way of doing y = z
+      }
+      return (n % 2) == 0;
+    }
+  private:
+    // Disable copy assignment
+    bernoulli_exp& operator=(const bernoulli_exp&);
+    digit_gen& _D;
+    u_rand<digit_gen> _y0, _z0; // own temporary storage
+    u_rand<digit_gen> &_y, &_z;
+    bool owned() const { return &_y == &_y0; }
+    static void check(int num, int den) {
+      if (!(den > 0 && num >= 0))
+        throw std::runtime_error("bernoulli_exp: need den > 0, num >= 0");
+    }
+    // True with probability exp(-r/den) for 0 <= r <= den; the first
+    // comparison is z < r/den (von Neumann).
+    template<typename Generator, typename store>
+    static bool frac(Generator& g, int r, int den,
+                     u_rand<digit_gen, store>& y,
+                     u_rand<digit_gen, store>& z) {
+      if (2 * (long long)(r) == den) return half(g, y, z);
+      int n = 0;
+      for (;; ++n) {
+        if (!(n ? z.init().less_than(g, y) :
+              z.init().compare(g, r, r, den) < 0))
+          break;
+        y.swap(z);
+      }
+      return (n % 2) == 0;
+    }
+  };
+
+}
+
+#endif  // EXRANDOM_BERNOULLI_HPP
@@ -0,0 +1,284 @@
+/**
+ * @file buffered_rand_digit.hpp
+ * @author Charles Karney <charles.karney@sri.com>
+ * @brief Definition of buffered_rand_digit
+ *
+ * Copyright (c) Charles Karney (2016) and licensed under the MIT/X11 License.
+ * For more information, see http://exrandom.sourceforge.net/
+ */
+
+#if !defined(EXRANDOM_BUFFERED_RAND_DIGIT_HPP)
+#define EXRANDOM_BUFFERED_RAND_DIGIT_HPP 1
+
+#include <random>               // for uniform_int_distribution
+#include <cmath>                // for std::ldexp
+#include <cstdint>              // for uint64_t
+#include <cstddef>              // for size_t
+#include <algorithm>            // for std::min
+
+#include <exrandom/digit_arithmetic.hpp>
+
+#if defined(_MSC_VER)
+// Squelch warnings about constant conditional expressions
+#  pragma warning (push)
+#  pragma warning (disable: 4127)
+#endif
+
+namespace exrandom {
+
+  /**
+   * @brief Machinery to convert a random generator into a random digit
+   * without wasting the bits produced by the generator.
+   *
+   * @tparam b the base for the digits.
+   *
+   * This produces random digits in the range [0,b) and keeps count of how
+   * many digits are produced, just as rand_digit does.  The difference is in
+   * how the output of the random generator engine is used.  rand_digit calls
+   * the engine once for every digit; so, for example, with b = 2 and
+   * std::mt19937 only 1 of the 32 random bits is used.  If the base is a power
+   * of two, buffered_rand_digit instead keeps the output of the engine in a
+   * 64-bit reservoir and peels off @e bits bits for each digit.  All the bits
+   * produced by the engine are used, provided that its range is a power of
+   * two (as is the case with std::mt19937, std::mt19937_64, and
+   * std::ranlux48); otherwise 32 random bits are obtained from the engine
+   * using std::uniform_int_distribution.
+   *
+   * If the base is not a power of two, 32-bit chunks from the reservoir feed
+   * a second reservoir, an integer c uniformly distributed in [0, v) with v
+   * &lt; 2<sup>64</sup>.  A digit is extracted as c mod b provided that c
+   * &lt; b floor(v/b), in which case the reservoir is replaced by floor(c/b)
+   * uniform in [0, floor(v/b)).  Otherwise the reservoir is replaced by c
+   * &minus; b floor(v/b) uniform in [0, v &minus; b floor(v/b)).  This is
+   * the entropy-recycling method of J. Lumbroso (2013), <a
+   * href="http://arxiv.org/abs/1304.1916">arxiv:1304.1916</a>, which is also
+   * used by i_rand::init.  Because 32 bits are added to the reservoir
+   * whenever v &lt; 2<sup>32</sup>, the probability of the second branch is
+   * less than b/2<sup>32</sup> and the number of random bits consumed per
+   * digit is very close to log<sub>2</sub>b.  For example, with b = 10 and
+   * std::mt19937_64, 19 digits are produced per call to the engine on
+   * average.
+   *
+   * This class can be used in place of rand_digit as the digit_gen template
+   * parameter of u_rand, i_rand, and the *_dist classes.  However, any
+   * unused bits remain in the reservoir after a digit is produced.  If the
+   * engine is reseeded, reset() should be called to clear the reservoir.
+   */
+  template<uint_t b> class buffered_rand_digit {
+  public:
+    /**
+     * The base for the digits (or 0 if the base is 2<sup>32</sup>).
+     */
+    static const uint_t base = digit_arithmetic<b>::base;
+    /**
+     * The minimum value produced by operator().
+     */
+    static const uint_t min_value = 0U;
+    /**
+     * The maximum value produced by operator().
+     */
+    static const uint_t max_value = digit_arithmetic<b>::basem1;
+    /**
+     * The number of bits needed to represent a digit.
+     */
+    static const int bits = digit_arithmetic<b>::bits;
+    /**
+     * Is the base a power of two?
+     */
+    static const bool power_of_two = digit_arithmetic<b>::power_of_two;
+    /**
+     * The constructor (which initializes the count to 0 and empties the
+     * reservoir).
+     */
+    buffered_rand_digit() : _count(0), _n(0), _w0(0), _w1(0), _v(1), _c(0) {}
+    /**
+     * @tparam Generator the type of g.
+     * @param g the random generator engine.
+     * @return the random digit.
+     */
+    template<typename Generator>
+    uint_t operator()(Generator& g) { // a random digit
+      ++_count;
+      EXRANDOM_IF_CONSTEXPR (power_of_two)
+        return uint_t(take(g, bits));
+      else {
+        // The base != 0 test avoids silly warnings from the compiler when b =
+        // 2^32 (in which case this branch is never taken).
+        const std::uint64_t lbase = base != 0U ? base : 1U;
+        for (;;) {
+          if (_v >> 32 == 0U) { _v <<= 32; _c = (_c << 32) | take(g, 32); }
+          std::uint64_t m = (_v / lbase) * lbase;
+          if (_c < m) {
+            uint_t d = uint_t(_c % lbase);
+            _c /= lbase; _v = m / lbase;
+            return d;
+          }
+          _c -= m; _v -= m;
+        }
+      }
+    }
+    /**
+     * Produce several random digits.
+     *
+     * @tparam Generator the type of g.
+     * @param g the random generator engine.
+     * @param[out] p where to put the digits.
+     * @param n the number of digits.
+     *
+     * The digits are the same as @e n calls to operator()(g) would return.
+     * For a power-of-two base, the digits are extracted from the reservoir
+     * 64 bits at a time.
+     */
+    template<typename Generator>
+    void generate(Generator& g, uint_t* p, size_t n) {
+      EXRANDOM_IF_CONSTEXPR (power_of_two) {
+        _count += n;
+        const size_t m = 64 / bits;        // digits per refill
+        while (n) {
+          if (_n < bits) fill(g);
+          size_t k = (std::min)(n, size_t(_n / bits));
+          if (k > m) k = m;
+          for (size_t i = 0; i < k; ++i)
+            p[i] = uint_t(_w0 >> (64 - bits * (i + 1))) & max_value;
+          drop(int(k) * bits);
+          p += k; n -= k;
+        }
+      } else
+        for (uint_t* e = p + n; p != e; ++p) *p = (*this)(g);
+    }
+    /**
+     * Look at the next digits without consuming them.
+     *
+     * @tparam Generator the type of g.
+     * @param g the random generator engine.
+     * @param n the number of digits; requires 0 &lt; @e n and @e n &times;
+     *   @e bits &le; 64.
+     * @return the next @e n digits packed into an integer with the first
+     *   digit in the most significant position.
+     *
+     * This is only available if the base is a power of two.  The digits are
+     * those which subsequent calls to operator() would return; they are not
+     * counted until they are consumed with discard().
+     */
+    template<typename Generator>
+    std::uint64_t peek(Generator& g, int n) {
+      static_assert(power_of_two, "peek requires a power-of-two base");
+      const int k = n * bits;
+      while (_n < k) fill(g);
+      return k == 64 ? _w0 : _w0 >> (64 - k);
+    }
+    /**
+     * Consume digits which have been examined with peek().
+     *
+     * @param n the number of digits; requires 0 &lt; @e n and @e n &times;
+     *   @e bits &le; 64.
+     *
+     * The count is incremented by @e n.
+     */
+    void discard(int n) {
+      static_assert(power_of_two, "discard requires a power-of-two base");
+      _count += n;
+      drop(n * bits);
+    }
+    /**
+     * Empty the reservoirs of random bits.  The count is not changed.
+     */
+    void reset() { _n = 0; _w0 = _w1 = 0; _v = 1; _c = 0; }
+    /**
+     * @return the count.
+     */
+    long long count() const { return _count; }
+    /**
+     * @tparam the floating point type of the result.
+     * @return 1/@e base as a floating point number.
+     */
+    template<typename RealType>
+    static RealType invrealbase() {
+      using std::ldexp;
+      return power_of_two ? ldexp(RealType(1), -bits) : 1/RealType(base);
+    }
+  private:
+    typedef std::uniform_int_distribution<std::uint64_t>  word_random_t;
+    word_random_t _wgen;
+    long long _count;
+    // The reservoir holds _n random bits left-justified in the 128-bit
+    // quantity _w0:_w1.  Words from the engine are only appended when _n <
+    // 64 (_n < 32 except for peek).  Thus _n never exceeds 64 + 63 and _w1 is
+    // only needed to hold the part of an engine word which doesn't fit into
+    // _w0.
+    int _n;
+    std::uint64_t _w0, _w1;
+    // For bases which are not a power of two, _c is uniform in [0, _v).
+    std::uint64_t _v, _c;
+    // The number of bits in the engine output if its range is [0, 2^n), else
+    // 0.  This is a compile-time constant unless the range of the engine
+    // isn't.
+    template<typename Generator>
+    static int word_bits() {
+      return engine_bits<Generator>::value >= 0 ?
+        engine_bits<Generator>::value : runtime_bits<Generator>();
+    }
+    template<typename Generator>
+    static int runtime_bits() {
+      std::uint64_t r = std::uint64_t(Generator::max() - Generator::min());
+      int n = 0;
+      while (n < 64 && (r >> n) & 1U) ++n;
+      return (Generator::min() == 0 && (n == 64 || (r >> n) == 0U)) ? n : 0;
+    }
+    // Append a word from the engine to the reservoir; requires _n <= 64.
+    template<typename Generator>
+    void fill(Generator& g) {
+      const int ebits = word_bits<Generator>() ? word_bits<Generator>() : 32;
+      std::uint64_t x = word_bits<Generator>() ? std::uint64_t(g()) :
+        _wgen(g, word_random_t::param_type(0U, 0xffffffffULL));
+      x <<= 64 - ebits;         // left-justify
+      if (_n == 0) {
+        _w0 = x; _w1 = 0;
+      } else if (_n < 64) {
+        _w0 |= x >> _n; _w1 = x << (64 - _n);
+      } else
+        _w1 = x;
+      _n += ebits;
+    }
+    // Return the leading k bits from the reservoir; requires 0 < k <= 32.
+    template<typename Generator>
+    std::uint64_t take(Generator& g, int k) {
+      while (_n < k) fill(g);
+      std::uint64_t x = _w0 >> (64 - k);
+      drop(k);
+      return x;
+    }
+    // Remove the leading k bits from the reservoir; requires 0 < k <= 64.
+    void drop(int k) {
+      if (k < 64) {
+        _w0 = (_w0 << k) | (_w1 >> (64 - k));
+        _w1 <<= k;
+      } else {
+        _w0 = _w1; _w1 = 0;
+      }
+      _n -= k;
+    }
+  };
+
+  /**
+   * @brief buffered_rand_digit allows its digits to be peeked at if the base
+   * is a power of two less than 2<sup>32</sup>.
+   *
+   * @tparam b the base for the digits.
+   */
+  template<uint_t b> class peekable_digits<buffered_rand_digit<b> > {
+  public:
+    /**
+     * Whether buffered_rand_digit<b> provides peek and discard.
+     */
+    static const bool value = digit_arithmetic<b>::power_of_two &&
+      digit_arithmetic<b>::bits < 32;
+  };
+
+}
+
+#if defined(_MSC_VER)
+#  pragma warning (pop)
+#endif
+
+#endif  // EXRANDOM_BUFFERED_RAND_DIGIT_HPP
@@ -12,6 +12,7 @@
 
 #include <cstdint>              // for uint_fast32_t
 #include <limits>               // for numeric_limits<uint_t>::digits;
+#include <type_traits>          // for std::integral_constant
 
 #include <exrandom/exrandom_config.hpp>
 
@@ -57,6 +58,19 @@ namespace exrandom {
   int highest_bit_idx(unsigned x)
   { return x == 0 ? 0 : 1 + highest_bit_idx(x >> 1); }
 
+  /// \cond SKIP
+  // The number of bits in x as a template constant (highest_bit_idx is only
+  // usable at compile time if constexpr is supported).
+  template<unsigned long x> class bit_width {
+  public:
+    static const int value = 1 + bit_width<(x >> 1)>::value;
+  };
+  template<> class bit_width<0UL> {
+  public:
+    static const int value = 0;
+  };
+  /// \endcond
+
   /**
    * @brief Machinery to manipulate bases.
    *
@@ -74,48 +88,10 @@ namespace exrandom {
      * The base less 1, in range [1, 2<sup>32</sup> &minus; 1].
      */
     static const uint_t basem1 = base ? base - 1UL : uint_m;
-#if defined(DOXYGEN) || EXRANDOM_CONSTEXPR
     /**
      * The number of bits needed to hold a digit in [0, @e basem1].
      */
-    static const int bits = highest_bit_idx(unsigned(basem1));
-#else
-    static const int bits =
-      (basem1 <=        0x0UL ?  0 :
-       basem1 <=        0x1UL ?  1 :
-       basem1 <=        0x3UL ?  2 :
-       basem1 <=        0x7UL ?  3 :
-       basem1 <=        0xfUL ?  4 :
-       basem1 <=       0x1fUL ?  5 :
-       basem1 <=       0x3fUL ?  6 :
-       basem1 <=       0x7fUL ?  7 :
-       basem1 <=       0xffUL ?  8 :
-       basem1 <=      0x1ffUL ?  9 :
-       basem1 <=      0x3ffUL ? 10 :
-       basem1 <=      0x7ffUL ? 11 :
-       basem1 <=      0xfffUL ? 12 :
-       basem1 <=     0x1fffUL ? 13 :
-       basem1 <=     0x3fffUL ? 14 :
-       basem1 <=     0x7fffUL ? 15 :
-       basem1 <=     0xffffUL ? 16 :
-       basem1 <=    0x1ffffUL ? 17 :
-       basem1 <=    0x3ffffUL ? 18 :
-       basem1 <=    0x7ffffUL ? 19 :
-       basem1 <=    0xfffffUL ? 20 :
-       basem1 <=   0x1fffffUL ? 21 :
-       basem1 <=   0x3fffffUL ? 22 :
-       basem1 <=   0x7fffffUL ? 23 :
-       basem1 <=   0xffffffUL ? 24 :
-       basem1 <=  0x1ffffffUL ? 25 :
-       basem1 <=  0x3ffffffUL ? 26 :
-       basem1 <=  0x7ffffffUL ? 27 :
-       basem1 <=  0xfffffffUL ? 28 :
-       basem1 <= 0x1fffffffUL ? 29 :
-       basem1 <= 0x3fffffffUL ? 30 :
-       basem1 <= 0x7fffffffUL ? 31 :
-       basem1 <= 0xffffffffUL ? 32 :
-       33);
-#endif
+    static const int bits = bit_width<basem1>::value;
 
     /**
      * Is the base a power of 2?
@@ -128,6 +104,95 @@ namespace exrandom {
     static_assert(bits != 0, "base must be 2 or more");
   };
 
+  /**
+   * @brief Does a digit generator allow digits to be examined before they are
+   * consumed?
+   *
+   * @tparam digit_gen the type of the digit generator.
+   *
+   * If @e value is true, digit_gen provides
+   * - peek(g, n), returning the next @e n digits packed into a std::uint64_t
+   *   with the first digit most significant (where @e n &times; @e bits
+   *   &le; 64), and
+   * - discard(n), consuming the first @e n peeked digits.
+   *
+   * u_rand::less_than uses this to compare the digits of two u_rands a word
+   * at a time.  The primary template gives @e value = false; it is
+   * specialized for buffered_rand_digit with a power-of-two base less than
+   * 2<sup>32</sup>.
+   */
+  template<typename digit_gen> class peekable_digits {
+  public:
+    /**
+     * Whether digit_gen provides peek and discard.
+     */
+    static const bool value = false;
+  };
+
+  /**
+   * @brief Does a random number engine supply its output 32 bits at a time?
+   *
+   * @tparam Generator the type of the random number engine.
+   *
+   * If @e value is true, Generator provides next32(), returning the next 32
+   * random bits as a std::uint32_t; each 64-bit output of the engine then
+   * supplies two 32-bit results.  rand_digit uses this for power-of-two
+   * bases so that each digit consumes 32 bits of the engine's output and no
+   * bits are wasted.  The primary template gives @e value = false; it is
+   * specialized for philox_engine.
+   */
+  template<typename Generator> class word32_engine {
+  public:
+    /**
+     * Whether Generator provides next32.
+     */
+    static const bool value = false;
+  };
+
+  /// \cond SKIP
+#if EXRANDOM_CONSTEXPR
+  // The number of trailing one bits in r
+  constexpr int trailing_ones(unsigned long long r, int n = 0) {
+    return n < 64 && ((r >> n) & 1ULL) ? trailing_ones(r, n + 1) : n;
+  }
+  // n if [lo, hi] = [0, 2^n - 1], else 0
+  constexpr int range_bits(unsigned long long lo, unsigned long long hi) {
+    return lo == 0ULL && (trailing_ones(hi) == 64 ||
+                          (hi >> trailing_ones(hi)) == 0ULL) ?
+      trailing_ones(hi) : 0;
+  }
+  // Selected if Generator::min() and max() are constant expressions
+  template<typename Generator>
+  std::integral_constant<int, range_bits(Generator::min(), Generator::max())>
+  engine_bits_test(int);
+#endif
+  template<typename Generator>
+  std::integral_constant<int, -1> engine_bits_test(...);
+  /// \endcond
+
+  /**
+   * @brief The number of bits in each result of a random number engine.
+   *
+   * @tparam Generator the type of the random number engine.
+   *
+   * @e value is @e n if the range of Generator is [0, 2<sup>@e n</sup>)
+   * (e.g., 32 for std::mt19937 and 64 for std::mt19937_64) and 0 otherwise.
+   * This is determined at compile time if Generator::min() and
+   * Generator::max() are constexpr (so that the digit generators contain no
+   * tests on the range of the engine); otherwise @e value is &minus;1 and
+   * the digit generators test the range when they run.  As with
+   * word32_engine, this can be specialized for an engine whose range is
+   * known but not constexpr.
+   */
+  template<typename Generator> class engine_bits {
+  public:
+    /**
+     * The number of bits, 0 if the range is not a power of two, or &minus;1
+     * if this isn't known at compile time.
+     */
+    static const int value = decltype(engine_bits_test<Generator>(0))::value;
+  };
+
 }
 
 #endif  // EXRANDOM_DIGIT_ARITHMETIC_HPP
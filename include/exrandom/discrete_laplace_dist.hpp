@@ -0,0 +1,281 @@
+/**
+ * @file discrete_laplace_dist.hpp
+ * @author Charles Karney <charles.karney@sri.com>
+ * @brief Definition of discrete_laplace_dist
+ *
+ * Copyright (c) Charles Karney (2016) and licensed under the MIT/X11 License.
+ * For more information, see http://exrandom.sourceforge.net/
+ */
+
+#if !defined(EXRANDOM_DISCRETE_LAPLACE_DIST_HPP)
+#define EXRANDOM_DISCRETE_LAPLACE_DIST_HPP 1
+
+#include <iostream>             // for std::ostream, etc.
+#include <stdexcept>            // for std::runtime_error
+#include <cstddef>              // for size_t
+#include <limits>
+
+#include <exrandom/i_rand.hpp>
+#include <exrandom/bernoulli.hpp>
+#include <exrandom/geometric_dist.hpp>
+
+namespace exrandom {
+
+  /**
+   * @brief Sample exactly from the discrete Laplace distribution.
+   *
+   * @tparam digit_gen the type of digit generator.
+   *
+   * This samples from the discrete Laplace distribution P<sub>i</sub>
+   * &prop; exp(&minus;|i &minus; &mu;|/t), where &mu; and the scale t &gt; 0
+   * are rational.  With c = ceil(&mu;), the integers i &ge; c and i &lt; c
+   * form two geometric tails, i = c + k and i = c &minus; 1 &minus; k, with
+   * weights exp(&minus;d<sub>+</sub>/t) and exp(&minus;d<sub>&minus;</sub>/t)
+   * where d<sub>+</sub> = c &minus; &mu; and d<sub>&minus;</sub> = 1 &minus;
+   * d<sub>+</sub>.  So pick a tail with an i_rand, accept the heavier tail
+   * and accept the other with probability exp(&minus;|d<sub>+</sub>
+   * &minus; d<sub>&minus;</sub>|/t) with bernoulli_exp, and sample k with
+   * geometric_dist.  For integer &mu;, this is the method of C. L. Canonne,
+   * G. Kamath, and T. Steinke (2020), <a
+   * href="https://arxiv.org/abs/2004.00010">arxiv:2004.00010</a>, except
+   * that the rejection, which happens with probability (1 &minus;
+   * exp(&minus;1/t))/2, precedes sampling k.  All the steps are exact.
+   *
+   * The numerators and denominators of &mu; and t are ints; t is limited as
+   * for geometric_dist and there must be no possibility of overflow in the
+   * results or in the integers representing the probability of acceptance.
+   * digit_gen::base must be less than 2<sup>32</sup>.
+   * See discrete_laplace_distribution for a C++11 style interface.
+   */
+  template<typename digit_gen> class discrete_laplace_dist {
+  public:
+    /**
+     * @brief Hold the parameters of discrete_laplace_dist.
+     */
+    struct param_type {
+      /**
+       * Construct from the individual parameters.
+       *
+       * @param mu_num the numerator of &mu;.
+       * @param mu_den the denominator of &mu;.
+       * @param t_num the numerator of t.
+       * @param t_den the denominator of t.
+       * @exception std::runtime_error if the parameters are out of range or
+       *   might result in overflow.
+       *
+       * Sets &mu; = @e mu_num / @e mu_den and t = @e t_num / @e t_den.
+       */
+      explicit param_type(int mu_num, int mu_den, int t_num, int t_den)
+        : _geom(t_num, t_den) { param_init(mu_num, mu_den); }
+      /**
+       * Construct with integer parameters.
+       *
+       * @param mu the value of &mu; (default 0).
+       * @param t the value of t (default 1).
+       * @exception std::runtime_error if the parameters are out of range or
+       *   might result in overflow.
+       */
+      explicit param_type(int mu = 0, int t = 1)
+        : _geom(t, 1) { param_init(mu, 1); }
+      /**
+       * @return the numerator of &mu;.
+       */
+      int mu_num() const { return _mu_num; }
+      /**
+       * @return the denominator of &mu;.
+       */
+      int mu_den() const { return _mu_den; }
+      /**
+       * @return the numerator of t.
+       */
+      int t_num() const { return _geom.t_num(); }
+      /**
+       * @return the denominator of t.
+       */
+      int t_den() const { return _geom.t_den(); }
+      /**
+       * Test for equality.
+       *
+       * @param p1
+       * @param p2
+       * @return p1 == p2.
+       */
+      friend bool operator==(const param_type& p1, const param_type& p2) {
+        return p1._mu_num == p2._mu_num && p1._mu_den == p2._mu_den &&
+          p1._geom == p2._geom;
+      }
+      /**
+       * Inserts a param_type @e x into the output stream @e os.
+       *
+       * @param os an output stream.
+       * @param x a param_type.
+       * @return os.
+       */
+      friend std::ostream& operator<<(std::ostream& os, const param_type& x) {
+        const auto flags = os.flags();
+        os.flags(std::ios::dec);
+        os << x.mu_num() << ' ' << x.mu_den() << ' ' << x._geom;
+        os.flags(flags);
+        return os;
+      }
+      /**
+       * Extracts a param_type @e x from the input stream @e is.
+       *
+       * @param is an input stream.
+       * @param x a param_type.
+       * @return is.
+       */
+      friend std::istream& operator>>(std::istream& is, param_type& x) {
+        const auto flags = is.flags();
+        is.flags(std::ios::dec | std::ios::skipws);
+        int mu_num, mu_den, t_num, t_den;
+        if (is >> mu_num >> mu_den >> t_num >> t_den)
+          x = param_type(mu_num, mu_den, t_num, t_den);
+        is.flags(flags);
+        return is;
+      }
+    private:
+      friend class discrete_laplace_dist;
+      typename geometric_dist<digit_gen>::param_type _geom;
+      int _mu_num, _mu_den;
+      int _c;                   // ceil(mu)
+      bool _upper;              // the upper tail is the heavier one
+      int _a_num, _a_den;       // accept the lighter tail w.p. exp(-a)
+      void param_init(int mu_num, int mu_den) {
+        const long long maxint = std::numeric_limits<int>::max();
+        if (!(mu_den > 0 && mu_num > std::numeric_limits<int>::min()))
+          throw std::runtime_error("discrete_laplace_dist: need mu_den > 0");
+        long long l = gcd(mu_num, mu_den);
+        _mu_num = int(mu_num / l); _mu_den = int(mu_den / l);
+        long long c = mu_num / mu_den;
+        if (c * mu_den < mu_num) ++c;
+        // mu = c - f/mu_den; d+ = f/mu_den, d- = 1 - d+
+        long long f = c * _mu_den - _mu_num, e = _mu_den - 2 * f;
+        _upper = e >= 0;
+        // a = |d+ - d-|/t = |e| * t_den / (mu_den * t_num)
+        long long n = (e < 0 ? -e : e) * t_den(),
+          d = (long long)(_mu_den) * t_num();
+        l = gcd(n, d); n /= l; d /= l;
+        // The results are less than |c| + 1 + 1250 t in magnitude (see
+        // geometric_dist).
+        if (!(n <= maxint && d <= maxint &&
+              (c < 0 ? -c : c) + 2 + 1250LL * t_num() / t_den() <= maxint))
+          throw std::runtime_error("discrete_laplace_dist: possible overflow");
+        _c = int(c); _a_num = int(n); _a_den = int(d);
+      }
+      // Knuth, TAOCP, vol 2, 4.5.2, Algorithm A
+      static long long gcd(long long u, long long v) {
+        u = u < 0 ? -u : u; v = v < 0 ? -v : v;
+        while (v > 0) { long long r = u % v; u = v; v = r; }
+        return u;
+      }
+    };
+
+    /**
+     * The constructor.
+     *
+     * @param D a reference to the digit generator to be used.
+     * @param p the parameters (default &mu; = 0 and t = 1).
+     */
+    explicit discrete_laplace_dist(digit_gen& D,
+                                   const param_type& p = param_type())
+      : _D(D), _G(D), _H(D), _j(D), _param(p) {}
+    /**
+     * Construct from the individual parameters.
+     *
+     * @param D a reference to the digit generator to be used.
+     * @param mu_num the numerator of &mu;.
+     * @param mu_den the denominator of &mu;.
+     * @param t_num the numerator of t.
+     * @param t_den the denominator of t.
+     * @exception std::runtime_error if the parameters are out of range or
+     *   might result in overflow.
+     */
+    discrete_laplace_dist(digit_gen& D, int mu_num, int mu_den,
+                          int t_num, int t_den)
+      : _D(D), _G(D), _H(D), _j(D)
+      , _param(mu_num, mu_den, t_num, t_den) {}
+    /**
+     * Return a deviate.
+     *
+     * @tparam Generator the type of g.
+     * @param g the random generator engine.
+     * @return the random deviate.
+     */
+    template<typename Generator>
+    int operator()(Generator& g) { return operator()(g, _param); }
+    /**
+     * Return a deviate using the specified parameters.
+     *
+     * @tparam Generator the type of g.
+     * @param g the random generator engine.
+     * @param p the parameters.
+     * @return the random deviate.
+     *
+     * The parameters of *this are not changed.
+     */
+    template<typename Generator>
+    int operator()(Generator& g, const param_type& p) {
+      bool upper;
+      do
+        upper = _j.init(g, 2)(g) != 0;
+      while (!(upper == p._upper || _H(g, p._a_num, p._a_den)));
+      int k = _G(g, p._geom);
+      return upper ? p._c + k : p._c - 1 - k;
+    }
+    /**
+     * Fill an array with deviates.
+     *
+     * @tparam Generator the type of g.
+     * @param g the random generator engine.
+     * @param[out] p where to put the results.
+     * @param n the number of deviates.
+     *
+     * The results are the same as @e n calls to operator()().
+     */
+    template<typename Generator>
+    void generate(Generator& g, int* p, size_t n)
+    { for (int* e = p + n; p != e; ++p) *p = operator()(g, _param); }
+    /**
+     * @return the numerator of &mu;.
+     */
+    int mu_num() const { return _param.mu_num(); }
+    /**
+     * @return the denominator of &mu;.
+     */
+    int mu_den() const { return _param.mu_den(); }
+    /**
+     * @return the numerator of t.
+     */
+    int t_num() const { return _param.t_num(); }
+    /**
+     * @return the denominator of t.
+     */
+    int t_den() const { return _param.t_den(); }
+    /**
+     * @return a reference to the digit generator used in the constructor.
+     */
+    digit_gen& digit_generator() const { return _D; }
+    /**
+     * @return the parameters.
+     */
+    const param_type& param() const { return _param; }
+    /**
+     * Set new parameters.
+     *
+     * @param p the new parameters.
+     */
+    void init(const param_type& p) { _param = p; }
+  private:
+    // Disable copy assignment
+    discrete_laplace_dist& operator=(const discrete_laplace_dist&);
+    digit_gen& _D;
+    geometric_dist<digit_gen> _G;
+    bernoulli_exp<digit_gen> _H;
+    i_rand<digit_gen> _j;       // temporary storage
+    param_type _param;
+  };
+
+}
+
+#endif  // EXRANDOM_DISCRETE_LAPLACE_DIST_HPP
@@ -0,0 +1,281 @@
+/**
+ * @file discrete_laplace_distribution.hpp
+ * @author Charles Karney <charles.karney@sri.com>
+ * @brief Definition of discrete_laplace_distribution
+ *
+ * Copyright (c) Charles Karney (2016) and licensed under the MIT/X11 License.
+ * For more information, see http://exrandom.sourceforge.net/
+ */
+
+#if !defined(EXRANDOM_DISCRETE_LAPLACE_DISTRIBUTION_HPP)
+#define EXRANDOM_DISCRETE_LAPLACE_DISTRIBUTION_HPP 1
+
+#include <iostream>             // for std::ostream, etc.
+#include <limits>
+#include <cstddef>              // for size_t
+
+#include <exrandom/rand_digit.hpp>
+#include <exrandom/discrete_laplace_dist.hpp>
+
+namespace exrandom {
+
+  /**
+   * @brief Sample exactly from the discrete Laplace distribution.
+   *
+   * This samples from the discrete Laplace distribution P<sub>i</sub> &prop;
+   * exp(&minus;|i &minus; &mu;|/t), where &mu; and the scale t &gt; 0 are
+   * specified as rational numbers (the ratio of two ints).
+   *
+   * This is a wrapper for discrete_laplace_dist to turn it into a C++11 style
+   * random distribution.  The base for discrete_laplace_dist is set to
+   * 2<sup>16</sup>.
+   */
+  class discrete_laplace_distribution {
+  private:
+    static const uint_t _base = 1UL<<16;
+  public:
+    /**
+     * The type of the range of the distribution.
+     */
+    typedef int result_type;
+    /**
+     * @brief Parameter type for discrete_laplace_distribution.
+     */
+    struct param_type : discrete_laplace_dist<rand_digit<_base>>::param_type {
+      /**
+       * The type of the random number distribution.
+       */
+      typedef discrete_laplace_distribution distribution_type;
+
+      /**
+       * Construct with integer parameters.
+       *
+       * @param mu the value of &mu; (default 0).
+       * @param t the value of t (default 1).
+       *
+       * Sets &mu; = @e mu and t = @e t.
+       */
+      explicit param_type(int mu = 0, int t = 1)
+        : discrete_laplace_dist<rand_digit<_base>>::param_type(mu, t) {}
+
+      /**
+       * Construct from the individual parameters.
+       *
+       * @param mu_num the numerator of &mu;.
+       * @param mu_den the denominator of &mu;.
+       * @param t_num the numerator of t.
+       * @param t_den the denominator of t.
+       *
+       * Sets &mu; = @e mu_num / @e mu_den and t = @e t_num / @e t_den.
+       */
+      explicit param_type(int mu_num, int mu_den, int t_num, int t_den)
+        : discrete_laplace_dist<rand_digit<_base>>::param_type
+        (mu_num, mu_den, t_num, t_den) {}
+    };
+
+    /**
+     * Construct with integer parameters.
+     *
+     * @param mu the value of &mu; (default 0).
+     * @param t the value of t (default 1).
+     *
+     * Sets &mu; = @e mu and t = @e t.
+     */
+    explicit discrete_laplace_distribution(int mu = 0, int t = 1)
+      : _param(mu, t), _laplace_dist(_D, _param) {}
+
+    /**
+     * Construct from the individual parameters.
+     *
+     * @param mu_num the numerator of &mu;.
+     * @param mu_den the denominator of &mu;.
+     * @param t_num the numerator of t.
+     * @param t_den the denominator of t.
+     *
+     * Sets &mu; = @e mu_num / @e mu_den and t = @e t_num / @e t_den.
+     */
+    explicit
+    discrete_laplace_distribution(int mu_num, int mu_den, int t_num, int t_den)
+      : _param(mu_num, mu_den, t_num, t_den), _laplace_dist(_D, _param) {}
+
+    /**
+     * Construct from a param_type.
+     *
+     * @param p
+     */
+    explicit discrete_laplace_distribution(const param_type& p)
+      : _param(p), _laplace_dist(_D, _param) {}
+
+    /**
+     * The copy constructor.
+     *
+     * @param d the distribution to copy.
+     *
+     * The copy has its own digit generator; so copies can be used
+     * independently, e.g., in different threads.
+     */
+    discrete_laplace_distribution(const discrete_laplace_distribution& d)
+      : _param(d._param), _D(d._D), _laplace_dist(_D, _param) {}
+
+    /**
+     * The copy assignment operator.
+     *
+     * @param d the distribution to copy.
+     * @return *this.
+     */
+    discrete_laplace_distribution&
+    operator=(const discrete_laplace_distribution& d) {
+      _param = d._param; _D = d._D; _laplace_dist.init(_param);
+      return *this;
+    }
+
+    /**
+     * Resets the distribution state.
+     */
+    void reset() {}
+
+    /**
+     * @return the numerator of &mu;.
+     */
+    result_type mu_num() const { return _param.mu_num(); }
+    /**
+     * @return the denominator of &mu;.
+     */
+    result_type mu_den() const { return _param.mu_den(); }
+    /**
+     * @return the numerator of t.
+     */
+    result_type t_num() const { return _param.t_num(); }
+    /**
+     * @return the denominator of t.
+     */
+    result_type t_den() const { return _param.t_den(); }
+
+    /**
+     * @return the parameter set of the distribution.
+     */
+    param_type param() const { return _param; }
+
+    /**
+     * Sets the parameter set of the distribution.
+     * @param param The new parameter set of the distribution.
+     */
+    void param(const param_type& param)
+    { _param = param; _laplace_dist.init(_param); }
+
+    /**
+     * @return the greatest lower bound value of the distribution.
+     */
+    result_type min() const
+    { return std::numeric_limits<result_type>::min(); }
+
+    /**
+     * @return the least upper bound value of the distribution.
+     */
+    result_type max() const
+    { return std::numeric_limits<result_type>::max(); }
+
+    /**
+     * @tparam Generator the type of g.
+     * @param g the random generator engine.
+     * @return a discrete Laplace deviate.
+     */
+    template<typename Generator>
+    result_type operator()(Generator& g)
+    { return _laplace_dist(g); }
+
+    /**
+     * @tparam Generator the type of g.
+     * @param g the random generator engine.
+     * @param p a parameter set.
+     * @return a discrete Laplace deviate using the specified parameters.
+     */
+    template<typename Generator>
+    result_type operator()(Generator& g, const param_type& p)
+    { return _laplace_dist(g, p); }
+
+    /**
+     * Fill a range with discrete Laplace deviates.
+     *
+     * @tparam ForwardIt the type of the iterators.
+     * @tparam Generator the type of g.
+     * @param first the beginning of the range.
+     * @param last the end of the range.
+     * @param g the random generator engine.
+     *
+     * This is equivalent to assigning operator()(g) to each element of the
+     * range in turn; so the results are the same as filling the range one
+     * deviate at a time.  However, this avoids the overhead of a separate call
+     * for each deviate.
+     */
+    template<typename ForwardIt, typename Generator>
+    void generate(ForwardIt first, ForwardIt last, Generator& g)
+    { for (; first != last; ++first) *first = _laplace_dist(g); }
+
+    /**
+     * Fill an array with discrete Laplace deviates.
+     *
+     * @tparam Generator the type of g.
+     * @param p a pointer to the first element of the array.
+     * @param n the number of elements of the array.
+     * @param g the random generator engine.
+     */
+    template<typename Generator>
+    void generate(result_type* p, size_t n, Generator& g)
+    { _laplace_dist.generate(g, p, n); }
+
+  /**
+   * @return true if two discrete Laplace distributions have the same
+   *   parameters.
+   */
+  friend bool
+  operator==(const discrete_laplace_distribution& d1,
+             const discrete_laplace_distribution& d2)
+  { return d1.param() == d2.param(); }
+
+  /**
+   * @return false if two discrete Laplace distributions have the same
+   *   parameters.
+   */
+  friend bool
+  operator!=(const discrete_laplace_distribution& d1,
+             const discrete_laplace_distribution& d2)
+  { return !(d1 == d2); }
+
+  /**
+   * Inserts a discrete_laplace_distribution random number distribution
+   * @e x into the output stream @e os.
+   *
+   * @param os an output stream.
+   * @param x a discrete_laplace_distribution random number distribution.
+   * @return os.
+   */
+  friend std::ostream&
+  operator<<(std::ostream& os, const discrete_laplace_distribution& x)
+  { os << x.param(); return os; }
+
+  /**
+   * Extracts a discrete_laplace_distribution random number distribution
+   * @e x from the input stream @e is.
+   *
+   * @param is an input stream.
+   * @param x a discrete_laplace_distribution random number generator engine.
+   * @return is.
+   */
+  friend std::istream&
+  operator>>(std::istream& is, discrete_laplace_distribution& x) {
+    discrete_laplace_distribution::param_type p;
+    is >> p;
+    x.param(p);
+    return is;
+  }
+
+  private:
+    param_type _param;
+    rand_digit<_base> _D;
+    discrete_laplace_dist<rand_digit<_base>> _laplace_dist;
+  };
+
+}
+
+#endif  // EXRANDOM_DISCRETE_LAPLACE_DISTRIBUTION_HPP
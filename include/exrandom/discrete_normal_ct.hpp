@@ -0,0 +1,237 @@
+/**
+ * @file discrete_normal_ct.hpp
+ * @author Charles Karney <charles.karney@sri.com>
+ * @brief Definition of discrete_normal_ct
+ *
+ * Copyright (c) Charles Karney (2016) and licensed under the MIT/X11 License.
+ * For more information, see http://exrandom.sourceforge.net/
+ */
+
+#if !defined(EXRANDOM_DISCRETE_NORMAL_CT_HPP)
+#define EXRANDOM_DISCRETE_NORMAL_CT_HPP 1
+
+#include <vector>               // for the table
+#include <cmath>                // for std::floor, std::ceil
+#include <cstdint>              // for uint64_t
+#include <cstddef>              // for size_t
+#include <limits>
+#include <stdexcept>            // for std::runtime_error
+
+#include <exrandom/discrete_normal_dist.hpp>
+#include <exrandom/fixed_point.hpp>
+
+namespace exrandom {
+
+  /**
+   * @brief Sample from the discrete normal distribution in constant time.
+   *
+   * @tparam digit_gen the type of digit generator; the base must be a power
+   *   of two no more than 2<sup>24</sup> (as required by
+   *   discrete_normal_dist).
+   *
+   * This samples the discrete normal distribution P<sub>i</sub> &prop;
+   * exp[&minus; ((i &minus; &mu;)/&sigma;)<sup>2</sup>/2] for applications,
+   * such as lattice cryptography, where the time taken and the number of
+   * random digits used must not depend on the result.  The constructor
+   * tabulates the cumulative distribution for i in [&mu; &minus; 10&sigma;,
+   * &mu; + 10&sigma;] as 64-bit fixed point numbers (computed with
+   * rigorous fixed point arithmetic).  Each sample then uses exactly
+   * discrete_normal_ct::digits digits (64 bits) to form a uniform deviate
+   * and compares it with every entry of the table without branches.
+   *
+   * &sigma; must lie in [1/256, 3000] (approximately).
+   *
+   * Unlike discrete_normal_dist, this is @e not exact: the distribution
+   * differs from the discrete normal distribution by a statistical
+   * distance of about size() &times; 2<sup>&minus;64</sup>.  The time per
+   * sample is proportional to size(), about 20&sigma;.  The time is
+   * independent of the result provided that the digit generator takes a
+   * constant time per digit, e.g., rand_digit or buffered_rand_digit with a
+   * power-of-two base and std::mt19937, std::mt19937_64, or philox_engine as
+   * the engine.  (This
+   * is a best-effort measure; compilers are free to introduce branches.)
+   *
+   * Use generate() to sample in batches; this draws the digits for the batch
+   * with a single call to digit_gen::generate.
+   */
+  template<typename digit_gen> class discrete_normal_ct {
+  public:
+    /**
+     * The type of the parameters, the same as for discrete_normal_dist.
+     */
+    typedef typename discrete_normal_dist<digit_gen>::param_type param_type;
+    /**
+     * The number of digits used for each sample
+     */
+    static const int digits = (64 + digit_gen::bits - 1) / digit_gen::bits;
+    /**
+     * The largest allowed size of the table (allowing &sigma; up to about
+     * 3000).
+     */
+    static const size_t max_size = size_t(1) << 16;
+    /**
+     * Construct from a param_type.
+     *
+     * @param D a reference to the digit generator to be used.
+     * @param p the param_type (default &mu; = 0 and &sigma; = 1).
+     * @exception std::runtime_error if &sigma; is too small or too large or
+     *   the range of results overflows an int.
+     */
+    explicit discrete_normal_ct(digit_gen& D,
+                                const param_type& p = param_type())
+      : _D(D), _param(p) { init(); }
+    /**
+     * Construct from the individual parameters.
+     *
+     * @param D a reference to the digit generator to be used.
+     * @param mu_num the numerator of &mu;.
+     * @param mu_den the denominator of &mu;.
+     * @param sigma_num the numerator of &sigma;.
+     * @param sigma_den the denominator of &sigma;.
+     * @exception std::runtime_error if &sigma; is too small or too large or
+     *   the range of results overflows an int.
+     *
+     * Sets &mu; = @e mu_num / @e mu_den and &sigma; = @e sigma_num / @e
+     * sigma_den.
+     */
+    discrete_normal_ct(digit_gen& D, int mu_num, int mu_den,
+                       int sigma_num, int sigma_den)
+      : _D(D), _param(mu_num, mu_den, sigma_num, sigma_den) { init(); }
+    /**
+     * Return a deviate.
+     *
+     * @tparam Generator the type of g.
+     * @param g the random generator engine.
+     * @return the random deviate.
+     */
+    template<typename Generator>
+    int operator()(Generator& g) {
+      uint_t d[digits];
+      _D.generate(g, d, digits);
+      return lookup(d);
+    }
+    /**
+     * Fill an array with deviates.
+     *
+     * @tparam Generator the type of g.
+     * @param g the random generator engine.
+     * @param p a pointer to the first element of the array.
+     * @param n the number of elements of the array.
+     *
+     * The results are the same as filling the array one deviate at a time.
+     */
+    template<typename Generator>
+    void generate(Generator& g, int* p, size_t n) {
+      _buf.resize(n * digits);
+      if (n) _D.generate(g, &_buf[0], n * digits);
+      for (size_t k = 0; k < n; ++k) p[k] = lookup(&_buf[k * digits]);
+    }
+    /**
+     * @return the smallest result.
+     */
+    int min() const { return _ilo; }
+    /**
+     * @return the largest result.
+     */
+    int max() const { return _ilo + int(_t.size()); }
+    /**
+     * @return the number of entries in the table, max() &minus; min() + 1.
+     */
+    size_t size() const { return _t.size() + 1; }
+    /**
+     * @return the memory used by the table in bytes.
+     */
+    size_t table_bytes() const { return _t.size() * sizeof(std::uint64_t); }
+    /**
+     * @return the parameters.
+     */
+    const param_type& param() const { return _param; }
+    /**
+     * @return a reference to the digit generator used in the constructor.
+     */
+    digit_gen& digit_generator() const { return _D; }
+  private:
+    static const int bits = digit_gen::bits;
+    static_assert(digit_gen::power_of_two,
+                  "discrete_normal_ct: base must be a power of two");
+    typedef fixed_point F;
+    typedef F::number fixed;
+    // Disable copy assignment
+    discrete_normal_ct& operator=(const discrete_normal_ct&);
+    digit_gen& _D;
+    param_type _param;
+    int _ilo;
+    // _t[k] = floor(2^64 * P(result <= _ilo + k))
+    std::vector<std::uint64_t> _t;
+    std::vector<uint_t> _buf;   // the digits for generate
+    // The result for 64 bits given by the digits d, using the top bits of
+    // the last digit
+    int lookup(const uint_t* d) const {
+      const int r = 64 - (digits - 1) * bits;
+      std::uint64_t u = 0;
+      for (int k = 0; k < digits - 1; ++k) u = (u << bits) | d[k];
+      u = (u << r) | (std::uint64_t(d[digits - 1]) >> (bits - r));
+      int n = 0;
+      for (size_t k = 0; k < _t.size(); ++k) {
+        // 1 if u < _t[k] without a branch
+        std::uint64_t t = _t[k],
+          lt = (u ^ ((u ^ t) | ((u - t) ^ t))) >> 63;
+        n += int(1U - lt);
+      }
+      return _ilo + n;
+    }
+    // floor(2^64 * r/s) for r < s, where 2s < 2^32
+    static std::uint64_t frac64(fixed r, const fixed& s) {
+      if (!F::less(r, s)) return ~std::uint64_t(0);
+      std::uint64_t q = 0;
+      for (int k = 0; k < 64; ++k) {
+        F::add(r, r); q <<= 1;
+        if (!F::less(r, s)) { F::sub(r, s); q |= 1U; }
+      }
+      return q;
+    }
+    void init() {
+      const size_t w = 3;
+      const int mn = _param.mu_num(), md = _param.mu_den(),
+        sn = _param.sigma_num(), sd = _param.sigma_den();
+      double mu = double(mn) / md, sigma = double(sn) / sd,
+        lo = std::floor(mu - 10 * sigma), hi = std::ceil(mu + 10 * sigma);
+      if (!(sigma >= 1/256.0))
+        throw std::runtime_error("discrete_normal_ct: sigma too small");
+      if (!(hi - lo < double(max_size)))
+        throw std::runtime_error("discrete_normal_ct: sigma too large");
+      if (!(lo >= std::numeric_limits<int>::min() &&
+            hi <= std::numeric_limits<int>::max()))
+        throw std::runtime_error("discrete_normal_ct: overflow");
+      _ilo = int(lo);
+      size_t n = size_t(hi - lo) + 1;
+      // i0 = floor(mu + 1/2) minimizes |i - mu|; the weights are w_i =
+      // exp(-z_i), where z_i = ((i - mu)^2 - (i0 - mu)^2) / (2 sigma^2) =
+      // |i - i0| * (|(i + i0) * md - 2 * mn| / md) * (sd/sn)^2 / 2.
+      long long num = 2LL * mn + md, den = 2LL * md, i0 = num / den;
+      if (i0 * den > num) --i0;
+      fixed rsig = F::quotient(std::uint64_t(sd), std::uint64_t(sn), w, true),
+        sum(w + 1, 0U), lower, upper;
+      rsig = F::mul(rsig, rsig, true);
+      F::div(rsig, 2U, true);
+      std::vector<fixed> cum(n);
+      for (size_t k = 0; k < n; ++k) {
+        long long i = _ilo + (long long)(k), a = (i + i0) * md - 2LL * mn;
+        fixed m(w + 1, 0U);
+        m[0] = std::uint32_t(i < i0 ? i0 - i : i - i0);
+        fixed z = F::mul(F::mul(m, F::quotient(std::uint64_t(a < 0 ? -a : a),
+                                               std::uint64_t(md), w, true),
+                                true), rsig, true);
+        // Lower bounds on the cumulative sums of w_i
+        F::expneg(z, lower, upper);
+        F::add(sum, lower);
+        cum[k] = sum;
+      }
+      _t.resize(n - 1);
+      for (size_t k = 0; k + 1 < n; ++k) _t[k] = frac64(cum[k], sum);
+    }
+  };
+
+}
+
+#endif  // EXRANDOM_DISCRETE_NORMAL_CT_HPP
@@ -14,9 +14,23 @@
 #include <cstdlib>              // for std::abs
 #include <stdexcept>            // for std::runtime_error
 #include <iostream>             // for std::ostream, etc.
+#include <memory>               // for std::shared_ptr
+#include <cmath>                // for std::frexp, std::ldexp
+#include <limits>
 
 #include <exrandom/i_rand.hpp>
 #include <exrandom/u_rand.hpp>
+#include <exrandom/u_rand_workspace.hpp>
+#include <exrandom/normal_k_table.hpp>
+#include <exrandom/discrete_normal_table.hpp>
+#include <exrandom/sample_stats.hpp>
+#include <exrandom/bernoulli.hpp>
+
+#if defined(_MSC_VER)
+// Squelch warnings about constant conditional expressions
+#  pragma warning (push)
+#  pragma warning (disable: 4127)
+#endif
 
 namespace exrandom {
 
@@ -28,6 +42,12 @@ namespace exrandom {
    * Algorithm D.
    *
    * @tparam digit_gen the type of digit generator.
+   * @tparam tabulated if true carry out steps 1 and 2 with normal_k_table
+   *   (default false).
+   * @tparam stats the statistics policy, no_stats (the default) or
+   *   sample_stats.
+   * @tparam int_type the type of the parameters and the results, int (the
+   *   default) or long long.
    *
    * This class allows a i_rand to be returned via the
    * discrete_normal_dist::generate member function or an int
@@ -38,8 +58,40 @@ namespace exrandom {
    * this class.)
    *
    * digit_gen::base must be less than 2<sup>24</sup>.
+   *
+   * Setting @e tabulated = true gives the same distribution of results,
+   * but it is faster because steps 1 and 2 are usually accomplished by
+   * generating a single digit.  (The default is false so that the results
+   * with a given seed are unchanged.)
+   *
+   * With @e stats = sample_stats, the use of digits by the various steps of
+   * the algorithm and the rejections at steps 2, 3, and 4 are recorded;
+   * these are available via statistics().
+   *
+   * If the base is a power of two and &sigma; is small (so that
+   * discrete_normal_table::suitable is true), Algorithm D is replaced by
+   * sampling exactly with a discrete_normal_table, which is built when
+   * the prepared_param is constructed.  (Sampling with a param_type, via
+   * operator()(g, p), uses Algorithm D and doesn't build a table; so, for
+   * small &sigma;, reuse a prepared_param.)  The memory used is given by
+   * prepared_param::table_bytes().  With sample_stats, the digits used to
+   * select a candidate are attributed to sample_stage::G, those used to
+   * accept it to sample_stage::B, and rejections to step 4.
+   *
+   * With @e int_type = int, &sigma; is limited to about 4 &times;
+   * 10<sup>7</sup> (because results up to 51&sigma; must be representable
+   * as an int).  Use @e int_type = long long for larger &sigma;; this samples
+   * with an i_rand<digit_gen, long long> and allows &sigma; up to about
+   * 2<sup>63</sup>/(51 base), e.g., 2<sup>40</sup> with base =
+   * 2<sup>16</sup>.  The i_rand does its arithmetic with long long (and
+   * not with a 128-bit type) whenever the parameters allow, so the cost of
+   * using long long is small; however, the default remains int.
    */
-  template<typename digit_gen> class discrete_normal_dist {
+  template<typename digit_gen, bool tabulated = false,
+           typename stats = no_stats, typename int_type = int>
+  class discrete_normal_dist {
+  private:
+    typedef typename i_rand_wide<int_type>::type wide;
   public:
     /**
      * @brief Hold the parameters of discrete_normal_dist.
@@ -56,8 +108,8 @@ namespace exrandom {
        * Sets &mu; = @e mu_num / @e mu_den and &sigma; = @e sigma_num
        * / @e sigma_den.
        */
-      explicit param_type(int mu_num, int mu_den,
-                          int sigma_num, int sigma_den)
+      explicit param_type(int_type mu_num, int_type mu_den,
+                          int_type sigma_num, int_type sigma_den)
       { param_init(mu_num, mu_den, sigma_num, sigma_den); }
 
       /**
@@ -76,7 +128,7 @@ namespace exrandom {
        *
        * Sets &mu; = @e mu and &sigma; = @e sigma.
        */
-      explicit param_type(int mu, int sigma)
+      explicit param_type(int_type mu, int_type sigma)
       { param_init(mu, 1, sigma, 1); }
 
       /**
@@ -88,25 +140,80 @@ namespace exrandom {
        *
        * Sets &mu; = @e mu_num / @e den and &sigma; = @e sigma_num / @e den.
        */
-      param_type(int mu_num, int sigma_num, int den)
+      param_type(int_type mu_num, int_type sigma_num, int_type den)
       { param_init(mu_num, den, sigma_num, den); }
 
+      /**
+       * Construct with parameters given as doubles.
+       *
+       * @param mu the value of &mu;.
+       * @param sigma the value of &sigma;.
+       * @exception std::runtime_error if @e mu or @e sigma is not
+       *   representable as a ratio of int_types, see dyadic(x, num, den).
+       * @return the param_type with &mu; = @e mu and &sigma; = @e sigma
+       *   exactly.
+       */
+      static param_type dyadic(double mu, double sigma) {
+        int_type mu_num, mu_den, sigma_num, sigma_den;
+        dyadic(mu, mu_num, mu_den);
+        dyadic(sigma, sigma_num, sigma_den);
+        return param_type(mu_num, mu_den, sigma_num, sigma_den);
+      }
+
+      /**
+       * Express a double exactly as a ratio with a power of two denominator.
+       *
+       * @param x the double.
+       * @param[out] num the numerator.
+       * @param[out] den the denominator, a power of two.
+       * @exception std::runtime_error if @e x is not finite or if @e num or
+       *   @e den would overflow an int_type.
+       *
+       * The ratio is in lowest terms.  With @e int_type = int, this requires
+       * that x &times; 2<sup>30</sup> be an integer less than
+       * 2<sup>31</sup> in magnitude; use @e int_type = long long for values
+       * with more bits.
+       */
+      static void dyadic(double x, int_type& num, int_type& den) {
+        const int digits = std::numeric_limits<int_type>::digits;
+        if (!(std::abs(x) <= (std::numeric_limits<double>::max)()))
+          throw std::runtime_error("discrete_normal_dist: non-finite value");
+        num = 0; den = 1;
+        if (x == 0) return;
+        int e;
+        // x = m * 2^e where m is an integer with |m| < 2^53
+        long long m = (long long)(std::ldexp(std::frexp(x, &e), 53));
+        e -= 53;
+        for (; e < 0 && m % 2 == 0; ++e) m /= 2;
+        long long am = m < 0 ? -m : m;
+        if (!(e < digits && -e < digits &&
+              am <= (long long)((std::numeric_limits<int_type>::max)()) >>
+              (e > 0 ? e : 0)))
+          throw std::runtime_error("discrete_normal_dist: "
+                                   "value not representable");
+        if (e >= 0)
+          num = int_type(m) * (int_type(1) << e);
+        else {
+          num = int_type(m); den = int_type(1) << -e;
+        }
+      }
+
       /**
        * @return the numerator of &mu;.
        */
-      int mu_num() const { return _mu_num; }
+      int_type mu_num() const { return _mu_num; }
       /**
        * @return the denominator of &mu;.
        */
-      int mu_den() const { return _mu_den; }
+      int_type mu_den() const { return _mu_den; }
       /**
        * @return the numerator of &sigma;.
        */
-      int sigma_num() const { return _sigma_num; }
+      int_type sigma_num() const { return _sigma_num; }
       /**
        * @return the denominator of &sigma;.
        */
-      int sigma_den() const { return _sigma_den; }
+      int_type sigma_den() const { return _sigma_den; }
 
       /**
        * Test for equality.
@@ -150,20 +257,20 @@ namespace exrandom {
       friend std::istream& operator>>(std::istream& is, param_type& x) {
         const auto flags = is.flags();
         is.flags(std::ios::dec | std::ios::skipws);
-        int mu_num, mu_den, sigma_num, sigma_den;
+        int_type mu_num, mu_den, sigma_num, sigma_den;
         if (is >> mu_num >> mu_den >> sigma_num >> sigma_den)
           x.param_init(mu_num, mu_den, sigma_num, sigma_den);
         is.flags(flags);
         return is;
       }
     private:
-      int _mu_num, _mu_den, _sigma_num, _sigma_den;
-      void param_init(int mu_num, int mu_den,
-                      int sigma_num, int sigma_den) {
+      int_type _mu_num, _mu_den, _sigma_num, _sigma_den;
+      void param_init(int_type mu_num, int_type mu_den,
+                      int_type sigma_num, int_type sigma_den) {
         if (!( sigma_num > 0 && sigma_den > 0 && mu_den > 0 &&
-               mu_num > std::numeric_limits<int>::min()))
+               mu_num > std::numeric_limits<int_type>::min()))
           throw std::runtime_error("discrete_normal_dist: need sigma > 0");
-        int l;
+        int_type l;
         l = gcd(mu_num, mu_den);
         _mu_num = mu_num/l; _mu_den = mu_den/l;
         l = gcd(sigma_num, sigma_den);
@@ -171,6 +278,135 @@ namespace exrandom {
       }
     };
 
+    /**
+     * @brief The parameters of discrete_normal_dist together with the integer
+     * quantities derived from them.
+     *
+     * Constructing a prepared_param does all the setup (the reduction of
+     * &mu; and &sigma; to a common denominator and the overflow checks)
+     * needed to sample with a given param_type.  A prepared_param is
+     * immutable and can be shared (e.g., between threads) by any number of
+     * discrete_normal_dist objects with the same digit_gen.  Sampling with
+     * discrete_normal_dist::operator()(g, p) then costs nothing extra
+     * compared to sampling with fixed parameters.  For small &sigma;, this
+     * also holds the discrete_normal_table (which is shared by copies of
+     * the prepared_param).
+     */
+    class prepared_param {
+    public:
+      /**
+       * The default constructor.
+       *
+       * Sets &mu; = 0 and &sigma;  = 1.
+       */
+      prepared_param() : _param() { init(true); }
+      /**
+       * Construct from a param_type.
+       *
+       * @param p the param_type.
+       *
+       * This throws an exception if the parameters might result in
+       * overflow.
+       */
+      explicit prepared_param(const param_type& p)
+        : _param(p) { init(true); }
+      /**
+       * @return the parameters.
+       */
+      const param_type& param() const { return _param; }
+      /**
+       * Test for equality.
+       *
+       * @param p1
+       * @param p2
+       * @return p1 == p2.
+       */
+      friend bool
+      operator==(const prepared_param& p1, const prepared_param& p2)
+      { return p1._param == p2._param; }
+      /**
+       * @return the memory used by the discrete_normal_table in bytes (0
+       *   if Algorithm D is used).
+       */
+      size_t table_bytes() const { return _table ? _table->bytes() : 0; }
+    private:
+      friend class discrete_normal_dist;
+      typedef discrete_normal_table<digit_gen::base> table;
+      param_type _param;
+      wide _sig, _mu, _d;       // sigma = _sig/_d, mu = _imu + _mu/_d
+      int_type _imu, _isig;     // _isig = ceil(sigma)
+      std::shared_ptr<const table> _table;
+      // The probability that k = kmax is about 10^-543.
+      static const int kmax = 50 + 1;
+      // Used by discrete_normal_dist for a varying mu: copy sigma from p, set
+      // mu = mu_num/mu_den, and don't build a table.  (_param retains the mu
+      // of p.)
+      prepared_param(const prepared_param& p, int_type mu_num,
+                     int_type mu_den)
+        : _param(p._param), _isig(p._isig) { set_mu(mu_num, mu_den); }
+      // Used by discrete_normal_dist::operator()(g, p) for a param_type:
+      // don't build a table.
+      prepared_param(const param_type& p, bool build)
+        : _param(p) { init(build); }
+      void init(bool build) {
+        const int_type maxint = std::numeric_limits<int_type>::max();
+        _isig = int_type(iceil(_param.sigma_num(), _param.sigma_den()));
+        // Check that max plausible result fits in an int_type
+        if (!(_isig <= maxint / kmax))
+          throw std::runtime_error("discrete_normal_dist: possible overflow a");
+        set_mu(_param.mu_num(), _param.mu_den());
+        _table.reset();
+        // The table represents results as ints
+        const wide maxsig = wide(1) << 32;
+        if (build && _sig < maxsig && _d < maxsig &&
+            table::suitable((long long)(_sig), (long long)(_d)) &&
+            std::abs((long long)(_imu)) <=
+            std::numeric_limits<int>::max() - (long long)(_isig) * kmax)
+          _table = std::make_shared<const table>(int(_imu),
+                                                 (long long)(_mu),
+                                                 (long long)(_d),
+                                                 (long long)(_sig));
+      }
+      // Set _imu, _sig, _mu, and _d given _param.sigma_*(), _isig, and mu =
+      // mu_num/mu_den.  This tests for possible overflow.
+      void set_mu(int_type mu_num, int_type mu_den) {
+        const wide maxw = i_rand_wide<int_type>::max();
+        const int_type maxint = std::numeric_limits<int_type>::max();
+        const int_type sn = _param.sigma_num(), sd = _param.sigma_den();
+        if (!(mu_den > 0 && mu_num > std::numeric_limits<int_type>::min()))
+          throw std::runtime_error("discrete_normal_dist: need mu_den > 0");
+        _imu = int_type(mu_num / mu_den);
+        int_type fmu_num = mu_num - _imu * mu_den;
+        wide l = gcd(sd, mu_den), afmu = fmu_num < 0 ? -fmu_num : fmu_num;
+        if (!( mu_den / l <= maxw / sn &&
+               afmu <= maxw / (sd / l) &&
+               mu_den / l <= maxw / sd ))
+          throw
+            std::runtime_error("discrete_normal_dist: sigma or mu overflow");
+        _sig = wide(sn) * (mu_den / l);
+        _mu = wide(fmu_num) * (sd / l);
+        _d  = wide(sd) * (mu_den / l);
+        // sigma = _sig / _d; _isig = ceil(sigma); check _isig * _d is
+        // representable as a wide (in i_rand.less_than)
+        if (!(_isig <= maxw / _d))
+          throw
+            std::runtime_error("discrete_normal_dist: sigma or mu overflow");
+        // The rest tests for possible overflow
+        if (!((_imu < 0 ? -_imu : _imu) <= maxint - _isig * kmax))
+          throw std::runtime_error("discrete_normal_dist: possible overflow b");
+        // Need to represent
+        //   _sig * kmax as wide -- xn0 = _sig * k ...)
+        //   base * 2 * kmax as long long -- in compare(g, 1, 2, m)
+        //   _sig * kmax * base as wide -- in less_than(g, z, ...)
+        //   _sig * base as wide -- in less_than(g, z, ...)
+        // Combine requirements as
+        //   max(2,_sig) * base * kmax
+        // This also covers _isig * base (in i_rand::init).
+        if (!((std::max)(wide(2), _sig) <= maxw / (b * kmax)))
+          throw std::runtime_error("discrete_normal_dist: possible overflow c");
+      }
+    };
+
     /**
      * The default constructor.
      *
@@ -179,8 +415,7 @@ namespace exrandom {
      * Sets &mu; = 0 and &sigma; = 1.
      */
     discrete_normal_dist(digit_gen& D)
-      : _D(D), _y(D), _z(D), _j(D), _param()
-    { init(); }
+      : _D(D), _y0(D), _z0(D), _y(_y0), _z(_z0), _j(D), _prep() {}
 
     /**
      * Construct from a param_type.
@@ -189,7 +424,54 @@ namespace exrandom {
      * @param p the param_type.
      */
     discrete_normal_dist(digit_gen& D, const param_type& p)
-      : _D(D), _y(D), _z(D), _j(D), _param(p) { init(); }
+      : _D(D), _y0(D), _z0(D), _y(_y0), _z(_z0), _j(D), _prep(p) {}
+
+    /**
+     * Construct from a prepared_param.
+     *
+     * @param D a reference to the digit generator to be used.
+     * @param p the prepared_param.
+     */
+    discrete_normal_dist(digit_gen& D, const prepared_param& p)
+      : _D(D), _y0(D), _z0(D), _y(_y0), _z(_z0), _j(D), _prep(p) {}
+
+    /**
+     * Construct using the temporary storage of a u_rand_workspace.
+     *
+     * @param w the workspace; its digit generator is used.
+     * @param p the prepared_param (default &mu; = 0 and &sigma; = 1).
+     * @param first the first of the 2 slots of @e w to use (default 0).
+     */
+    explicit discrete_normal_dist(u_rand_workspace<digit_gen>& w,
+                                  const prepared_param& p = prepared_param(),
+                                  int first = 0)
+      : _D(w.digit_generator()), _y0(_D), _z0(_D)
+      , _y(w.slot(first)), _z(w.slot(first + 1)), _j(_D), _prep(p) {}
+
+    /**
+     * Construct from a param_type using the temporary storage of a
+     * u_rand_workspace.
+     *
+     * @param w the workspace; its digit generator is used.
+     * @param p the param_type.
+     * @param first the first of the 2 slots of @e w to use (default 0).
+     */
+    discrete_normal_dist(u_rand_workspace<digit_gen>& w, const param_type& p,
+                         int first = 0)
+      : _D(w.digit_generator()), _y0(_D), _z0(_D)
+      , _y(w.slot(first)), _z(w.slot(first + 1)), _j(_D), _prep(p) {}
+
+    /**
+     * The copy constructor.
+     *
+     * @param d the distribution to copy.
+     *
+     * The copy uses the same workspace as @e d (if any).
+     */
+    discrete_normal_dist(const discrete_normal_dist& d)
+      : _D(d._D), _y0(d._y0), _z0(d._z0)
+      , _y(d.owned() ? _y0 : d._y), _z(d.owned() ? _z0 : d._z)
+      , _j(d._j), _prep(d._prep), _stats(d._stats) {}
 
     /**
      * Construct with integer parameters.
@@ -200,9 +482,9 @@ namespace exrandom {
      *
      * Sets &mu; = @e mu and &sigma; = @e sigma.
      */
-    discrete_normal_dist(digit_gen& D, int mu, int sigma)
-      : _D(D), _y(D), _z(D), _j(D), _param(mu, sigma)
-    { init(); }
+    discrete_normal_dist(digit_gen& D, int_type mu, int_type sigma)
+      : _D(D), _y0(D), _z0(D), _y(_y0), _z(_z0), _j(D)
+      , _prep(param_type(mu, sigma)) {}
 
     /**
      * Construct with parameters with a common denominator.
@@ -214,9 +496,10 @@ namespace exrandom {
      *
      * Sets &mu; = @e mu_num / @e den and &sigma; = @e sigma_num / @e den.
      */
-    discrete_normal_dist(digit_gen& D, int mu_num, int sigma_num, int den)
-      : _D(D), _y(D), _z(D), _j(D), _param(mu_num, den, sigma_num, den)
-    { init(); }
+    discrete_normal_dist(digit_gen& D, int_type mu_num, int_type sigma_num,
+                         int_type den)
+      : _D(D), _y0(D), _z0(D), _y(_y0), _z(_z0), _j(D)
+      , _prep(param_type(mu_num, den, sigma_num, den)) {}
 
     /**
      * Construct from the individual parameters.
@@ -231,27 +514,27 @@ namespace exrandom {
      * sigma_den.
      */
     discrete_normal_dist(digit_gen& D,
-                    int mu_num, int mu_den,
-                    int sigma_num, int sigma_den)
-      : _D(D), _y(D), _z(D), _j(D), _param(mu_num, mu_den, sigma_num, sigma_den)
-    { init(); }
+                    int_type mu_num, int_type mu_den,
+                    int_type sigma_num, int_type sigma_den)
+      : _D(D), _y0(D), _z0(D), _y(_y0), _z(_z0), _j(D)
+      , _prep(param_type(mu_num, mu_den, sigma_num, sigma_den)) {}
 
     /**
      * @return the numerator of &mu;.
      */
-    int mu_num() const { return _param.mu_num(); }
+    int_type mu_num() const { return _prep.param().mu_num(); }
     /**
      * @return the denominator of &mu;.
      */
-    int mu_den() const { return _param.mu_den(); }
+    int_type mu_den() const { return _prep.param().mu_den(); }
     /**
      * @return the numerator of &sigma;.
      */
-    int sigma_num() const { return _param.sigma_num(); }
+    int_type sigma_num() const { return _prep.param().sigma_num(); }
     /**
      * @return the denominator of &sigma;.
      */
-    int sigma_den() const { return _param.sigma_den(); }
+    int_type sigma_den() const { return _prep.param().sigma_den(); }
 
     /**
      * Return a deviate as a i_rand.
@@ -261,14 +544,38 @@ namespace exrandom {
      * @param j the i_rand to set.
      */
     template<typename Generator>
-    void generate(Generator& g, i_rand<digit_gen>& j) {
+    void generate(Generator& g, i_rand<digit_gen, int_type>& j)
+    { generate(g, j, _prep); }
+
+    /**
+     * Return a deviate as a i_rand using the specified parameters.
+     *
+     * @tparam Generator the type of g.
+     * @param g the random generator engine.
+     * @param j the i_rand to set.
+     * @param p the prepared parameters.
+     */
+    template<typename Generator>
+    void generate(Generator& g, i_rand<digit_gen, int_type>& j,
+                  const prepared_param& p) {
+      long long c = _stats.start(_D);
+      if (p._table) {           // small sigma
+        for (;;) {
+          int tail, i = p._table->propose(g, j, _y, tail);
+          _stats.tally(sample_stage::G, _D, c);
+          bool accept = p._table->accept(g, i, tail, _z);
+          _stats.tally(sample_stage::B, _D, c);
+          if (!accept) { _stats.reject(4); continue; }
+          j.init(g, 1).add(i);
+          _stats.sample();
+          return;
+        }
+      }
       for (;;) {
-        int k = G(g);           // step 1
-        // There's addtional scope for optimization if sigma is small, since
-        // some values of k never yield an allowed result and be can bail out
-        // now.  However, small sigma is not a very likely limit, so we don't
-        // muck up the code to treat this case specially.
-        if (!P(g, k * (k - 1))) continue; // step 2
+        int k = GP(g, c);       // steps 1 and 2
+        // Small sigma is treated above with a discrete_normal_table (if the
+        // base is a power of two).
+        if (k < 0) { _stats.reject(2); continue; }
         // Explanation of Steps 3 & 5.  The scheme for unit_normal samples k,
         // samples x in [0,1], and (unless rejected) returns s*(k+x).  For the
         // discrete case, we sample x in [0,1) such that s*(k+x) = (i-mu)/sigma
@@ -291,20 +598,24 @@ namespace exrandom {
         //     = x0 + j/sigma
         //   x0 = (ceil(sigma*k + s*mu) - (sigma*k + s*mu))/sigma
         int s = j.init(g,2)(g) ? -1 : 1; // step 6
-        long long xn0 = _sig * k + s * _mu;
-        int i0 = int(iceil(xn0, _d)); // step 5
-        xn0 = i0 * _d - xn0;          // step 3, xn = xn0 + j * _d
-        j.init(g, _isig);             // i = s * (i0 + j)
+        _stats.tally(sample_stage::sign, _D, c);
+        wide xn0 = p._sig * k + s * p._mu;
+        int_type i0 = int_type(iceil(xn0, p._d)); // step 5
+        xn0 = wide(i0) * p._d - xn0;    // step 3, xn = xn0 + j * _d
+        j.init(g, p._isig);             // i = s * (i0 + j)
         // If sigma is not an integer, this may result (with j = _isig-1) in x
         // >= 1.  Reject such samples.  Reject also the case s = -1, k = 0, and
         // x == 0 (since this is treated by the case s = 1, k = 0, x = 0).
-        if (!j.less_than(g, _sig - xn0, _d) ||
-            (k == 0 && s < 0 && !j.greater_than(g, -xn0, _d)))
-          continue;
-        int h = k + 1; while (h-- && B(g, k, xn0, j)) {}; // step 4
-        if (!(h < 0)) continue;
-        j.add(i0 + s*_imu);     // step 5
+        bool reject = !j.less_than(g, p._sig - xn0, p._d) ||
+          (k == 0 && s < 0 && !j.greater_than(g, -xn0, p._d));
+        _stats.tally(sample_stage::X, _D, c);
+        if (reject) { _stats.reject(3); continue; }
+        int h = k + 1; while (h-- && B(g, k, xn0, j, p)) {}; // step 4
+        _stats.tally(sample_stage::B, _D, c);
+        if (!(h < 0)) { _stats.reject(4); continue; }
+        j.add(i0 + s*p._imu);   // step 5
         if (s < 0) j.negate();  // step 6
+        _stats.sample();
         return;                 // step 7
       }
     }
@@ -317,10 +628,100 @@ namespace exrandom {
      * @return the random deviate.
      */
     template<typename Generator>
-    int operator()(Generator& g) {
+    int_type operator()(Generator& g) {
       generate(g, _j);
-      return _j(g);
+      return round(g);
+    }
+    /**
+     * Return a deviate using the specified parameters.
+     *
+     * @tparam Generator the type of g.
+     * @param g the random generator engine.
+     * @param p the parameters.
+     * @exception std::runtime_error if the parameters might result in
+     *   overflow.
+     * @return the random deviate.
+     *
+     * This does the setup of a prepared_param for each call, but without
+     * building a discrete_normal_table, so Algorithm D is always used.  The
+     * parameters of *this are not changed.
+     */
+    template<typename Generator>
+    int_type operator()(Generator& g, const param_type& p) {
+      generate(g, _j, prepared_param(p, false));
+      return round(g);
+    }
+    /**
+     * Return a deviate using the specified parameters.
+     *
+     * @tparam Generator the type of g.
+     * @param g the random generator engine.
+     * @param p the prepared parameters.
+     * @return the random deviate.
+     *
+     * The parameters of *this are not changed.
+     */
+    template<typename Generator>
+    int_type operator()(Generator& g, const prepared_param& p) {
+      generate(g, _j, p);
+      return round(g);
+    }
+    /**
+     * Return a deviate with a given &mu; and the &sigma; of a
+     * prepared_param.
+     *
+     * @tparam Generator the type of g.
+     * @param g the random generator engine.
+     * @param p the prepared parameters (only &sigma; is used).
+     * @param mu_num the numerator of &mu;.
+     * @param mu_den the denominator of &mu; (which need not be in lowest
+     *   terms).
+     * @exception std::runtime_error if @e mu_den &le; 0 or if the
+     *   parameters might result in overflow.
+     * @return the random deviate.
+     *
+     * This is for applications, such as convolution samplers, where &mu;
+     * changes with each sample and &sigma; is fixed.  The sigma-dependent
+     * state in @e p is reused and the only setup is a few integer
+     * operations to combine &mu; with &sigma;; in particular, no
+     * prepared_param or discrete_normal_table is constructed, so Algorithm D
+     * is always used.  The parameters of *this are not changed.
+     */
+    template<typename Generator>
+    int_type operator()(Generator& g, const prepared_param& p,
+                        int_type mu_num, int_type mu_den) {
+      generate(g, _j, prepared_param(p, mu_num, mu_den));
+      return round(g);
+    }
+    /**
+     * Return a deviate with a given &mu; (as a double) and the &sigma; of a
+     * prepared_param.
+     *
+     * @tparam Generator the type of g.
+     * @param g the random generator engine.
+     * @param p the prepared parameters (only &sigma; is used).
+     * @param mu the value of &mu;; this is converted exactly with
+     *   param_type::dyadic(mu, num, den).
+     * @exception std::runtime_error if @e mu is not representable or if the
+     *   parameters might result in overflow.
+     * @return the random deviate.
+     */
+    template<typename Generator>
+    int_type operator()(Generator& g, const prepared_param& p, double mu) {
+      int_type mu_num, mu_den;
+      param_type::dyadic(mu, mu_num, mu_den);
+      return operator()(g, p, mu_num, mu_den);
     }
+    /**
+     * @return the statistics collected (only useful with @e stats =
+     *   sample_stats).
+     */
+    const stats& statistics() const { return _stats; }
+    /**
+     * @return the statistics collected (only useful with @e stats =
+     *   sample_stats); use this to reset the counters.
+     */
+    stats& statistics() { return _stats; }
     /**
      * @return a reference to the digit generator used in the constructor.
      */
@@ -328,13 +729,23 @@ namespace exrandom {
     /**
      * @return the parameters.
      */
-    const param_type& param() const { return _param; }
+    const param_type& param() const { return _prep.param(); }
+    /**
+     * @return the prepared parameters.
+     */
+    const prepared_param& prepared() const { return _prep; }
     /**
      * Set new parameters.
      *
      * @param param the new parameters.
      */
-    void init(const param_type& param) { _param = param; init(); }
+    void init(const param_type& param) { _prep = prepared_param(param); }
+    /**
+     * Set new prepared parameters.
+     *
+     * @param p the new parameters.
+     */
+    void init(const prepared_param& p) { _prep = p; }
   private:
     static const int b = digit_gen::base;
     // Allow base in [2,2^24].  Need digit to be representable as an int.  This
@@ -343,100 +754,108 @@ namespace exrandom {
     // Disable copy assignment
     discrete_normal_dist& operator=(const discrete_normal_dist&);
     digit_gen& _D;
-    u_rand<digit_gen> _y, _z; // temporary storage
-    i_rand<digit_gen> _j;     // temporary storage
-    param_type _param;
-    long long _sig, _mu, _d;    // sigma = _sig/_d, mu = _imu + _mu/_d
-    int _imu, _isig;            // _isig = ceil(sigma)
-    static long long iceil(long long n, long long d) // ceil(n/d) for d > 0
-    { long long k = n / d; return k + (k * d < n ? 1 : 0); }
+    u_rand<digit_gen> _y0, _z0; // own temporary storage
+    // The temporary storage, _y0, etc., or slots in a u_rand_workspace
+    u_rand<digit_gen> &_y, &_z;
+    i_rand<digit_gen, int_type> _j; // temporary storage
+    prepared_param _prep;
+    stats _stats;
+    bool owned() const { return &_y == &_y0; }
+    // Algorithm H (and steps N1 and N2)
+    typedef bernoulli_exp<digit_gen> H;
+    // Convert _j to an int_type
+    template<typename Generator>
+    int_type round(Generator& g) {
+      long long c = _stats.start(_D);
+      int_type i = _j(g);
+      _stats.tally(sample_stage::round, _D, c);
+      return i;
+    }
+    static wide iceil(wide n, wide d) // ceil(n/d) for d > 0
+    { wide k = n / d; return k + (k * d < n ? 1 : 0); }
     // Knuth, TAOCP, vol 2, 4.5.2, Algorithm A
-    static int gcd(int u, int v) {
-      u = std::abs(u); v = std::abs(v);
-      while (v > 0) { int r = u % v; u = v; v = r; }
+    static int_type gcd(int_type u, int_type v) {
+      u = u < 0 ? -u : u; v = v < 0 ? -v : v;
+      while (v > 0) { int_type r = u % v; u = v; v = r; }
       return u;
     }
-    /*    void init(int mu_num, int mu_den, int sigma_num, int sigma_den) {
-      _param = param_type(mu_num, mu_den, sigma_num, sigma_den);
-      init();
-    }
-    */
-    void init() {
-      const long long maxll = std::numeric_limits<long long>::max();
-      const int maxint = std::numeric_limits<int>::max();
-      _imu = int(_param.mu_num() / _param.mu_den());
-      int fmu_num = _param.mu_num() - _imu * _param.mu_den();
-      _isig = int(iceil(_param.sigma_num(), _param.sigma_den()));
-      long long l = gcd(_param.sigma_den(), _param.mu_den());
-      if (!( _param.mu_den() / l <= maxll / _param.sigma_num() &&
-             std::abs(fmu_num) <= maxll / (_param.sigma_den() / l) &&
-             _param.mu_den() / l <= maxll / _param.sigma_den() ))
-        throw std::runtime_error("discrete_normal_dist: sigma or mu overflow");
-      _sig = _param.sigma_num() * (_param.mu_den() / l);
-      _mu = fmu_num * (_param.sigma_den() / l);
-      _d  = _param.sigma_den() * (_param.mu_den() / l);
-      // sigma = _sig / _d; _isig = ceil(sigma); check _isig * _d is
-      // representable as a long long (in i_rand.less_than)
-      if (!(_isig <= maxll / _d))
-        throw std::runtime_error("discrete_normal_dist: sigma or mu overflow");
-      // The rest of the constructor tests for possible overflow
-      // The probability that k =  kmax is about 10^-543.
-      int kmax = 50 + 1;
-      // Check that max plausible result fits in an int
-      if (!(_isig <= maxint / kmax))
-        throw std::runtime_error("discrete_normal_dist: possible overflow a");
-      if (!(std::abs(_imu) <= maxint - _isig * kmax))
-        throw std::runtime_error("discrete_normal_dist: possible overflow b");
-      // Need to represent
-      //   _sig * kmax as long long -- xn0 = _sig * k ...)
-      //   base * 2 * kmax as long long -- in compare(g, 1, 2, m)
-      //   _isig * base as long long -- in i_rand::start
-      //   _sig * kmax * base as long long -- in u_rand::less_than
-      //   _sig * base as long long -- in u_rand::less_than
-      // Combine requirements as
-      //   max(2,_sig) * base * kmax
-      if (!((std::max)(2LL, _sig) <= maxll / (b * kmax)))
-        throw std::runtime_error("discrete_normal_dist: possible overflow c");
-    }
-    // Algorithm H: true with probability exp(-1/2).
+    // Steps N1 and N2: return k >= 0 with probability (1 - exp(-1/2)) *
+    // exp(-k^2/2), otherwise -1.  Digits are tallied using count c.
     template<typename Generator>
-    bool H(Generator& g) {
-      if (!_y.init().less_than_half(g)) return true;
-      for (;;) {
-        if (!_z.init().less_than(g, _y)) return false;
-        if (!_y.init().less_than(g, _z)) return true;
-      }
+    EXRANDOM_PROFILE_STEP
+    int GP(Generator& g, long long& c) {
+      typedef normal_k_table<digit_gen::base> table;
+      int k;
+      if (tabulated) {
+        k = table::standard()(g, _y);
+        if (k != table::K) {
+          _stats.tally(sample_stage::G, _D, c);
+          return k < table::K ? k : -1;
+        }
+        k += H::count_half(g, _y, _z); // k >= K
+      } else
+        k = H::count_half(g, _y, _z);
+      _stats.tally(sample_stage::G, _D, c);
+      bool accept = H::half_n(g, k * (k - 1), _y, _z);
+      _stats.tally(sample_stage::P, _D, c);
+      return accept ? k : -1;
     }
 
-    // Step N1: return n >= 0 with prob. exp(-n/2) * (1 - exp(-1/2)).
-    template<typename Generator>
-    int G(Generator& g)
-    { int n = 0; while (H(g)) ++n; return n; }
-
-    // Step N2: true with probability exp(-n/2).
-    template<typename Generator>
-    bool P(Generator& g, int n)
-    { while (n-- && H(g)) {}; return n < 0; }
-
     // Algorithm B: true with prob exp(-x * (2*k + x) / (2*k + 2)) where
     // x = (xn0 + _d * j) / _sig
     template<typename Generator>
-    bool B(Generator& g, int k, long long xn0,
-           i_rand<digit_gen>& j) {
+    EXRANDOM_PROFILE_STEP
+    bool B(Generator& g, int k, wide xn0,
+           i_rand<digit_gen, int_type>& j, const prepared_param& p) {
       int n = 0, m = 2 * k + 2, f;
       for (;; ++n) {
         f = k > 0 ? 0 : _z.init().compare(g, 1, 2, m); if (f < 0) break;
         _z.init();
-        if (!(n ? _z.less_than(g, _y) : _z.less_than(g, xn0, _d, _sig, j)))
+        if (!(n ? _z.less_than(g, _y) :
+              less_than(g, _z, xn0, p._d, p._sig, j)))
           break;
         f = k > 0 ? _y.init().compare(g, 1, 2, m) : f; if (f < 0) break;
-        if (f == 0 && (!_y.init().less_than(g, xn0, _d, _sig, j))) break;
+        if (f == 0 && (!less_than(g, _y.init(), xn0, p._d, p._sig, j)))
+          break;
         _y.swap(_z);            // an efficient way of doing y = z
       }
       return (n % 2) == 0;
     }
+
+    // The same as u_rand::less_than(g, u0, c, v, h) and u_rand::compare(g,
+    // u1, u2, v) for a newly initialized u_rand z, with the arithmetic
+    // carried out with wide.
+    template<typename Generator>
+    static bool less_than(Generator& g, u_rand<digit_gen>& z,
+                          wide u0, wide c, wide v,
+                          i_rand<digit_gen, int_type>& h) {
+      for (;;) {
+        int r = compare(g, z, u0 + h.min()*c, u0 + h.max()*c, v);
+        if (r < 0) return true;
+        if (r > 0) return false;
+        h.refine(g);
+      }
+    }
+    template<typename Generator>
+    static int compare(Generator& g, u_rand<digit_gen>& z,
+                       wide u1, wide u2, wide v) {
+      u1 = (std::max)(wide(0), u1);
+      u2 = (std::min)(v, u2);
+      for (size_t k = 0;; ++k) {
+        if (u1 >= v) return -1; // u1/v >= 1, so z < u1/v
+        if (u2 <= 0) return  1; // u2/v <= 0, so z > u2/v
+        if (u1 <= 0 && u2 >= v) return 0;
+        wide d = wide(z.digit(g, k));
+        u1 = (std::max)(wide(0), u1 * b - d * v);
+        u2 = (std::min)(v, u2 * b - d * v);
+      }
+    }
   };
 
 }
 
+#if defined(_MSC_VER)
+#  pragma warning (pop)
+#endif
+
 #endif  // EXRANDOM_DISCRETE_NORMAL_DIST_HPP
@@ -12,6 +12,7 @@
 
 #include <iostream>             // for std::ostream, etc.
 #include <limits>
+#include <cstddef>              // for size_t
 
 #include <exrandom/rand_digit.hpp>
 #include <exrandom/discrete_normal_dist.hpp>
@@ -93,6 +94,12 @@ namespace exrandom {
         : discrete_normal_dist<rand_digit<_base>>::param_type
         (mu_num, mu_den, sigma_num, sigma_den) {}
     };
+    /**
+     * The parameters together with the quantities derived from them; see
+     * discrete_normal_dist::prepared_param.
+     */
+    typedef discrete_normal_dist<rand_digit<_base>>::prepared_param
+    prepared_param;
 
     /**
      * The default constructor.
@@ -151,6 +158,31 @@ namespace exrandom {
       : _param(mu_num, mu_den, sigma_num, sigma_den)
       , _normal_dist(_D, _param) {}
 
+    /**
+     * The copy constructor.
+     *
+     * @param d the distribution to copy.
+     *
+     * The copy has its own digit generator; so copies can be used
+     * independently, e.g., in different threads.
+     */
+    discrete_normal_distribution(const discrete_normal_distribution& d)
+      : _param(d._param), _D(d._D), _normal_dist(_D, d._normal_dist.prepared())
+    {}
+
+    /**
+     * The copy assignment operator.
+     *
+     * @param d the distribution to copy.
+     * @return *this.
+     */
+    discrete_normal_distribution&
+    operator=(const discrete_normal_distribution& d) {
+      _param = d._param; _D = d._D;
+      _normal_dist.init(d._normal_dist.prepared());
+      return *this;
+    }
+
     /**
      * Resets the distribution state.
      */
@@ -185,6 +217,14 @@ namespace exrandom {
     void param(const param_type& param)
     { _param = param; _normal_dist.init(_param); }
 
+    /**
+     * @return the memory used by the table for sampling with small &sigma;
+     *   in bytes (0 if Algorithm D is used); see
+     *   discrete_normal_dist::prepared_param::table_bytes().
+     */
+    size_t table_bytes() const
+    { return _normal_dist.prepared().table_bytes(); }
+
     /**
      * @return the greatest lower bound value of the distribution.
      */
@@ -211,12 +251,59 @@ namespace exrandom {
      * @param g the random generator engine.
      * @param p a parameter set.
      * @return a discrete normal deviate using the specified parameters.
+     *
+     * This doesn't build a discrete_normal_table (see
+     * discrete_normal_dist::operator()(g, p)); so for small &sigma;, the
+     * sequence of results differs from that given with a prepared_param,
+     * although the distribution is the same.
      */
     template<typename Generator>
-    result_type operator()(Generator& g, const param_type& p) {
-      discrete_normal_dist<rand_digit<_base>> N(_D, p);
-      return N(g);
-    }
+    result_type operator()(Generator& g, const param_type& p)
+    { return _normal_dist(g, p); }
+
+    /**
+     * @tparam Generator the type of g.
+     * @param g the random generator engine.
+     * @param p a prepared parameter set.
+     * @return a discrete normal deviate using the specified parameters.
+     *
+     * Use this to switch between many parameter sets cheaply.  Create a
+     * prepared_param for each parameter set once; sampling with it then
+     * costs the same as sampling with the parameters of the distribution.
+     */
+    template<typename Generator>
+    result_type operator()(Generator& g, const prepared_param& p)
+    { return _normal_dist(g, p); }
+
+    /**
+     * Fill a range with discrete normal deviates.
+     *
+     * @tparam ForwardIt the type of the iterators.
+     * @tparam Generator the type of g.
+     * @param first the beginning of the range.
+     * @param last the end of the range.
+     * @param g the random generator engine.
+     *
+     * This is equivalent to assigning operator()(g) to each element of the
+     * range in turn; so the results are the same as filling the range one
+     * deviate at a time.  However, this avoids the overhead of a separate call
+     * for each deviate.
+     */
+    template<typename ForwardIt, typename Generator>
+    void generate(ForwardIt first, ForwardIt last, Generator& g)
+    { for (; first != last; ++first) *first = _normal_dist(g); }
+
+    /**
+     * Fill an array with discrete normal deviates.
+     *
+     * @tparam Generator the type of g.
+     * @param p a pointer to the first element of the array.
+     * @param n the number of elements of the array.
+     * @param g the random generator engine.
+     */
+    template<typename Generator>
+    void generate(result_type* p, size_t n, Generator& g)
+    { generate(p, p + n, g); }
 
   /**
    * @return true if two normal distributions have the same parameters.
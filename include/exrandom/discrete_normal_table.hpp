@@ -0,0 +1,337 @@
+/**
+ * @file discrete_normal_table.hpp
+ * @author Charles Karney <charles.karney@sri.com>
+ * @brief Definition of discrete_normal_table
+ *
+ * Copyright (c) Charles Karney (2016) and licensed under the MIT/X11 License.
+ * For more information, see http://exrandom.sourceforge.net/
+ */
+
+#if !defined(EXRANDOM_DISCRETE_NORMAL_TABLE_HPP)
+#define EXRANDOM_DISCRETE_NORMAL_TABLE_HPP 1
+
+#include <vector>               // for the tables
+#include <cmath>                // for std::floor, std::ceil
+#include <cstdint>              // for uint32_t, uint64_t
+#include <cstddef>              // for size_t
+#include <limits>
+#include <algorithm>            // for std::min, std::max
+#include <stdexcept>            // for std::runtime_error
+
+#include <exrandom/u_rand.hpp>
+#include <exrandom/i_rand.hpp>
+#include <exrandom/fixed_point.hpp>
+
+namespace exrandom {
+
+  /**
+   * @brief Sample exactly from a discrete normal distribution with small
+   * &sigma; using an alias table.
+   *
+   * @tparam b the base for the digits, a power of two.
+   *
+   * This samples from P<sub>i</sub> &prop; w<sub>i</sub> = exp[&minus; ((i
+   * &minus; &mu;)<sup>2</sup> &minus; (i<sub>0</sub> &minus;
+   * &mu;)<sup>2</sup>)/(2&sigma;<sup>2</sup>)], where i<sub>0</sub> is the
+   * integer nearest &mu; (so that the largest weight is 1), by rejection
+   * from an envelope e<sub>i</sub> &ge; w<sub>i</sub>.  For i in [&mu;
+   * &minus; @e h, &mu; + @e h], where @e h = max(0.7&sigma;<sup>2</sup>,
+   * 10&sigma;), e<sub>i</sub> is w<sub>i</sub> rounded up to a multiple of
+   * 2<sup>&minus;32</sup>; beyond this range e<sub>i</sub> is halved at
+   * each step (and this bounds w<sub>i</sub> because the ratio of
+   * successive w<sub>i</sub> is less than 1/2 there).  The two tails are
+   * entries in the table with weights equal to the weights at the ends of
+   * the range.  Since the weights are integers, a candidate is drawn
+   * exactly with Walker's alias method using an i_rand to pick the column
+   * and a u_rand to decide between the column and its alias.  The
+   * candidate i is then accepted with probability w<sub>i</sub> /
+   * e<sub>i</sub> by comparing a u_rand with tabulated 32-bit bounds on
+   * this ratio.  The rare cases which are not decided this way are settled
+   * by generating more digits of the u_rand and computing rigorous fixed
+   * point bounds on the ratio.  The probability of rejection is about
+   * 2<sup>&minus;32</sup> times the number of entries divided by the sum of
+   * w<sub>i</sub> (which is at least 1).
+   *
+   * This is used by discrete_normal_dist when suitable() is true, i.e.,
+   * when the table is smaller than cache_bytes.
+   */
+  template<uint_t b> class discrete_normal_table {
+  public:
+    /**
+     * The base for the digits (or 0 if the base is 2<sup>32</sup>).
+     */
+    static const uint_t base = digit_arithmetic<b>::base;
+    /**
+     * The maximum size of a table for which suitable() returns true.
+     */
+    static const size_t cache_bytes = 32768;
+    /**
+     * Whether a table should be used for given parameters.
+     *
+     * @param sig the numerator of &sigma;.
+     * @param d the denominator of &sigma;.
+     * @return true if the base is a power of two, @e sig and @e d are less
+     *   than 2<sup>32</sup>, &sigma; &ge; 1/256, and the table will take no
+     *   more than cache_bytes.
+     *
+     * For the default cache_bytes, this is true for 1/256 &le; &sigma;
+     * &lt; 25.
+     */
+    static bool suitable(long long sig, long long d) {
+      if (!(digit_arithmetic<b>::power_of_two && sig > 0 && d > 0 &&
+            sig < maxsig && d < maxsig))
+        return false;
+      double sigma = double(sig) / double(d);
+      if (!(sigma >= 1/256.0)) return false;
+      double n = 2 * std::ceil(halfwidth(sigma)) + 4;
+      return n * entry_bytes + sizeof(discrete_normal_table) <= cache_bytes;
+    }
+    /**
+     * Construct the table.
+     *
+     * @param imu the integer part of &mu; (rounded towards zero).
+     * @param mu the numerator of the fractional part of &mu;.
+     * @param d the common denominator of the fractional part of &mu; and
+     *   &sigma;.
+     * @param sig the numerator of &sigma;.
+     * @exception std::runtime_error if the parameters are unsuitable.
+     *
+     * Thus &mu; = @e imu + @e mu/@e d and &sigma; = @e sig/@e d.
+     */
+    discrete_normal_table(int imu, long long mu, long long d, long long sig)
+      : _imu(imu), _mu(mu), _d(d), _sig(sig) {
+      if (!suitable(sig, d))
+        throw std::runtime_error("discrete_normal_table: unsuitable sigma");
+      init();
+    }
+    /**
+     * @return the number of entries in the table (including the two tails).
+     */
+    size_t size() const { return _e.size(); }
+    /**
+     * @return the memory used by the table in bytes.
+     */
+    size_t bytes() const
+    { return size() * entry_bytes + sizeof(discrete_normal_table); }
+    /**
+     * Draw a candidate from the envelope.
+     *
+     * @tparam Generator the type of g.
+     * @tparam digit_gen the type of digit generator.
+     * @tparam int_type the integer type of j.
+     * @param g the random generator engine.
+     * @param j an i_rand used to select the column.
+     * @param y a u_rand used to select between the column and its alias and
+     *   to sample the tails.
+     * @param[out] tail 0 for a candidate within the table, otherwise its
+     *   distance from the end of the table.
+     * @return the candidate i.
+     */
+    template<typename Generator, typename digit_gen, typename int_type>
+    int propose(Generator& g, i_rand<digit_gen, int_type>& j,
+                u_rand<digit_gen>& y, int& tail) const {
+      static_assert(digit_gen::base == base,
+                    "discrete_normal_table: mismatch in base");
+      size_t c = size_t(j.init(g, int_type(size()))(g));
+      if (!(y.init().compare(g, _t[c], _t[c], _E) < 0)) c = _alias[c];
+      tail = 0;
+      size_t n = size() - 2;
+      if (c < n) return _ilo + int(c);
+      tail = 1;
+      while (y.init().less_than_half(g)) ++tail;
+      return c == n ? _ilo - tail : _ihi + tail;
+    }
+    /**
+     * Accept or reject a candidate.
+     *
+     * @tparam Generator the type of g.
+     * @tparam digit_gen the type of digit generator.
+     * @tparam store the digit_store for z.
+     * @param g the random generator engine.
+     * @param i the candidate returned by propose().
+     * @param tail the value of @e tail set by propose().
+     * @param z a u_rand which is initialized and used as a uniform deviate.
+     * @return true with probability w<sub>i</sub> / e<sub>i</sub>.
+     */
+    template<typename Generator, typename digit_gen, typename store>
+    bool accept(Generator& g, int i, int tail,
+                u_rand<digit_gen, store>& z) const {
+      size_t c = tail == 0 ? size_t(i - _ilo) :
+        size() - (i < _ilo ? 2 : 1);
+      // Compare the leading bits of z with the bounds on w_i / e_i
+      std::uint64_t y = 0;
+      int ybits = 0;
+      size_t n = 0;
+      z.init();
+      while (ybits < 32) {
+        y = (y << bits) | z.digit(g, n++); ybits += bits;
+        std::uint64_t ylo = ybits <= 32 ? y << (32 - ybits) :
+          y >> (ybits - 32),
+          dy = ybits <= 32 ? std::uint64_t(1) << (32 - ybits) : 1U;
+        if (ylo + dy <= _lo[c]) return true;
+        if (ylo >= _hi[c]) return false;
+      }
+      return exact(g, i, tail, _e[c], z, n);
+    }
+  private:
+    static const int bits = digit_arithmetic<b>::bits;
+    static const long long maxsig = 1LL << 32;
+    // _t, _e, _lo, _hi, _alias
+    static const size_t entry_bytes =
+      4 * sizeof(std::uint64_t) + sizeof(size_t);
+    typedef fixed_point F;
+    typedef F::number fixed;
+    int _imu, _ilo, _ihi;       // the table covers [_ilo, _ihi]
+    long long _mu, _d, _sig;    // mu = _imu + _mu/_d, sigma = _sig/_d
+    std::uint64_t _a0;          // |i0 - mu| * _d
+    std::uint64_t _E;           // the sum of _e
+    // For each entry: the weight e_i scaled by 2^32, the threshold for the
+    // alias method, and lower and upper bounds on w_i / e_i scaled by 2^32.
+    // The last two entries are the lower and upper tails.
+    std::vector<std::uint64_t> _e, _t, _lo, _hi;
+    std::vector<size_t> _alias;
+    static double halfwidth(double sigma)
+    { return (std::max)(0.7 * sigma * sigma, 10 * sigma); }
+    // Bounds on (a/sig) * (c/sig) / 2 with w words in the fraction
+    fixed zbound(std::uint64_t a, std::uint64_t c, size_t w, bool up) const {
+      std::uint64_t s = std::uint64_t(_sig);
+      fixed z = F::mul(F::quotient(a, s, w, up), F::quotient(c, s, w, up),
+                       up);
+      F::div(z, 2U, up);
+      return z;
+    }
+    // Bounds on exp(-z) where z = zbound(a, c, w, .)
+    void ebound(std::uint64_t a, std::uint64_t c, size_t w,
+                fixed& lo, fixed& hi) const {
+      fixed t;
+      F::expneg(zbound(a, c, w, true), lo, t);
+      F::expneg(zbound(a, c, w, false), t, hi);
+    }
+    // Bounds on w_i = exp(-z_i) with w words in the fraction, where z_i =
+    // ((i - mu)^2 - (i0 - mu)^2)/(2 sigma^2) = (a - a0) (a + a0)/(2 sig^2)
+    // with a = |i - mu| * _d and a0 = |i0 - mu| * _d.  The common factor
+    // exp(-((i0 - mu)/sigma)^2/2) cancels in P_i, so this is still exact; it
+    // keeps the largest weight at 1 (so that the probability of acceptance
+    // isn't spoiled by rounding e_i up to a multiple of 2^-32 when sigma is
+    // small).
+    fixed wbound(int i, size_t w, bool up) const {
+      long long n = (i - _imu) * _d - _mu; // (i - mu) * _d
+      std::uint64_t a = std::uint64_t(n < 0 ? -n : n);
+      if ((a - _a0) / std::uint64_t(_sig) >= (1U << 16)) {
+        fixed z(w + 1, 0U);     // w_i < exp(-2^31)
+        if (up) F::ulp(z);
+        return z;
+      }
+      fixed lo, hi;
+      ebound(a - _a0, a + _a0, w, lo, hi);
+      return up ? hi : lo;
+    }
+    // Convert a bound r on w_i to a bound on w_i * 2^(32 + tail) / e
+    static fixed ratio(fixed r, int tail, std::uint64_t e, bool up) {
+      size_t w = r.size() - 1;
+      fixed one(w + 1, 0U);
+      one[0] = 1U;
+      for (int k = 0; k < tail && r[0] == 0U; ++k) F::add(r, r);
+      if (e != std::uint64_t(1) << 32) {
+        if (r[0]) return one;   // only possible if up
+        for (size_t k = 0; k < w; ++k) r[k] = r[k + 1];
+        r[w] = 0U;
+        F::div(r, std::uint32_t(e), up);
+      } else if (r[0])
+        return one;
+      return up && !F::less(r, one) ? one : r;
+    }
+    // A fixed point number in [0, 2^32) scaled by 2^32, rounded up if up
+    static std::uint64_t scaled(const fixed& a, bool up) {
+      bool inexact = false;
+      for (size_t i = 2; i < a.size(); ++i) inexact = inexact || a[i] != 0U;
+      return ((std::uint64_t(a[0]) << 32) | a[1]) + (up && inexact ? 1U : 0U);
+    }
+    // Decide z < w_i * 2^(32 + tail) / e by generating more digits of z.
+    template<typename Generator, typename digit_gen, typename store>
+    bool exact(Generator& g, int i, int tail, std::uint64_t e,
+               u_rand<digit_gen, store>& z, size_t n) const {
+      for (++n;; ++n) {
+        z.digit(g, n - 1);
+        size_t w = (n * bits + 31) / 32 + 2;
+        if (!F::less(ratio(wbound(i, w, false), tail, e, false),
+                     F::digits(z, bits, n, w, true)))
+          return true;
+        if (!F::less(F::digits(z, bits, n, w, false),
+                     ratio(wbound(i, w, true), tail, e, true)))
+          return false;
+      }
+    }
+    void init() {
+      const size_t w = 3;
+      const std::uint64_t one = std::uint64_t(1) << 32;
+      double sigma = double(_sig) / double(_d),
+        h = halfwidth(sigma), c = _imu + double(_mu) / double(_d);
+      _ilo = int(std::floor(c - h)); _ihi = int(std::ceil(c + h));
+      size_t n = size_t(_ihi - _ilo + 1), m = n + 2;
+      _e.resize(m); _t.resize(m); _lo.resize(m); _hi.resize(m);
+      _alias.resize(m);
+      // Compute bounds on w_i starting at i0, the nearest integer to mu, and
+      // working outwards using w_{i+1}/w_i = exp(-(2(i - mu) + 1)/(2
+      // sigma^2)) for i >= i0 and w_{i-1}/w_i = exp(-(2(mu - i) + 1)/(2
+      // sigma^2)) for i <= i0.  These ratios are <= 1 and the ratios of
+      // successive ratios are exp(-1/sigma^2).
+      // i0 = _imu + floor((2 * _mu + _d) / (2 * _d)), computed exactly
+      long long num = 2 * _mu + _d, den = 2 * _d, q = num / den;
+      if (q * den > num) --q;
+      int i0 = _imu + int(q);
+      long long n0 = (i0 - _imu) * _d - _mu; // (i0 - mu) * _d
+      _a0 = std::uint64_t(n0 < 0 ? -n0 : n0);
+      std::vector<fixed> wlo(n), whi(n);
+      wlo[i0 - _ilo] = wbound(i0, w, false);
+      whi[i0 - _ilo] = wbound(i0, w, true);
+      fixed blo, bhi;
+      ebound(2 * std::uint64_t(_d), std::uint64_t(_d), w, blo, bhi);
+      for (int step = 1; step >= -1; step -= 2) {
+        fixed qlo, qhi;
+        ebound(std::uint64_t(_d + 2 * step * n0), std::uint64_t(_d), w,
+               qlo, qhi);
+        for (int i = i0; i != (step > 0 ? _ihi : _ilo); i += step) {
+          size_t k = size_t(i - _ilo), k1 = size_t(i + step - _ilo);
+          wlo[k1] = F::mul(wlo[k], qlo, false);
+          whi[k1] = F::mul(whi[k], qhi, true);
+          qlo = F::mul(qlo, blo, false); qhi = F::mul(qhi, bhi, true);
+        }
+      }
+      for (size_t k = 0; k < n; ++k) {
+        _e[k] = (std::max)(std::uint64_t(1),
+                           (std::min)(one, scaled(whi[k], true)));
+        _lo[k] = scaled(ratio(wlo[k], 0, _e[k], false), false);
+        _hi[k] = scaled(ratio(whi[k], 0, _e[k], true), true);
+      }
+      // The tails: e_i is halved at each step beyond the end of the table
+      _e[n] = _e[0]; _e[n + 1] = _e[n - 1];
+      for (size_t k = n; k < m; ++k) { _lo[k] = 0U; _hi[k] = one; }
+      _E = 0U;
+      for (size_t k = 0; k < m; ++k) _E += _e[k];
+      // u_rand::compare needs _E * base to be representable
+      if (!(_E <= std::uint64_t(std::numeric_limits<long long>::max()) /
+            std::uint64_t(base ? base : one)))
+        throw std::runtime_error("discrete_normal_table: overflow");
+      // Walker's alias method with integer weights (Vose's construction).
+      // Column k holds m * _e[k] out of a capacity of _E; since all the
+      // quantities are integers, the construction is exact.
+      std::vector<std::uint64_t> s(m);
+      std::vector<size_t> small, large;
+      for (size_t k = 0; k < m; ++k) {
+        s[k] = m * _e[k]; _t[k] = _E; _alias[k] = k;
+        (s[k] < _E ? small : large).push_back(k);
+      }
+      while (!small.empty() && !large.empty()) {
+        size_t l = small.back(), g = large.back();
+        small.pop_back();
+        _t[l] = s[l]; _alias[l] = g;
+        s[g] -= _E - s[l];
+        if (s[g] < _E) { large.pop_back(); small.push_back(g); }
+      }
+    }
+  };
+
+}
+
+#endif  // EXRANDOM_DISCRETE_NORMAL_TABLE_HPP
@@ -65,6 +65,39 @@
 #else
 #define EXRANDOM_CXX11_MATH 0
 #endif
+
+#if !(defined(_MSC_VER) && _MSC_VER < 1900)
+#define EXRANDOM_THREAD_LOCAL 1
+#else
+#define EXRANDOM_THREAD_LOCAL 0
+#endif
+
+#if __cplusplus >= 201703L || (defined(_MSVC_LANG) && _MSVC_LANG >= 201703L)
+#define EXRANDOM_CXX17 1
+#else
+#define EXRANDOM_CXX17 0
+#endif
+
+// With EXRANDOM_PROFILE = 1, the functions for the steps of the algorithms
+// are not inlined, so that profilers attribute time to each step.
+#if !defined(EXRANDOM_PROFILE)
+#define EXRANDOM_PROFILE 0
+#endif
+#if EXRANDOM_PROFILE && defined(_MSC_VER)
+#define EXRANDOM_PROFILE_STEP __declspec(noinline)
+#elif EXRANDOM_PROFILE
+#define EXRANDOM_PROFILE_STEP __attribute__((noinline))
+#else
+#define EXRANDOM_PROFILE_STEP
+#endif
+
+// Branches on template constants; with C++17 the branch not taken is
+// discarded when the template is instantiated.
+#if EXRANDOM_CXX17
+#define EXRANDOM_IF_CONSTEXPR if constexpr
+#else
+#define EXRANDOM_IF_CONSTEXPR if
+#endif
 #endif
 
 #endif  // EXRANDOM_CONFIG_HPP
@@ -0,0 +1,175 @@
+/**
+ * @file fixed_point.hpp
+ * @author Charles Karney <charles.karney@sri.com>
+ * @brief Definition of fixed_point
+ *
+ * Copyright (c) Charles Karney (2016) and licensed under the MIT/X11 License.
+ * For more information, see http://exrandom.sourceforge.net/
+ */
+
+#if !defined(EXRANDOM_FIXED_POINT_HPP)
+#define EXRANDOM_FIXED_POINT_HPP 1
+
+#include <vector>               // for number
+#include <cstdint>              // for uint32_t, uint64_t
+#include <cstddef>              // for size_t
+
+namespace exrandom {
+
+  /// \cond SKIP
+  // Fixed point arithmetic used to compute rigorous bounds for the tables in
+  // normal_k_table, normal_ziggurat_table, discrete_normal_table, and
+  // discrete_normal_ct.  A number is a vector of 32-bit words; element 0 is
+  // the integer part and the rest are the fraction (most significant
+  // first).  The operands of a binary operation have the same size.
+  // Functions which take a bool "up" give upper bounds if it is true and
+  // lower bounds otherwise.
+  class fixed_point {
+  public:
+    typedef std::vector<std::uint32_t> number;
+    static void add(number& a, const number& c) {
+      std::uint64_t t = 0;
+      for (size_t i = a.size(); i--;) {
+        t += std::uint64_t(a[i]) + c[i];
+        a[i] = std::uint32_t(t); t >>= 32;
+      }
+    }
+    static void sub(number& a, const number& c) { // requires a >= c
+      std::uint64_t borrow = 0;
+      for (size_t i = a.size(); i--;) {
+        std::uint64_t t = std::uint64_t(a[i]) - c[i] - borrow;
+        a[i] = std::uint32_t(t); borrow = (t >> 32) ? 1U : 0U;
+      }
+    }
+    static void ulp(number& a) {
+      for (size_t i = a.size(); i-- && ++a[i] == 0U;) {}
+    }
+    static number mul(const number& a, const number& c, bool up) {
+      size_t n = a.size();
+      // Little-endian full product
+      std::vector<std::uint32_t> p(2 * n, 0U);
+      for (size_t i = 0; i < n; ++i) {
+        std::uint64_t t = 0;
+        for (size_t k = 0; k < n; ++k) {
+          t += std::uint64_t(a[n - 1 - i]) * c[n - 1 - k] + p[i + k];
+          p[i + k] = std::uint32_t(t); t >>= 32;
+        }
+        p[i + n] = std::uint32_t(t);
+      }
+      number r(n);
+      bool inexact = false;
+      for (size_t i = 0; i < n - 1; ++i) inexact = inexact || p[i] != 0U;
+      for (size_t i = 0; i < n; ++i) r[n - 1 - i] = p[n - 1 + i];
+      if (up && inexact) ulp(r);
+      return r;
+    }
+    static void div(number& a, std::uint32_t d, bool up) {
+      std::uint64_t rem = 0;
+      for (size_t i = 0; i < a.size(); ++i) {
+        std::uint64_t t = (rem << 32) | a[i];
+        a[i] = std::uint32_t(t / d); rem = t % d;
+      }
+      if (up && rem) ulp(a);
+    }
+    // a/s with w words in the fraction (requires s < 2^32 and a/s < 2^32)
+    static number quotient(std::uint64_t a, std::uint64_t s, size_t w,
+                           bool up) {
+      number x(w + 1, 0U);
+      x[0] = std::uint32_t(a / s);
+      std::uint64_t rem = a % s;
+      for (size_t k = 1; k <= w; ++k) {
+        rem <<= 32;
+        x[k] = std::uint32_t(rem / s); rem %= s;
+      }
+      if (up && rem) ulp(x);
+      return x;
+    }
+    static bool tiny(const number& a) { // a <= 1 ulp
+      for (size_t i = 0; i + 1 < a.size(); ++i)
+        if (a[i]) return false;
+      return a.back() <= 1U;
+    }
+    static bool less(const number& a, const number& c) { // a < c
+      for (size_t i = 0; i < a.size(); ++i)
+        if (a[i] != c[i]) return a[i] < c[i];
+      return false;
+    }
+    // The first n digits (each with the given number of bits) of the
+    // fraction of the u_rand u with w words in the fraction.  If up, add 1
+    // in the last digit.
+    template<typename urand>
+    static number digits(const urand& u, int bits, size_t n, size_t w,
+                         bool up) {
+      number r(w + 1, 0U);
+      std::uint64_t acc = 0;
+      int nacc = 0;
+      size_t j = 1;
+      for (size_t i = 0; i < n; ++i) {
+        acc = (acc << bits) | u.rawdigit(i); nacc += bits;
+        if (nacc >= 32) {
+          nacc -= 32;
+          r[j++] = std::uint32_t(acc >> nacc);
+          acc &= (std::uint64_t(1) << nacc) - 1U;
+        }
+      }
+      if (nacc) r[j] = std::uint32_t(acc << (32 - nacc));
+      if (up) {
+        // Add 2^-(n*bits)
+        size_t p = n * bits, i = (p + 31) / 32;
+        std::uint64_t t = std::uint64_t(1) << (32 * i - p);
+        for (; t; --i) {
+          t += r[i]; r[i] = std::uint32_t(t); t >>= 32;
+          if (i == 0) break;
+        }
+      }
+      return r;
+    }
+    // Lower and upper bounds on exp(-z) for z in [0, 2^32) given exactly.
+    // If z >= 4, the series is summed for bounds on z/2^s < 4 and the
+    // resulting bounds are squared s times.
+    static void expneg(const number& z, number& lo, number& hi) {
+      if (z[0] < 4U) { series(z, lo, hi); return; }
+      number zlo(z), zhi(z), t;
+      int s = 0;
+      for (; zhi[0] >= 4U; ++s) { div(zlo, 2U, false); div(zhi, 2U, true); }
+      series(zhi, lo, t);
+      series(zlo, t, hi);
+      for (; s; --s) { lo = mul(lo, lo, false); hi = mul(hi, hi, true); }
+    }
+  private:
+    // Lower and upper bounds on exp(-z) for z in [0, 4) given exactly,
+    // summing the Taylor series.
+    static void series(const number& z, number& lo, number& hi) {
+      const size_t n = z.size();
+      number one(n, 0U), zero(n, 0U);
+      one[0] = 1U;
+      // tlo, thi bound the term z^m/m!; the even terms are summed in p and
+      // the odd ones in q.
+      number tlo(one), thi(one), plo(one), phi(one), qlo(zero), qhi(zero);
+      for (std::uint32_t m = 1; ; ++m) {
+        tlo = mul(tlo, z, false); div(tlo, m, false);
+        thi = mul(thi, z, true); div(thi, m, true);
+        if (m % 2) { add(qlo, tlo); add(qhi, thi); }
+        else       { add(plo, tlo); add(phi, thi); }
+        // Once m >= z, the terms decrease and the remainder is bounded by
+        // the last term.
+        if (m >= z[0] + 1U && tiny(thi)) break;
+      }
+      add(qhi, thi);            // lo = plo - qhi - thi
+      if (less(plo, qhi))
+        lo = zero;
+      else {
+        lo = plo; sub(lo, qhi);
+      }
+      hi = phi; add(hi, thi);   // hi = phi + thi - qlo
+      if (less(hi, qlo))
+        hi = zero;
+      else
+        sub(hi, qlo);
+    }
+  };
+  /// \endcond
+
+}
+
+#endif  // EXRANDOM_FIXED_POINT_HPP
@@ -0,0 +1,229 @@
+/**
+ * @file geometric_dist.hpp
+ * @author Charles Karney <charles.karney@sri.com>
+ * @brief Definition of geometric_dist
+ *
+ * Copyright (c) Charles Karney (2016) and licensed under the MIT/X11 License.
+ * For more information, see http://exrandom.sourceforge.net/
+ */
+
+#if !defined(EXRANDOM_GEOMETRIC_DIST_HPP)
+#define EXRANDOM_GEOMETRIC_DIST_HPP 1
+
+#include <iostream>             // for std::ostream, etc.
+#include <stdexcept>            // for std::runtime_error
+#include <cstddef>              // for size_t
+#include <limits>
+
+#include <exrandom/i_rand.hpp>
+#include <exrandom/bernoulli.hpp>
+
+namespace exrandom {
+
+  /**
+   * @brief Sample exactly from the geometric distribution.
+   *
+   * @tparam digit_gen the type of digit generator.
+   *
+   * This samples from the geometric distribution P<sub>k</sub> = (1 &minus;
+   * exp(&minus;1/t)) exp(&minus;k/t) for integer k &ge; 0, where the scale t
+   * = @e t_num/@e t_den &gt; 0 is rational.  This uses the method of C. L.
+   * Canonne, G. Kamath, and T. Steinke (2020), <a
+   * href="https://arxiv.org/abs/2004.00010">arxiv:2004.00010</a>: sample X
+   * with P<sub>X</sub> &prop; exp(&minus;X/@e t_num) as U + @e t_num V, where
+   * U is uniform in [0, @e t_num), sampled with an i_rand and accepted with
+   * probability exp(&minus;U/@e t_num), and V is the number of successful
+   * trials with probability exp(&minus;1) before the first failure; the
+   * result is floor(X/@e t_den).  The Bernoulli trials are done with
+   * bernoulli_exp and so are exact.  The probability that U is accepted
+   * exceeds 0.63 and the expected number of trials in V is less than 0.59,
+   * so the cost is bounded independent of t (apart from the digits needed
+   * to sample U).
+   *
+   * The probability of a result exceeding 1250t is about
+   * 10<sup>&minus;543</sup>; so t is limited to (2<sup>31</sup> &minus;
+   * 1)/1250 to ensure that the results are representable as ints.
+   * digit_gen::base must be less than 2<sup>32</sup> (for the i_rand).
+   * This is the building block for discrete_laplace_dist.  See
+   * geometric_distribution for a C++11 style interface.
+   */
+  template<typename digit_gen> class geometric_dist {
+  public:
+    /**
+     * @brief Hold the parameters of geometric_dist.
+     */
+    struct param_type {
+      /**
+       * Construct from the numerator and denominator of t.
+       *
+       * @param t_num the numerator of t.
+       * @param t_den the denominator of t (default 1).
+       * @exception std::runtime_error if t &le; 0 or if t is too large.
+       *
+       * Sets t = @e t_num / @e t_den.
+       */
+      explicit param_type(int t_num = 1, int t_den = 1)
+      { param_init(t_num, t_den); }
+      /**
+       * @return the numerator of t.
+       */
+      int t_num() const { return _t_num; }
+      /**
+       * @return the denominator of t.
+       */
+      int t_den() const { return _t_den; }
+      /**
+       * Test for equality.
+       *
+       * @param p1
+       * @param p2
+       * @return p1 == p2.
+       */
+      friend bool operator==(const param_type& p1, const param_type& p2)
+      { return p1._t_num == p2._t_num && p1._t_den == p2._t_den; }
+      /**
+       * Inserts a param_type @e x into the output stream @e os.
+       *
+       * @param os an output stream.
+       * @param x a param_type.
+       * @return os.
+       */
+      friend std::ostream& operator<<(std::ostream& os, const param_type& x) {
+        const auto flags = os.flags();
+        os.flags(std::ios::dec);
+        os << x.t_num() << ' ' << x.t_den();
+        os.flags(flags);
+        return os;
+      }
+      /**
+       * Extracts a param_type @e x from the input stream @e is.
+       *
+       * @param is an input stream.
+       * @param x a param_type.
+       * @return is.
+       */
+      friend std::istream& operator>>(std::istream& is, param_type& x) {
+        const auto flags = is.flags();
+        is.flags(std::ios::dec | std::ios::skipws);
+        int t_num, t_den;
+        if (is >> t_num >> t_den) x.param_init(t_num, t_den);
+        is.flags(flags);
+        return is;
+      }
+    private:
+      int _t_num, _t_den;
+      void param_init(int t_num, int t_den) {
+        if (!(t_num > 0 && t_den > 0))
+          throw std::runtime_error("geometric_dist: need t > 0");
+        // The probability that the result exceeds kmax * t is about 10^-543.
+        const long long kmax = 1250;
+        if (!(t_num * kmax <=
+              (long long)(std::numeric_limits<int>::max()) * t_den))
+          throw std::runtime_error("geometric_dist: possible overflow");
+        int l = gcd(t_num, t_den);
+        _t_num = t_num / l; _t_den = t_den / l;
+      }
+      // Knuth, TAOCP, vol 2, 4.5.2, Algorithm A
+      static int gcd(int u, int v) {
+        while (v > 0) { int r = u % v; u = v; v = r; }
+        return u;
+      }
+    };
+
+    /**
+     * The constructor.
+     *
+     * @param D a reference to the digit generator to be used.
+     * @param p the parameters (default t = 1).
+     */
+    explicit geometric_dist(digit_gen& D, const param_type& p = param_type())
+      : _D(D), _H(D), _j(D), _param(p) {}
+    /**
+     * Construct from the numerator and denominator of t.
+     *
+     * @param D a reference to the digit generator to be used.
+     * @param t_num the numerator of t.
+     * @param t_den the denominator of t (default 1).
+     * @exception std::runtime_error if t &le; 0 or if t is too large.
+     */
+    geometric_dist(digit_gen& D, int t_num, int t_den = 1)
+      : _D(D), _H(D), _j(D), _param(t_num, t_den) {}
+    /**
+     * Return a deviate.
+     *
+     * @tparam Generator the type of g.
+     * @param g the random generator engine.
+     * @return the random deviate.
+     */
+    template<typename Generator>
+    int operator()(Generator& g) { return operator()(g, _param); }
+    /**
+     * Return a deviate using the specified parameters.
+     *
+     * @tparam Generator the type of g.
+     * @param g the random generator engine.
+     * @param p the parameters.
+     * @return the random deviate.
+     *
+     * The parameters of *this are not changed.
+     */
+    template<typename Generator>
+    int operator()(Generator& g, const param_type& p) {
+      const int n = p.t_num();
+      int u;
+      do
+        u = n > 1 ? _j.init(g, n)(g) : 0;
+      while (!(u == 0 || _H(g, u, n)));
+      long long v = 0;
+      while (_H(g, 1)) ++v;
+      return int((u + n * v) / p.t_den());
+    }
+    /**
+     * Fill an array with deviates.
+     *
+     * @tparam Generator the type of g.
+     * @param g the random generator engine.
+     * @param[out] p where to put the results.
+     * @param n the number of deviates.
+     *
+     * The results are the same as @e n calls to operator()().
+     */
+    template<typename Generator>
+    void generate(Generator& g, int* p, size_t n)
+    { for (int* e = p + n; p != e; ++p) *p = operator()(g, _param); }
+    /**
+     * @return the numerator of t.
+     */
+    int t_num() const { return _param.t_num(); }
+    /**
+     * @return the denominator of t.
+     */
+    int t_den() const { return _param.t_den(); }
+    /**
+     * @return a reference to the digit generator used in the constructor.
+     */
+    digit_gen& digit_generator() const { return _D; }
+    /**
+     * @return the parameters.
+     */
+    const param_type& param() const { return _param; }
+    /**
+     * Set new parameters.
+     *
+     * @param p the new parameters.
+     */
+    void init(const param_type& p) { _param = p; }
+  private:
+    static_assert(digit_gen::bits < 32,
+                  "geometric_dist: base must be less than 2^32");
+    // Disable copy assignment
+    geometric_dist& operator=(const geometric_dist&);
+    digit_gen& _D;
+    bernoulli_exp<digit_gen> _H;
+    i_rand<digit_gen> _j;       // temporary storage
+    param_type _param;
+  };
+
+}
+
+#endif  // EXRANDOM_GEOMETRIC_DIST_HPP
@@ -0,0 +1,241 @@
+/**
+ * @file geometric_distribution.hpp
+ * @author Charles Karney <charles.karney@sri.com>
+ * @brief Definition of geometric_distribution
+ *
+ * Copyright (c) Charles Karney (2016) and licensed under the MIT/X11 License.
+ * For more information, see http://exrandom.sourceforge.net/
+ */
+
+#if !defined(EXRANDOM_GEOMETRIC_DISTRIBUTION_HPP)
+#define EXRANDOM_GEOMETRIC_DISTRIBUTION_HPP 1
+
+#include <iostream>             // for std::ostream, etc.
+#include <limits>
+#include <cstddef>              // for size_t
+
+#include <exrandom/rand_digit.hpp>
+#include <exrandom/geometric_dist.hpp>
+
+namespace exrandom {
+
+  /**
+   * @brief Sample exactly from the geometric distribution.
+   *
+   * This samples from the geometric distribution P<sub>k</sub> = (1 &minus;
+   * exp(&minus;1/t)) exp(&minus;k/t) for integer k &ge; 0, where the scale
+   * t &gt; 0 is specified as a rational number (the ratio of two ints).
+   *
+   * This is a wrapper for geometric_dist to turn it into a C++11 style
+   * random distribution.  The base for geometric_dist is set to
+   * 2<sup>16</sup>.
+   */
+  class geometric_distribution {
+  private:
+    static const uint_t _base = 1UL<<16;
+  public:
+    /**
+     * The type of the range of the distribution.
+     */
+    typedef int result_type;
+    /**
+     * @brief Parameter type for geometric_distribution.
+     */
+    struct param_type : geometric_dist<rand_digit<_base>>::param_type {
+      /**
+       * The type of the random number distribution.
+       */
+      typedef geometric_distribution distribution_type;
+
+      /**
+       * Construct from the numerator and denominator of t.
+       *
+       * @param t_num the numerator of t (default 1).
+       * @param t_den the denominator of t (default 1).
+       *
+       * Sets t = @e t_num / @e t_den.
+       */
+      explicit param_type(int t_num = 1, int t_den = 1)
+        : geometric_dist<rand_digit<_base>>::param_type(t_num, t_den) {}
+    };
+
+    /**
+     * Construct from the numerator and denominator of t.
+     *
+     * @param t_num the numerator of t (default 1).
+     * @param t_den the denominator of t (default 1).
+     *
+     * Sets t = @e t_num / @e t_den.
+     */
+    explicit geometric_distribution(int t_num = 1, int t_den = 1)
+      : _param(t_num, t_den), _geom_dist(_D, _param) {}
+
+    /**
+     * Construct from a param_type.
+     *
+     * @param p
+     */
+    explicit geometric_distribution(const param_type& p)
+      : _param(p), _geom_dist(_D, _param) {}
+
+    /**
+     * The copy constructor.
+     *
+     * @param d the distribution to copy.
+     *
+     * The copy has its own digit generator; so copies can be used
+     * independently, e.g., in different threads.
+     */
+    geometric_distribution(const geometric_distribution& d)
+      : _param(d._param), _D(d._D), _geom_dist(_D, _param) {}
+
+    /**
+     * The copy assignment operator.
+     *
+     * @param d the distribution to copy.
+     * @return *this.
+     */
+    geometric_distribution& operator=(const geometric_distribution& d) {
+      _param = d._param; _D = d._D; _geom_dist.init(_param);
+      return *this;
+    }
+
+    /**
+     * Resets the distribution state.
+     */
+    void reset() {}
+
+    /**
+     * @return the numerator of t.
+     */
+    result_type t_num() const { return _param.t_num(); }
+    /**
+     * @return the denominator of t.
+     */
+    result_type t_den() const { return _param.t_den(); }
+
+    /**
+     * @return the parameter set of the distribution.
+     */
+    param_type param() const { return _param; }
+
+    /**
+     * Sets the parameter set of the distribution.
+     * @param param The new parameter set of the distribution.
+     */
+    void param(const param_type& param)
+    { _param = param; _geom_dist.init(_param); }
+
+    /**
+     * @return the greatest lower bound value of the distribution.
+     */
+    result_type min() const { return 0; }
+
+    /**
+     * @return the least upper bound value of the distribution.
+     */
+    result_type max() const
+    { return std::numeric_limits<result_type>::max(); }
+
+    /**
+     * @tparam Generator the type of g.
+     * @param g the random generator engine.
+     * @return a geometric deviate.
+     */
+    template<typename Generator>
+    result_type operator()(Generator& g)
+    { return _geom_dist(g); }
+
+    /**
+     * @tparam Generator the type of g.
+     * @param g the random generator engine.
+     * @param p a parameter set.
+     * @return a geometric deviate using the specified parameters.
+     */
+    template<typename Generator>
+    result_type operator()(Generator& g, const param_type& p)
+    { return _geom_dist(g, p); }
+
+    /**
+     * Fill a range with geometric deviates.
+     *
+     * @tparam ForwardIt the type of the iterators.
+     * @tparam Generator the type of g.
+     * @param first the beginning of the range.
+     * @param last the end of the range.
+     * @param g the random generator engine.
+     *
+     * This is equivalent to assigning operator()(g) to each element of the
+     * range in turn; so the results are the same as filling the range one
+     * deviate at a time.  However, this avoids the overhead of a separate call
+     * for each deviate.
+     */
+    template<typename ForwardIt, typename Generator>
+    void generate(ForwardIt first, ForwardIt last, Generator& g)
+    { for (; first != last; ++first) *first = _geom_dist(g); }
+
+    /**
+     * Fill an array with geometric deviates.
+     *
+     * @tparam Generator the type of g.
+     * @param p a pointer to the first element of the array.
+     * @param n the number of elements of the array.
+     * @param g the random generator engine.
+     */
+    template<typename Generator>
+    void generate(result_type* p, size_t n, Generator& g)
+    { _geom_dist.generate(g, p, n); }
+
+  /**
+   * @return true if two geometric distributions have the same parameters.
+   */
+  friend bool
+  operator==(const geometric_distribution& d1,
+             const geometric_distribution& d2)
+  { return d1.param() == d2.param(); }
+
+  /**
+   * @return false if two geometric distributions have the same parameters.
+   */
+  friend bool
+  operator!=(const geometric_distribution& d1,
+             const geometric_distribution& d2)
+  { return !(d1 == d2); }
+
+  /**
+   * Inserts a geometric_distribution random number distribution @e x into
+   * the output stream @e os.
+   *
+   * @param os an output stream.
+   * @param x a geometric_distribution random number distribution.
+   * @return os.
+   */
+  friend std::ostream&
+  operator<<(std::ostream& os, const geometric_distribution& x)
+  { os << x.param(); return os; }
+
+  /**
+   * Extracts a geometric_distribution random number distribution @e x from
+   * the input stream @e is.
+   *
+   * @param is an input stream.
+   * @param x a geometric_distribution random number generator engine.
+   * @return is.
+   */
+  friend std::istream&
+  operator>>(std::istream& is, geometric_distribution& x) {
+    geometric_distribution::param_type p;
+    is >> p;
+    x.param(p);
+    return is;
+  }
+
+  private:
+    param_type _param;
+    rand_digit<_base> _D;
+    geometric_dist<rand_digit<_base>> _geom_dist;
+  };
+
+}
+
+#endif  // EXRANDOM_GEOMETRIC_DISTRIBUTION_HPP
@@ -13,9 +13,28 @@
 #include <string>               // for print routines
 #include <sstream>              // for print routines
 #include <iostream>             // for std::ostream, etc.
+#include <limits>
 
 namespace exrandom {
 
+  /// \cond SKIP
+  // The type used for the intermediate products in i_rand::init and for the
+  // fractions in i_rand::less_than, etc.  For long long, a 128-bit type is
+  // used if available; otherwise init requires m * base to be representable
+  // as a long long.  max() is given explicitly because
+  // std::numeric_limits<__int128> is not specialized in strict modes.
+  template<typename int_type> struct i_rand_wide {
+    typedef long long type;
+    static type max() { return std::numeric_limits<long long>::max(); }
+  };
+#if defined(__SIZEOF_INT128__)
+  template<> struct i_rand_wide<long long> {
+    typedef __int128 type;
+    static type max() { return ((type(1) << 126) - 1) * 2 + 1; }
+  };
+#endif
+  /// \endcond
+
   /**
    * @brief A class to sample integers [0,m).
    *
@@ -40,9 +59,24 @@ namespace exrandom {
    * value then use operator()().
    *
    * @tparam digit_gen the type of digit generator.
+   * @tparam int_type the type of the integers, int (the default) or long
+   *   long.
+   *
+   * With @e int_type = long long, m can exceed 2<sup>31</sup>.  init() does
+   * its arithmetic with long long if m &times; base &lt; 2<sup>63</sup>
+   * (so the common case is as fast as with int) and otherwise with a
+   * 128-bit type where the compiler provides one (__int128 with g++ and
+   * clang++); if it doesn't, m &times; base must be less than
+   * 2<sup>63</sup>.
    */
-  template<typename digit_gen> class i_rand {
+  template<typename digit_gen, typename int_type = int> class i_rand {
   public:
+    /**
+     * The type used for the fractions in less_than(), etc.  This is long
+     * long with @e int_type = int and a 128-bit type, if available, with @e
+     * int_type = long long.
+     */
+    typedef typename i_rand_wide<int_type>::type wide;
     explicit
     /**
      * The constructor.
@@ -64,27 +98,13 @@ namespace exrandom {
      * If @e m is less than 1, it is treated as
      */
     template<typename Generator>
-    i_rand& init(Generator& g, int m) {
+    i_rand& init(Generator& g, int_type m) {
       if (m <= 0) m = 1;
-      for (long long v = 1, c = 0;;) {
-        _l = 0;
-        for (long long w = v, a = c, d = 1;;) {
-          // play out Lumbroso's algorithm without drawing random digits with w
-          // playing the role of v and c represented by the range [a, a + d).
-          // Return if both ends of range qualify as return values at the same
-          // time.  Otherwise, fail and draw another random digit.
-          if (w >= m) {
-            long long j = (a / m) * m; a -= j; w -= j;
-            if (w >= m) {
-              if (a + d <= m) { _a = int(a); _d = int(d); return *this; }
-              break;
-            }
-          }
-          w *= b; a *= b; d *= b; ++_l;
-        }
-        long long j = (v / m) * m; v -= j; c -= j;
-        v *= b; c *= b; c += _D(g);
-      }
+      if (m <= std::numeric_limits<long long>::max() / b)
+        start<long long>(g, (long long)(m));
+      else
+        start<wide>(g, wide(m));
+      return *this;
     }
     /**
      * Sample enough digits to narrow the range to an integer.
@@ -94,16 +114,16 @@ namespace exrandom {
      * @return value of the random integer.
      */
     template<typename Generator>
-    int operator()(Generator& g)
+    int_type operator()(Generator& g)
     { while (_l) refine(g); return _a; }
     /**
      * @return the current lower end of the range.
      */
-    int min() const { return _a; }
+    int_type min() const { return _a; }
     /**
      * @return the current upper end of the range.
      */
-    int max() const { return _a + _d - 1; }
+    int_type max() const { return _a + _d - 1; }
     /**
      * @return the number of digits needs to complete the sampling.
      */
@@ -117,7 +137,8 @@ namespace exrandom {
      *
      * @param c the constant to be added.
      */
-    void add(int c) { _a += c; }
+    void add(int_type c) { _a += c; }
+
     /**
      * Test *this &lt; m/n.
      *
@@ -130,7 +151,7 @@ namespace exrandom {
      * Requires that n &gt; 0.
      */
     template<typename Generator>
-    bool less_than(Generator& g, long long m, long long n = 1) {
+    bool less_than(Generator& g, wide m, wide n = 1) {
       for (;;) {
         if ( (n * max() < m)) return true;
         if (!(n * min() < m)) return false;
@@ -149,7 +170,7 @@ namespace exrandom {
      * Requires that n &gt; 0.
      */
     template<typename Generator>
-    bool less_than_equal(Generator& g, long long m, long long n = 1)
+    bool less_than_equal(Generator& g, wide m, wide n = 1)
     { return less_than(g, m + 1, n); }
     /**
      * Test *this &gt; m/n.
@@ -163,7 +184,7 @@ namespace exrandom {
      * Requires that n &gt; 0.
      */
     template<typename Generator>
-    bool greater_than(Generator& g, long long m, long long n = 1)
+    bool greater_than(Generator& g, wide m, wide n = 1)
     { return !less_than_equal(g, m, n); }
     /**
      * Test *this &ge; m/n.
@@ -177,7 +198,7 @@ namespace exrandom {
      * Requires that n &gt; 0.
      */
     template<typename Generator>
-    bool greater_than_equal(Generator& g, long long m, long long n = 1)
+    bool greater_than_equal(Generator& g, wide m, wide n = 1)
     { return !less_than(g, m, n); }
     /**
      * @return a string representing the range.
@@ -202,7 +223,7 @@ namespace exrandom {
      */
     template<typename Generator>
     void refine(Generator& g) {
-      if (_l > 0) { --_l; _d /= b; _a += _D(g) * _d; }
+      if (_l > 0) { --_l; _d /= b; _a += int_type(_D(g)) * _d; }
     }
 
     /**
@@ -218,10 +239,34 @@ namespace exrandom {
 
   private:
     static const int b = digit_gen::base;
-    int _a, _d, _l;             // current range is _a + [0, _d); _d = b^_l.
+    int_type _a, _d;            // current range is _a + [0, _d); _d = b^_l.
+    int _l;
     // Disable copy assignment
     i_rand& operator=(const i_rand&);
     digit_gen& _D;
+    // The body of init with the arithmetic done with type T
+    template<typename T, typename Generator>
+    void start(Generator& g, T m) {
+      for (T v = 1, c = 0;;) {
+        _l = 0;
+        for (T w = v, a = c, d = 1;;) {
+          // play out Lumbroso's algorithm without drawing random digits with w
+          // playing the role of v and c represented by the range [a, a + d).
+          // Return if both ends of range qualify as return values at the same
+          // time.  Otherwise, fail and draw another random digit.
+          if (w >= m) {
+            T j = (a / m) * m; a -= j; w -= j;
+            if (w >= m) {
+              if (a + d <= m) { _a = int_type(a); _d = int_type(d); return; }
+              break;
+            }
+          }
+          w *= b; a *= b; d *= b; ++_l;
+        }
+        T j = (v / m) * m; v -= j; c -= j;
+        v *= b; c *= b; c += T(_D(g));
+      }
+    }
   };
 
 }
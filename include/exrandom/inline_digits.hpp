@@ -0,0 +1,179 @@
+/**
+ * @file inline_digits.hpp
+ * @author Charles Karney <charles.karney@sri.com>
+ * @brief Definition of inline_digits
+ *
+ * Copyright (c) Charles Karney (2016) and licensed under the MIT/X11 License.
+ * For more information, see http://exrandom.sourceforge.net/
+ */
+
+#if !defined(EXRANDOM_INLINE_DIGITS_HPP)
+#define EXRANDOM_INLINE_DIGITS_HPP 1
+
+#include <cstddef>              // for size_t
+#include <memory>               // for std::allocator
+#include <algorithm>            // for std::copy, std::swap, std::min
+
+#include <exrandom/digit_arithmetic.hpp>
+
+namespace exrandom {
+
+  /**
+   * @brief Storage for the digits of a u_rand with a small inline buffer.
+   *
+   * @tparam N the number of digits which are held without allocating memory.
+   * @tparam Alloc the allocator used when the number of digits exceeds N.
+   *
+   * This is a replacement for std::vector<uint_t> as the digit_store template
+   * parameter of u_rand.  The first N digits are stored within the object
+   * itself; the heap is only used if more that N digits are needed.  With
+   * base = 2<sup>32</sup>, nearly all deviates use fewer than 8 digits so
+   * that, with N = 8, creating a u_rand for each sample, copying it, or
+   * printing it with u_rand::print_fixed doesn't call the allocator.
+   *
+   * Only the operations needed by u_rand are provided.  Once memory has been
+   * allocated it is retained until the object is destroyed; thus clear()
+   * never releases the memory.  Allocators are assumed to compare equal.
+   */
+  template<size_t N, typename Alloc = std::allocator<uint_t> >
+  class inline_digits {
+  public:
+    /**
+     * The type of the elements.
+     */
+    typedef uint_t value_type;
+    /**
+     * The constructor.  The initial state is empty.
+     */
+    inline_digits() : _p(_buf), _size(0), _cap(N) {}
+    /**
+     * The copy constructor.
+     *
+     * @param t the inline_digits to copy.
+     */
+    inline_digits(const inline_digits& t)
+      : _p(_buf), _size(0), _cap(N), _a(t._a) { assign(t); }
+    /**
+     * The destructor.
+     */
+    ~inline_digits() { release(); }
+    /**
+     * The copy assignment operator.
+     *
+     * @param t the inline_digits to copy.
+     * @return the inline_digits itself.
+     */
+    inline_digits& operator=(const inline_digits& t)
+    { if (this != &t) assign(t); return *this; }
+    /**
+     * @return the number of digits.
+     */
+    size_t size() const { return _size; }
+    /**
+     * @return the number of digits which can be held without allocating
+     *   memory.
+     */
+    size_t capacity() const { return _cap; }
+    /**
+     * @return whether the digits are held in the inline buffer.
+     */
+    bool is_inline() const { return _p == _buf; }
+    /**
+     * Remove all the digits.
+     */
+    void clear() { _size = 0; }
+    /**
+     * @param k the index of the digit.
+     * @return a reference to the k'th digit.
+     */
+    uint_t& operator[](size_t k) { return _p[k]; }
+    /**
+     * @param k the index of the digit.
+     * @return the k'th digit.
+     */
+    const uint_t& operator[](size_t k) const { return _p[k]; }
+    /**
+     * Append a digit.
+     *
+     * @param d the digit to append.
+     */
+    void push_back(uint_t d) {
+      if (_size == _cap) grow(2 * _cap);
+      _p[_size++] = d;
+    }
+    /**
+     * Make sure that there's room for digits.
+     *
+     * @param n the number of digits to allow for.
+     */
+    void reserve(size_t n) { if (n > _cap) grow(n); }
+    /**
+     * Change the number of digits.
+     *
+     * @param n the new number of digits.
+     *
+     * If the number increases, the new digits are set to zero.
+     */
+    void resize(size_t n) {
+      reserve(n);
+      for (size_t k = _size; k < n; ++k) _p[k] = uint_t(0);
+      _size = n;
+    }
+    /**
+     * Swap with another inline_digits.
+     *
+     * @param t the inline_digits to swap with.
+     *
+     * This never allocates memory.
+     */
+    void swap(inline_digits& t) {
+      if (this == &t) return;
+      if (!is_inline() && !t.is_inline()) {
+        std::swap(_p, t._p); std::swap(_cap, t._cap);
+      } else if (is_inline() && t.is_inline()) {
+        size_t m = (std::min)(_size, t._size);
+        for (size_t k = 0; k < m; ++k) std::swap(_buf[k], t._buf[k]);
+        if (_size > m)
+          std::copy(_buf + m, _buf + _size, t._buf + m);
+        else
+          std::copy(t._buf + m, t._buf + t._size, _buf + m);
+      } else {
+        // h holds its digits on the heap, s holds its digits inline
+        inline_digits& h = is_inline() ? t : *this;
+        inline_digits& s = is_inline() ? *this : t;
+        std::copy(s._buf, s._buf + s._size, h._buf);
+        s._p = h._p; s._cap = h._cap;
+        h._p = h._buf; h._cap = N;
+      }
+      std::swap(_size, t._size);
+      std::swap(_a, t._a);
+    }
+  private:
+    static_assert(N > 0, "inline_digits: N must be positive");
+    uint_t* _p;                 // _buf or memory from the allocator
+    size_t _size, _cap;
+    Alloc _a;
+    uint_t _buf[N];
+    void assign(const inline_digits& t) {
+      _size = 0;
+      reserve(t._size);
+      std::copy(t._p, t._p + t._size, _p);
+      _size = t._size;
+    }
+    void grow(size_t n) {
+      uint_t* p = _a.allocate(n);
+      std::copy(_p, _p + _size, p);
+      release();
+      _p = p; _cap = n;
+    }
+    void release() {
+      if (!is_inline()) {
+        _a.deallocate(_p, _cap);
+        _p = _buf; _cap = N;
+      }
+    }
+  };
+
+}
+
+#endif  // EXRANDOM_INLINE_DIGITS_HPP
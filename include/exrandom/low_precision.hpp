@@ -0,0 +1,472 @@
+/**
+ * @file low_precision.hpp
+ * @author Charles Karney <charles.karney@sri.com>
+ * @brief Definition of half, bfloat16, and fixed_q
+ *
+ * Copyright (c) Charles Karney (2016) and licensed under the MIT/X11 License.
+ * For more information, see http://exrandom.sourceforge.net/
+ */
+
+#if !defined(EXRANDOM_LOW_PRECISION_HPP)
+#define EXRANDOM_LOW_PRECISION_HPP 1
+
+#include <limits>
+#include <cmath>                // for std::ldexp, std::frexp, etc.
+#include <cstring>              // for std::memcpy
+#include <cstdint>              // for uint16_t, uint32_t
+
+#include <exrandom/u_rand.hpp>
+
+namespace exrandom {
+
+  /**
+   * @brief An IEEE binary16 (half precision) floating point number.
+   *
+   * This is a storage type for binary16 numbers (11 bits of precision,
+   * exponents in [&minus;14, 15], and subnormals down to 2<sup>&minus;24</sup>)
+   * which allows them to be used as the RealType for u_rand::value, the
+   * *_dist classes, and the unit_*_distribution wrappers.  The rounding is
+   * done directly to binary16 (including the narrow exponent range,
+   * subnormals, and overflow to infinity) so the result is not double
+   * rounded and only the digits needed for 11 bits of precision are
+   * generated.  There is no arithmetic; a half converts exactly to a float
+   * and the bit pattern is available with bits().  If the compiler provides
+   * the _Float16 type, u_rand::value<_Float16> is also supported.
+   */
+  class half {
+  public:
+    /**
+     * The default constructor (the value is +0).
+     */
+    half() : _b(0U) {}
+    /**
+     * Construct from a float, rounding to nearest even.
+     *
+     * @param x the number to convert.
+     */
+    explicit half(float x) : _b(encode(round(x))) {}
+    /**
+     * Construct from a bit pattern.
+     *
+     * @param b the bit pattern.
+     * @return the half.
+     */
+    static half from_bits(std::uint16_t b) { half h; h._b = b; return h; }
+    /**
+     * @return the bit pattern.
+     */
+    std::uint16_t bits() const { return _b; }
+    /**
+     * @return the value as a float (this is exact).
+     */
+    operator float() const {
+      int e = (_b >> 10) & 0x1f, m = _b & 0x3ff;
+      float a = e == 0 ? std::ldexp(float(m), -24) :
+        e == 31 ? (m ? std::numeric_limits<float>::quiet_NaN() :
+                   std::numeric_limits<float>::infinity()) :
+        std::ldexp(float(m + 0x400), e - 25);
+      return _b & 0x8000U ? -a : a;
+    }
+    /// \cond SKIP
+    // The bit pattern for x which is representable as a half (or infinite)
+    static std::uint16_t encode(float x) {
+      std::uint32_t u; std::memcpy(&u, &x, sizeof(u));
+      std::uint16_t s = std::uint16_t((u >> 16) & 0x8000U);
+      float a = std::fabs(x);
+      if (!(a == a)) return std::uint16_t(s | 0x7e00U);  // NaN
+      if (a == 0) return s;
+      if (a > maxval()) return std::uint16_t(s | 0x7c00U); // infinity
+      if (a < std::ldexp(1.0f, -14))                      // subnormal
+        return std::uint16_t(s | std::uint16_t(std::ldexp(a, 24)));
+      int e; float m = std::frexp(a, &e); // a = m * 2^e, 1/2 <= m < 1
+      return std::uint16_t(s | ((e + 14) << 10) |
+                           (std::uint16_t(std::ldexp(m, 11)) - 0x400U));
+    }
+    // Round x to nearest even half (as a float)
+    static float round(float x) {
+      float a = std::fabs(x);
+      if (!(a < 65520.0f))
+        return a == a ? (x < 0 ? -1 : 1) * std::numeric_limits<float>::
+          infinity() : x;
+      int e; std::frexp(a, &e);
+      int q = e - 1 < -14 ? -24 : e - 11; // the exponent of the ulp
+      float t = std::ldexp(a, -q), f = std::floor(t), d = t - f;
+      if (d > 0.5f || (d == 0.5f && std::fmod(f, 2.0f) != 0)) f += 1;
+      a = std::ldexp(f, q);
+      return x < 0 ? -a : a;
+    }
+    static float maxval() { return 65504.0f; }
+    /// \endcond
+  private:
+    std::uint16_t _b;
+  };
+
+  /**
+   * @brief A bfloat16 floating point number.
+   *
+   * This is a storage type for bfloat16 numbers (the upper half of a float
+   * with 8 bits of precision and the exponent range of a float) which allows
+   * them to be used as the RealType for u_rand::value, the *_dist classes,
+   * and the unit_*_distribution wrappers.  As with half, the rounding is
+   * done directly to 8 bits.  There is no arithmetic; a bfloat16 converts
+   * exactly to a float and the bit pattern is available with bits().  If the
+   * compiler provides the __bf16 type, u_rand::value<__bf16> is also
+   * supported.
+   */
+  class bfloat16 {
+  public:
+    /**
+     * The default constructor (the value is +0).
+     */
+    bfloat16() : _b(0U) {}
+    /**
+     * Construct from a float, rounding to nearest even.
+     *
+     * @param x the number to convert.
+     */
+    explicit bfloat16(float x) {
+      std::uint32_t u; std::memcpy(&u, &x, sizeof(u));
+      _b = std::uint16_t(x == x ? (u + 0x7fffU + ((u >> 16) & 1U)) >> 16 :
+                         (u >> 16) | 0x40U);
+    }
+    /**
+     * Construct from a bit pattern.
+     *
+     * @param b the bit pattern.
+     * @return the bfloat16.
+     */
+    static bfloat16 from_bits(std::uint16_t b)
+    { bfloat16 h; h._b = b; return h; }
+    /**
+     * @return the bit pattern.
+     */
+    std::uint16_t bits() const { return _b; }
+    /**
+     * @return the value as a float (this is exact).
+     */
+    operator float() const {
+      std::uint32_t u = std::uint32_t(_b) << 16; float x;
+      std::memcpy(&x, &u, sizeof(x));
+      return x;
+    }
+  private:
+    std::uint16_t _b;
+  };
+
+  /**
+   * @brief A fixed point number in Q format.
+   *
+   * @tparam Int the integer type holding the raw value; this must have at
+   *   most 53 digits (e.g., int16_t or uint32_t).
+   * @tparam F the number of fraction bits.
+   *
+   * The value is raw() &times; 2<sup>&minus;F</sup>.  Using this as the
+   * RealType for u_rand::value, the *_dist classes, or the
+   * unit_*_distribution wrappers rounds the result to a multiple of
+   * 2<sup>&minus;F</sup> (the first F bits of the fraction are generated
+   * together with the rounding bit).  Results outside the range of Int
+   * saturate to its largest or smallest value (this is the only case where
+   * the rounding is not in the requested direction).  There is no
+   * arithmetic; a fixed_q converts exactly to a double.
+   */
+  template<typename Int, int F> class fixed_q {
+  public:
+    /**
+     * The integer type of the raw value.
+     */
+    typedef Int raw_type;
+    /**
+     * The number of fraction bits.
+     */
+    static const int fraction_bits = F;
+    /**
+     * The default constructor (the value is 0).
+     */
+    fixed_q() : _r(0) {}
+    /**
+     * Construct from a double, rounding to nearest (with ties away from zero)
+     * and saturating.
+     *
+     * @param x the number to convert.
+     */
+    explicit fixed_q(double x) {
+      double t = std::ldexp(x, F);
+      t = t < 0 ? -std::floor(-t + 0.5) : std::floor(t + 0.5);
+      _r = saturate(t);
+    }
+    /**
+     * Construct from a raw value.
+     *
+     * @param r the raw value.
+     * @return the fixed_q.
+     */
+    static fixed_q from_raw(Int r) { fixed_q x; x._r = r; return x; }
+    /**
+     * @return the raw value.
+     */
+    Int raw() const { return _r; }
+    /**
+     * @return the value as a double (this is exact).
+     */
+    operator double() const { return std::ldexp(double(_r), -F); }
+    /// \cond SKIP
+    // Convert the integer t to Int with saturation
+    static Int saturate(double t) {
+      return t > double(std::numeric_limits<Int>::max()) ?
+        std::numeric_limits<Int>::max() :
+        t < double(std::numeric_limits<Int>::lowest()) ?
+        std::numeric_limits<Int>::lowest() : Int(t);
+    }
+    /// \endcond
+  private:
+    static_assert(std::numeric_limits<Int>::is_integer &&
+                  std::numeric_limits<Int>::digits <=
+                  std::numeric_limits<double>::digits,
+                  "fixed_q: Int must be an integer type with <= 53 digits");
+    static_assert(F >= 0 && F <= std::numeric_limits<Int>::digits,
+                  "fixed_q: F out of range");
+    Int _r;
+  };
+
+#if !defined(DOXYGEN)
+  // The formats for u_rand::value.  The result is rounded in float (or
+  // double for fixed_q) to the precision and exponent range of the format
+  // and so is exactly representable; convert then handles overflow and
+  // builds the result.
+
+  // IEEE binary16 rounded in a float
+  class binary16_format {
+  public:
+    typedef float compute_type;
+    static const unsigned radix = 2U;
+    static int digits() { return 11; }
+    static int min_exponent() { return -13; }
+    static bool denorm() { return true; }
+    static float min() { return std::ldexp(1.0f, -14); }
+    // Overflow is to infinity, unless the magnitude was rounded toward zero
+    // (in which case the result saturates).
+    static float overflow(float x, std::float_round_style rnd, int& flag) {
+      if (!(x > half::maxval() || x < -half::maxval())) return x;
+      int s = x > 0 ? 1 : -1;
+      if (rnd != std::round_to_nearest && flag == -s)
+        return s * half::maxval();
+      flag = s;
+      return s * std::numeric_limits<float>::infinity();
+    }
+  };
+
+  template<> class real_format<half> : public binary16_format {
+  public:
+    static half convert(float x, std::float_round_style rnd, int& flag)
+    { return half::from_bits(half::encode(overflow(x, rnd, flag))); }
+  };
+
+  template<> class real_format<bfloat16> {
+  public:
+    typedef float compute_type;
+    static const unsigned radix = 2U;
+    static int digits() { return 8; }
+    static int min_exponent() { return std::numeric_limits<float>::
+        min_exponent; }
+    static bool denorm() { return true; }
+    static float min() { return std::numeric_limits<float>::min(); }
+    // The integer part of a u_rand is less than 2^32; so there's no overflow
+    static bfloat16 convert(float x, std::float_round_style, int&) {
+      std::uint32_t u; std::memcpy(&u, &x, sizeof(u));
+      return bfloat16::from_bits(std::uint16_t(u >> 16));
+    }
+  };
+
+  template<typename Int, int F> class real_format<fixed_q<Int, F> > {
+  public:
+    typedef double compute_type;
+    static const unsigned radix = 2U;
+    // All the numbers less than 2^(digits - F) are "subnormal"
+    static int digits() { return std::numeric_limits<Int>::digits; }
+    static int min_exponent() { return digits() - F; }
+    static bool denorm() { return true; }
+    static double min() { return std::ldexp(1.0, -F); }
+    static fixed_q<Int, F> convert(double x, std::float_round_style,
+                                   int& flag) {
+      double t = std::ldexp(x, F);
+      Int r = fixed_q<Int, F>::saturate(t);
+      if (double(r) != t) flag = double(r) < t ? -1 : 1;
+      return fixed_q<Int, F>::from_raw(r);
+    }
+  };
+
+#if defined(__FLT16_MANT_DIG__)
+  // The compiler's _Float16
+  template<> inline int real_digits<_Float16>() { return 11; }
+  template<> inline std::float_round_style real_round_style<_Float16>()
+  { return std::round_to_nearest; }
+  template<> class real_format<_Float16> : public binary16_format {
+  public:
+    static _Float16 convert(float x, std::float_round_style rnd, int& flag)
+    { return static_cast<_Float16>(overflow(x, rnd, flag)); }
+  };
+#endif
+
+#if defined(__BFLT16_MANT_DIG__)
+  // The compiler's __bf16
+  template<> inline int real_digits<__bf16>() { return 8; }
+  template<> inline std::float_round_style real_round_style<__bf16>()
+  { return std::round_to_nearest; }
+  template<> class real_format<__bf16> : public real_format<bfloat16> {
+  public:
+    static __bf16 convert(float x, std::float_round_style, int&)
+    { return static_cast<__bf16>(x); }
+  };
+#endif
+#endif
+
+}
+
+namespace std {
+
+  /**
+   * @brief std::numeric_limits for exrandom::half.
+   */
+  template<> class numeric_limits<exrandom::half> {
+  public:
+    static const bool is_specialized = true;
+    static exrandom::half min()
+    { return exrandom::half::from_bits(0x0400U); }
+    static exrandom::half max()
+    { return exrandom::half::from_bits(0x7bffU); }
+    static exrandom::half lowest()
+    { return exrandom::half::from_bits(0xfbffU); }
+    static const int digits = 11;
+    static const int digits10 = 3;
+    static const int max_digits10 = 5;
+    static const bool is_signed = true;
+    static const bool is_integer = false;
+    static const bool is_exact = false;
+    static const int radix = 2;
+    static exrandom::half epsilon()
+    { return exrandom::half::from_bits(0x1400U); }
+    static exrandom::half round_error()
+    { return exrandom::half::from_bits(0x3800U); }
+    static const int min_exponent = -13;
+    static const int min_exponent10 = -4;
+    static const int max_exponent = 16;
+    static const int max_exponent10 = 4;
+    static const bool has_infinity = true;
+    static const bool has_quiet_NaN = true;
+    static const bool has_signaling_NaN = true;
+    static const float_denorm_style has_denorm = denorm_present;
+    static const bool has_denorm_loss = false;
+    static exrandom::half infinity()
+    { return exrandom::half::from_bits(0x7c00U); }
+    static exrandom::half quiet_NaN()
+    { return exrandom::half::from_bits(0x7e00U); }
+    static exrandom::half signaling_NaN()
+    { return exrandom::half::from_bits(0x7d00U); }
+    static exrandom::half denorm_min()
+    { return exrandom::half::from_bits(0x0001U); }
+    static const bool is_iec559 = true;
+    static const bool is_bounded = true;
+    static const bool is_modulo = false;
+    static const bool traps = false;
+    static const bool tinyness_before = false;
+    static const float_round_style round_style = round_to_nearest;
+  };
+
+  /**
+   * @brief std::numeric_limits for exrandom::bfloat16.
+   */
+  template<> class numeric_limits<exrandom::bfloat16> {
+  public:
+    static const bool is_specialized = true;
+    static exrandom::bfloat16 min()
+    { return exrandom::bfloat16::from_bits(0x0080U); }
+    static exrandom::bfloat16 max()
+    { return exrandom::bfloat16::from_bits(0x7f7fU); }
+    static exrandom::bfloat16 lowest()
+    { return exrandom::bfloat16::from_bits(0xff7fU); }
+    static const int digits = 8;
+    static const int digits10 = 2;
+    static const int max_digits10 = 4;
+    static const bool is_signed = true;
+    static const bool is_integer = false;
+    static const bool is_exact = false;
+    static const int radix = 2;
+    static exrandom::bfloat16 epsilon()
+    { return exrandom::bfloat16::from_bits(0x3c00U); }
+    static exrandom::bfloat16 round_error()
+    { return exrandom::bfloat16::from_bits(0x3f00U); }
+    static const int min_exponent = -125;
+    static const int min_exponent10 = -37;
+    static const int max_exponent = 128;
+    static const int max_exponent10 = 38;
+    static const bool has_infinity = true;
+    static const bool has_quiet_NaN = true;
+    static const bool has_signaling_NaN = true;
+    static const float_denorm_style has_denorm = denorm_present;
+    static const bool has_denorm_loss = false;
+    static exrandom::bfloat16 infinity()
+    { return exrandom::bfloat16::from_bits(0x7f80U); }
+    static exrandom::bfloat16 quiet_NaN()
+    { return exrandom::bfloat16::from_bits(0x7fc0U); }
+    static exrandom::bfloat16 signaling_NaN()
+    { return exrandom::bfloat16::from_bits(0x7fa0U); }
+    static exrandom::bfloat16 denorm_min()
+    { return exrandom::bfloat16::from_bits(0x0001U); }
+    static const bool is_iec559 = false;
+    static const bool is_bounded = true;
+    static const bool is_modulo = false;
+    static const bool traps = false;
+    static const bool tinyness_before = false;
+    static const float_round_style round_style = round_to_nearest;
+  };
+
+  /**
+   * @brief std::numeric_limits for exrandom::fixed_q.
+   */
+  template<typename Int, int F> class numeric_limits<exrandom::fixed_q<Int, F> >
+  {
+  public:
+    static const bool is_specialized = true;
+    static exrandom::fixed_q<Int, F> min()
+    { return exrandom::fixed_q<Int, F>::from_raw(Int(1)); }
+    static exrandom::fixed_q<Int, F> max()
+    { return exrandom::fixed_q<Int, F>::from_raw(numeric_limits<Int>::max()); }
+    static exrandom::fixed_q<Int, F> lowest() {
+      return exrandom::fixed_q<Int, F>::from_raw(numeric_limits<Int>::lowest());
+    }
+    static const int digits = numeric_limits<Int>::digits;
+    static const int digits10 = numeric_limits<Int>::digits10;
+    static const int max_digits10 = numeric_limits<Int>::digits10 + 1;
+    static const bool is_signed = numeric_limits<Int>::is_signed;
+    static const bool is_integer = false;
+    static const bool is_exact = true;
+    static const int radix = 2;
+    static exrandom::fixed_q<Int, F> epsilon() { return min(); }
+    static exrandom::fixed_q<Int, F> round_error() { return min(); }
+    static const int min_exponent = 0;
+    static const int min_exponent10 = 0;
+    static const int max_exponent = 0;
+    static const int max_exponent10 = 0;
+    static const bool has_infinity = false;
+    static const bool has_quiet_NaN = false;
+    static const bool has_signaling_NaN = false;
+    static const float_denorm_style has_denorm = denorm_absent;
+    static const bool has_denorm_loss = false;
+    static exrandom::fixed_q<Int, F> infinity()
+    { return exrandom::fixed_q<Int, F>(); }
+    static exrandom::fixed_q<Int, F> quiet_NaN()
+    { return exrandom::fixed_q<Int, F>(); }
+    static exrandom::fixed_q<Int, F> signaling_NaN()
+    { return exrandom::fixed_q<Int, F>(); }
+    static exrandom::fixed_q<Int, F> denorm_min() { return min(); }
+    static const bool is_iec559 = false;
+    static const bool is_bounded = true;
+    static const bool is_modulo = false;
+    static const bool traps = false;
+    static const bool tinyness_before = false;
+    static const float_round_style round_style = round_to_nearest;
+  };
+
+}
+
+#endif  // EXRANDOM_LOW_PRECISION_HPP
@@ -0,0 +1,261 @@
+/**
+ * @file mapped_file_gen.hpp
+ * @author Charles Karney <charles.karney@sri.com>
+ * @brief Definition of mapped_file_gen
+ *
+ * Copyright (c) Charles Karney (2016) and licensed under the MIT/X11 License.
+ * For more information, see http://exrandom.sourceforge.net/
+ */
+
+#if !defined(EXRANDOM_MAPPED_FILE_GEN_HPP)
+#define EXRANDOM_MAPPED_FILE_GEN_HPP 1
+
+#include <string>
+#include <fstream>              // for the state file
+#include <cstdint>              // for uint64_t
+#include <stdexcept>            // for std::runtime_error
+
+#include <exrandom/exrandom_config.hpp>
+
+#if defined(_WIN32)
+#  if !defined(NOMINMAX)
+#    define NOMINMAX 1
+#  endif
+#  include <windows.h>
+#else
+#  include <sys/types.h>
+#  include <sys/stat.h>
+#  include <sys/mman.h>
+#  include <fcntl.h>
+#  include <unistd.h>
+#endif
+
+namespace exrandom {
+
+  /**
+   * @brief A random number engine which returns the bits of a file.
+   *
+   * This memory-maps a file of random bits (e.g., a capture from a hardware
+   * random number generator) and returns its contents as a sequence of
+   * 64-bit words, with the first byte of each group of 8 the most
+   * significant.  No copy of the file is made; only the pages which are
+   * used are read, so the file may be many GB in size.  If the size of the
+   * file is not a multiple of 8 bytes, the trailing 1 to 7 bytes are
+   * ignored (size() gives the number of whole words used).
+   *
+   * The usual way to use this is as the engine for buffered_rand_digit<b>,
+   * which then turns the bits of the file, in order, into digits in base
+   * @e b without wasting any bits (if @e b is a power of two, the digits
+   * are just the successive groups of bits).  It can also be used with
+   * rand_digit, which takes 32 bits for each digit in a power-of-two base.
+   *
+   * The behavior when the end of the file is reached is specified by
+   * mapped_file_gen::end_policy in the constructor.  With
+   * mapped_file_gen::wrap, the main loop need not handle exceptions;
+   * instead exhausted() should be checked, e.g., after each sample or each
+   * batch of samples.  (There's no policy of returning zeros at the end of
+   * the file, because the samplers compare u-rands digit by digit until
+   * two digits differ and so would never return.)
+   *
+   * If a state file is given to the constructor, the position in the file
+   * is read from it at the outset and written to it by the destructor (or
+   * by save()); thus successive runs use successive sections of the file.
+   */
+  class mapped_file_gen {
+  public:
+    /**
+     * The type of the results.
+     */
+    typedef std::uint64_t result_type;
+    /**
+     * What to do when the file is exhausted.
+     */
+    enum end_policy {
+      /**
+       * Throw std::runtime_error (like table_gen).
+       */
+      fail,
+      /**
+       * Start again at the beginning of the file and set exhausted().  (If
+       * the file is empty, std::runtime_error is thrown.)
+       */
+      wrap
+    };
+#if EXRANDOM_CONSTEXPR
+    /**
+     * @return the smallest result.
+     */
+    static constexpr result_type min() { return 0U; }
+    /**
+     * @return the largest result.
+     */
+    static constexpr result_type max() { return ~result_type(0); }
+#else
+    static result_type min() { return 0U; }
+    static result_type max() { return ~result_type(0); }
+#endif
+    /**
+     * The constructor.
+     *
+     * @param file the name of the file of random bits.
+     * @param policy the end_policy.
+     * @param state the name of the file in which to keep the position (if
+     *   empty, the position isn't kept).
+     * @exception std::runtime_error if @e file can't be mapped into memory.
+     *
+     * Any trailing bytes of @e file after the last whole 64-bit word are
+     * ignored.
+     */
+    explicit mapped_file_gen(const std::string& file,
+                             end_policy policy = fail,
+                             const std::string& state = "")
+      : _p(0), _n(0U), _pos(0U), _policy(policy), _exhausted(false)
+      , _state(state) {
+      map(file);
+      if (!_state.empty()) {
+        std::ifstream s(_state.c_str());
+        unsigned long long pos;
+        if (s >> pos) seek(pos);
+      }
+    }
+    /**
+     * The destructor.
+     *
+     * This calls save() and unmaps the file.
+     */
+    ~mapped_file_gen() {
+      try { save(); } catch (...) {}
+      unmap();
+    }
+    /**
+     * @return the next 64 bits of the file.
+     */
+    result_type operator()() {
+      if (_pos >= _n) return end();
+      const unsigned char* q = _p + 8 * _pos++;
+      result_type r = 0;
+      for (int i = 0; i < 8; ++i) r = (r << 8) | q[i];
+      return r;
+    }
+    /**
+     * Skip over results.
+     *
+     * @param n the number of 64-bit words to skip.
+     */
+    void discard(unsigned long long n) { seek(_pos + n); }
+    /**
+     * @return the number of whole 64-bit words in the file.
+     */
+    unsigned long long size() const { return _n; }
+    /**
+     * @return the position in the file in 64-bit words.
+     */
+    unsigned long long tell() const { return _pos; }
+    /**
+     * Set the position in the file.
+     *
+     * @param pos the position in 64-bit words.
+     *
+     * Seeking beyond the end of the file is treated as reaching the end.
+     */
+    void seek(unsigned long long pos) {
+      if (pos <= _n)
+        _pos = pos;
+      else {
+        _pos = _n;
+        if (_policy == wrap && _n > 0U) _pos = pos % _n;
+        if (_policy == wrap) _exhausted = true;
+      }
+    }
+    /**
+     * @return whether the end of the file has been reached with the policy
+     *   mapped_file_gen::wrap.
+     */
+    bool exhausted() const { return _exhausted; }
+    /**
+     * Write the position to the state file (if one was given).
+     *
+     * @exception std::runtime_error if the state file can't be written.
+     */
+    void save() const {
+      if (_state.empty()) return;
+      std::ofstream s(_state.c_str());
+      if (!(s << _pos << "\n"))
+        throw std::runtime_error("mapped_file_gen: cannot write " + _state);
+    }
+  private:
+    // Disable copy constructor and copy assignment
+    mapped_file_gen(const mapped_file_gen&);
+    mapped_file_gen& operator=(const mapped_file_gen&);
+    const unsigned char* _p;    // the mapped file
+    unsigned long long _n, _pos; // the size and position in words
+    end_policy _policy;
+    bool _exhausted;
+    std::string _state;
+#if defined(_WIN32)
+    unsigned long long _bytes;
+#else
+    size_t _bytes;
+#endif
+    result_type end() {
+      if (_policy == wrap && _n) {
+        _exhausted = true; _pos = 0U; return (*this)();
+      }
+      throw std::runtime_error("mapped_file_gen: end of file");
+    }
+    void map(const std::string& file) {
+      _bytes = 0U;
+#if defined(_WIN32)
+      HANDLE f = CreateFileA(file.c_str(), GENERIC_READ, FILE_SHARE_READ, 0,
+                             OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, 0);
+      LARGE_INTEGER size;
+      if (f == INVALID_HANDLE_VALUE || !GetFileSizeEx(f, &size)) {
+        if (f != INVALID_HANDLE_VALUE) CloseHandle(f);
+        throw std::runtime_error("mapped_file_gen: cannot open " + file);
+      }
+      _bytes = (unsigned long long)(size.QuadPart);
+      if (_bytes) {
+        HANDLE m = CreateFileMappingA(f, 0, PAGE_READONLY, 0, 0, 0);
+        void* p = m ? MapViewOfFile(m, FILE_MAP_READ, 0, 0, 0) : 0;
+        if (m) CloseHandle(m);
+        CloseHandle(f);
+        if (!p) throw std::runtime_error("mapped_file_gen: cannot map " + file);
+        _p = static_cast<const unsigned char*>(p);
+      } else
+        CloseHandle(f);
+#else
+      int fd = ::open(file.c_str(), O_RDONLY);
+      struct stat st;
+      if (fd < 0 || ::fstat(fd, &st) != 0) {
+        if (fd >= 0) ::close(fd);
+        throw std::runtime_error("mapped_file_gen: cannot open " + file);
+      }
+      _bytes = size_t(st.st_size);
+      if (_bytes) {
+        void* p = ::mmap(0, _bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (p == MAP_FAILED)
+          throw std::runtime_error("mapped_file_gen: cannot map " + file);
+#if defined(MADV_SEQUENTIAL)
+        ::madvise(p, _bytes, MADV_SEQUENTIAL);
+#endif
+        _p = static_cast<const unsigned char*>(p);
+      } else
+        ::close(fd);
+#endif
+      _n = _bytes / 8U;
+    }
+    void unmap() {
+      if (!_p) return;
+#if defined(_WIN32)
+      UnmapViewOfFile(_p);
+#else
+      ::munmap(const_cast<unsigned char*>(_p), _bytes);
+#endif
+      _p = 0;
+    }
+  };
+
+}
+
+#endif  // EXRANDOM_MAPPED_FILE_GEN_HPP
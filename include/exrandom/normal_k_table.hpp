@@ -0,0 +1,214 @@
+/**
+ * @file normal_k_table.hpp
+ * @author Charles Karney <charles.karney@sri.com>
+ * @brief Definition of normal_k_table
+ *
+ * Copyright (c) Charles Karney (2016) and licensed under the MIT/X11 License.
+ * For more information, see http://exrandom.sourceforge.net/
+ */
+
+#if !defined(EXRANDOM_NORMAL_K_TABLE_HPP)
+#define EXRANDOM_NORMAL_K_TABLE_HPP 1
+
+#include <vector>               // for the tables
+#include <cstdint>              // for uint32_t, uint64_t
+
+#include <exrandom/u_rand.hpp>
+#include <exrandom/fixed_point.hpp>
+
+#if defined(_MSC_VER)
+// Squelch warnings about constant conditional expressions
+#  pragma warning (push)
+#  pragma warning (disable: 4127)
+#endif
+
+namespace exrandom {
+
+  /**
+   * @brief Carry out steps 1 and 2 of Algorithms N and D using a table.
+   *
+   * @tparam b the base for the digits.
+   *
+   * Steps 1 and 2 of Algorithms N and D select an integer k &ge; 0 with
+   * probability (1 &minus; e<sup>&minus;1/2</sup>) e<sup>&minus;k/2</sup>
+   * and then accept it with probability e<sup>&minus;k(k&minus;1)/2</sup>;
+   * thus k is accepted with probability q<sub>k</sub> = (1 &minus;
+   * e<sup>&minus;1/2</sup>) e<sup>&minus;k<sup>2</sup>/2</sup>.  In
+   * operator()(g, u), this is done with a single uniform deviate u &isin;
+   * [0,1) by dividing [0,1) into consecutive intervals:
+   * - K intervals of lengths q<sub>k</sub> for k &isin; [0, K) (k accepted);
+   * - an interval of length e<sup>&minus;K/2</sup> (k &ge; K which should
+   *   be determined with the original steps 1 and 2);
+   * - the remainder (k rejected).
+   * .
+   * This gives exactly the same distribution of outcomes as the original
+   * steps.  The digits of u are generated as needed to determine which
+   * interval it lies in.  The boundaries of the intervals are tabulated in
+   * base @e b together with rigorous error bounds; in the unlikely event
+   * that this precision is insufficient, the boundaries are recomputed with
+   * greater precision.  Usually only one digit of u (with @e b =
+   * 2<sup>32</sup>) is needed, replacing several evaluations of Algorithm H.
+   *
+   * The table for the default precision is available via
+   * normal_k_table::standard().
+   */
+  template<uint_t b> class normal_k_table {
+  public:
+    /**
+     * The base for the digits (or 0 if the base is 2<sup>32</sup>).
+     */
+    static const uint_t base = digit_arithmetic<b>::base;
+    /**
+     * The number of values of k which are tabulated.
+     */
+    static const int K = 16;
+    /**
+     * Construct the table.
+     *
+     * @param w the number of 32-bit words of binary precision used in
+     *   computing the boundaries (at least 2).
+     */
+    explicit normal_k_table(int w)
+      : _n(size_t(32 * (w - 1) / bits)), _lo((K + 1) * _n), _hi((K + 1) * _n)
+    { init(w); }
+    /**
+     * @return a reference to a table computed with the default precision.
+     */
+    static const normal_k_table& standard() {
+      static const normal_k_table t(6);
+      return t;
+    }
+    /**
+     * @return the number of digits used for each boundary.
+     */
+    size_t ndigits() const { return _n; }
+    /**
+     * Perform steps 1 and 2.
+     *
+     * @tparam Generator the type of g.
+     * @tparam digit_gen the type of digit generator.
+     * @tparam store the digit_store for u.
+     * @param g the random generator engine.
+     * @param u a u_rand, which is initialized and used as a uniform deviate.
+     * @return k &isin; [0, K) if k is accepted, K if k &ge; K, and K + 1 if
+     *   k is rejected.
+     */
+    template<typename Generator, typename digit_gen, typename store>
+    int operator()(Generator& g, u_rand<digit_gen, store>& u) const {
+      static_assert(digit_gen::base == base,
+                    "normal_k_table: mismatch in base");
+      u.init();
+      for (int j = 0; j <= K; ++j) {
+        int c = compare(g, u, j);
+        for (int w = 2 * _w; c == 0; w *= 2)
+          c = normal_k_table(w).compare(g, u, j);
+        if (c < 0) return j;
+      }
+      return K + 1;
+    }
+  private:
+    static const int bits = digit_arithmetic<b>::bits;
+    typedef fixed_point::number fixed;
+    int _w;
+    size_t _n;
+    // Lower and upper bounds on the boundaries as _n digits; boundary j is
+    // the upper end of interval j.
+    std::vector<uint_t> _lo, _hi;
+
+    // Compare u with boundary j, returning -1 if u < c, +1 if u > c, and 0
+    // if this can't be determined with the precision of the table.
+    template<typename Generator, typename digit_gen, typename store>
+    int compare(Generator& g, u_rand<digit_gen, store>& u, int j) const {
+      const uint_t* lo = &_lo[j * _n], * hi = &_hi[j * _n];
+      bool eqlo = true, eqhi = true;
+      for (size_t i = 0; i < _n && (eqlo || eqhi); ++i) {
+        uint_t d = u.digit(g, i);
+        if (eqlo) {
+          if (d < lo[i]) return -1;
+          eqlo = d == lo[i];
+        }
+        if (eqhi) {
+          if (d > hi[i]) return +1;
+          eqhi = d == hi[i];
+        }
+      }
+      return 0;
+    }
+
+    // Set digits [n*j, n*(j+1)) of v to the first n base-b digits of the
+    // fraction of a, rounding up if up.
+    void todigits(const fixed& a, std::vector<uint_t>& v, int j,
+                  bool up) const {
+      const std::uint64_t lbase = base ? std::uint64_t(base) :
+        (std::uint64_t(1) << 32);
+      uint_t* d = &v[j * _n];
+      fixed f(a);
+      bool over = f[0] != 0U;
+      f[0] = 0U;
+      for (size_t i = 0; i < _n; ++i) {
+        std::uint64_t t = 0;
+        for (size_t k = f.size(); k-- > 1;) {
+          t += std::uint64_t(f[k]) * lbase;
+          f[k] = std::uint32_t(t); t >>= 32;
+        }
+        d[i] = uint_t(t);
+      }
+      if (up) {
+        // Add 1 in the last place; if this overflows (or if a >= 1) set all
+        // the digits to b - 1 (so that u > c is never concluded).
+        size_t i = _n;
+        while (!over && i-- && (d[i] = uint_t((d[i] + 1U) % lbase)) == 0U)
+          if (i == 0) over = true;
+        if (over)
+          for (i = 0; i < _n; ++i) d[i] = uint_t(lbase - 1U);
+      }
+    }
+    void init(int w) {
+      typedef fixed_point F;
+      _w = w;
+      const size_t n = size_t(w) + 1;
+      fixed one(n, 0U), zero(n, 0U);
+      one[0] = 1U;
+      // h = exp(-1/2) = sum((-1/2)^m/m!), m = 0, 1, ...
+      fixed tlo(one), thi(one), plo(one), phi(one), qlo(zero), qhi(zero);
+      for (std::uint32_t m = 1; !F::tiny(thi); ++m) {
+        F::div(tlo, 2 * m, false); F::div(thi, 2 * m, true);
+        if (m % 2) { F::add(qlo, tlo); F::add(qhi, thi); }
+        else       { F::add(plo, tlo); F::add(phi, thi); }
+      }
+      // The remainder is bounded by the last term, thi <= 1 ulp
+      fixed hlo(plo), hhi(phi);
+      F::sub(hlo, qhi); F::sub(hlo, thi);
+      F::sub(hhi, qlo); F::add(hhi, thi);
+      // 1 - h
+      fixed glo(one), ghi(one);
+      F::sub(glo, hhi); F::sub(ghi, hlo);
+      fixed h2lo = F::mul(hlo, hlo, false), h2hi = F::mul(hhi, hhi, true);
+      // p = exp(-k^2/2), r = exp(-(2*k+1)/2), c = sum(q_k)
+      fixed plk(one), phk(one), rlo(hlo), rhi(hhi), clo(zero), chi(zero);
+      for (int k = 0; k < K; ++k) {
+        if (k > 0) {
+          plk = F::mul(plk, rlo, false); phk = F::mul(phk, rhi, true);
+          rlo = F::mul(rlo, h2lo, false); rhi = F::mul(rhi, h2hi, true);
+        }
+        F::add(clo, F::mul(glo, plk, false));
+        F::add(chi, F::mul(ghi, phk, true));
+        todigits(clo, _lo, k, false); todigits(chi, _hi, k, true);
+      }
+      // The interval for k >= K has length exp(-K/2) = h^K
+      fixed elo(one), ehi(one);
+      for (int k = 0; k < K; ++k) {
+        elo = F::mul(elo, hlo, false); ehi = F::mul(ehi, hhi, true);
+      }
+      F::add(clo, elo); F::add(chi, ehi);
+      todigits(clo, _lo, K, false); todigits(chi, _hi, K, true);
+    }
+  };
+
+}
+
+#if defined(_MSC_VER)
+#  pragma warning (pop)
+#endif
+
+#endif  // EXRANDOM_NORMAL_K_TABLE_HPP
@@ -0,0 +1,190 @@
+/**
+ * @file normal_tail_dist.hpp
+ * @author Charles Karney <charles.karney@sri.com>
+ * @brief Definition of normal_tail_dist
+ *
+ * Copyright (c) Charles Karney (2016) and licensed under the MIT/X11 License.
+ * For more information, see http://exrandom.sourceforge.net/
+ */
+
+#if !defined(EXRANDOM_NORMAL_TAIL_DIST_HPP)
+#define EXRANDOM_NORMAL_TAIL_DIST_HPP 1
+
+#include <limits>
+#include <stdexcept>            // for std::runtime_error
+
+#include <exrandom/u_rand.hpp>
+#include <exrandom/unit_normal_dist.hpp>
+#include <exrandom/unit_exponential_dist.hpp>
+#include <exrandom/scaled_u_rand.hpp>
+
+namespace exrandom {
+
+  /**
+   * @brief Sample exactly from the tails of the unit normal distribution.
+   *
+   * @tparam digit_gen the type of digit generator; the base must be a power
+   *   of two.
+   *
+   * This samples from the unit normal distribution conditioned on |x| &gt;
+   * t, where t = t_num/t_den &ge; 0 is rational; the sign of the result is
+   * random (take the absolute value to sample a single tail).  The cost is
+   * bounded independent of t; by contrast, rejecting the results of
+   * unit_normal_dist with |x| &le; t takes exp(t<sup>2</sup>/2) samples on
+   * average.
+   *
+   * For t &ge; 1, the result is t + E/t where E is a unit exponential
+   * u-rand (from unit_exponential_dist) and this is accepted with
+   * probability exp(&minus;w<sup>2</sup>/2) where w = E/t.  With 2<sup>j</sup>
+   * &ge; w, this probability is the product of 4<sup>j</sup> Bernoulli trials
+   * with probability exp(&minus;v<sup>2</sup>/2) where v = w/2<sup>j</sup>
+   * &le; 1, each of which is carried out with Algorithm B (with k = 0) using
+   * u_rand::less_than with multipliers to compare uniform u-rands with v.
+   * The probability of acceptance exceeds 0.65.  For t &lt; 1, samples from
+   * unit_normal_dist with |x| &le; t are rejected (with probability less
+   * than 0.69); this uses u_rand::compare.  In both cases, no rounding takes
+   * place until the sample is accepted; the result is then converted to a
+   * floating point number with scaled_u_rand (or u_rand::value).
+   *
+   * t_num and t_den are limited to 2<sup>14</sup>.
+   */
+  template<typename digit_gen>
+  class normal_tail_dist {
+  public:
+    /**
+     * The constructor.
+     *
+     * @param D a reference to the digit generator to be used.
+     * @param t_num the numerator of t.
+     * @param t_den the denominator of t.
+     * @exception std::runtime_error if the parameters are out of range.
+     */
+    normal_tail_dist(digit_gen& D, int t_num, int t_den = 1)
+      : _D(D), _N(D), _E(D), _u(D), _y(D), _z(D)
+      , _t_num(check(t_num, t_den)), _t_den(t_den)
+      , _S(_u, t_num, t_den, t_den, t_num ? t_num : 1) {}
+
+    /**
+     * Generate the next deviate and round it to a floating point number.
+     *
+     * @tparam RealType the floating point type of the result.
+     * @tparam Generator the type of g.
+     * @param g the random generator engine.
+     * @return the normal deviate with |x| &gt; t, rounded with the rounding
+     *   style of RealType.
+     */
+    template<typename RealType, typename Generator>
+    RealType value(Generator& g) {
+      return value<RealType, Generator>
+        (g, std::numeric_limits<RealType>::round_style);
+    }
+    /**
+     * Generate the next deviate with specified rounding.
+     *
+     * @tparam RealType the floating point type of the result.
+     * @tparam Generator the type of g.
+     * @param g the random generator engine.
+     * @param rnd the rounding mode (see scaled_u_rand::value).
+     * @return the normal deviate with |x| &gt; t.
+     */
+    template<typename RealType, typename Generator>
+    RealType value(Generator& g, std::float_round_style rnd) {
+      if (_t_num < _t_den) {
+        for (;;) {
+          _N.generate(g, _u);
+          if (_t_num == 0) break;
+          // Test |x| > t
+          bool neg = _u.sign() < 0;
+          if (neg) _u.negate();
+          bool accept = _u.compare(g, 0, _t_num, _t_den) > 0;
+          if (neg) _u.negate();
+          if (accept) break;
+        }
+        int flag;
+        return _u.template value<RealType>(g, rnd, flag);
+      }
+      for (;;) {
+        _E.generate(g, _u);
+        // Smallest j with E <= 2^j * t; j <= 30 because the integer part of
+        // E is less than 2^30 and t >= 1.
+        int j = 0;
+        while (_u.compare(g, (long long)(_t_num) << j,
+                          (long long)(_t_num) << j, _t_den) > 0)
+          ++j;
+        long long n = 1LL << (2 * j);
+        while (n && B(g, j)) --n;
+        if (!n) break;
+      }
+      bool neg = _y.init().less_than_half(g);
+      RealType x = _S.template value<RealType>(g, neg ? mirror(rnd) : rnd);
+      return neg ? -x : x;
+    }
+
+    /**
+     * @return the numerator of t.
+     */
+    int t_num() const { return _t_num; }
+    /**
+     * @return the denominator of t.
+     */
+    int t_den() const { return _t_den; }
+    /**
+     * @return a reference to the digit generator used in the constructor.
+     */
+    digit_gen& digit_generator() const { return _D; }
+
+    /**
+     * The base of the digit generator.
+     */
+    static const uint_t base = digit_gen::base;
+  private:
+    static const int maxt = 1 << 14;
+    static_assert(digit_gen::power_of_two,
+                  "normal_tail_dist: base must be a power of two");
+    // Disable copy construction (_S refers to _u) and copy assignment
+    normal_tail_dist(const normal_tail_dist&);
+    normal_tail_dist& operator=(const normal_tail_dist&);
+    digit_gen& _D;
+    unit_normal_dist<digit_gen> _N;
+    unit_exponential_dist<digit_gen> _E;
+    u_rand<digit_gen> _u, _y, _z; // temporary storage
+    int _t_num, _t_den;
+    scaled_u_rand<digit_gen> _S; // t + _u/t
+
+    static int check(int t_num, int t_den) {
+      if (!(t_den > 0 && t_num >= 0))
+        throw std::runtime_error("normal_tail_dist: need t_den > 0, t >= 0");
+      if (!(t_num <= maxt && t_den <= maxt))
+        throw std::runtime_error("normal_tail_dist: t_num or t_den too big");
+      return t_num;
+    }
+
+    // Rounding mode for -x so that -(result) is rounded in direction rnd.
+    static std::float_round_style mirror(std::float_round_style rnd) {
+      return rnd == std::round_toward_infinity ?
+        std::round_toward_neg_infinity :
+        (rnd == std::round_toward_neg_infinity ?
+         std::round_toward_infinity : rnd);
+    }
+
+    // Algorithm B with k = 0: true with prob exp(-v^2/2) where v = E/(t*2^j)
+    // = E*t_den/(t_num*2^j) <= 1.  The uniform u_rands are compared with v
+    // and v/2 by u_rand::less_than with multipliers b = t_num*2^j and 2*b.
+    template<typename Generator>
+    bool B(Generator& g, int j) {
+      long long b = (long long)(_t_num) << j;
+      int n = 0;
+      for (;; ++n) {
+        if (!(n ? _z.init().less_than(g, _y) :
+              _z.init().less_than(g, b, _u, _t_den)))
+          break;
+        if (!_y.init().less_than(g, 2 * b, _u, _t_den)) break;
+        _y.swap(_z);            // an efficient way of doing y = z
+      }
+      return (n % 2) == 0;
+    }
+  };
+
+}
+
+#endif  // EXRANDOM_NORMAL_TAIL_DIST_HPP
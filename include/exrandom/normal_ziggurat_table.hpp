@@ -0,0 +1,194 @@
+/**
+ * @file normal_ziggurat_table.hpp
+ * @author Charles Karney <charles.karney@sri.com>
+ * @brief Definition of normal_ziggurat_table
+ *
+ * Copyright (c) Charles Karney (2016) and licensed under the MIT/X11 License.
+ * For more information, see http://exrandom.sourceforge.net/
+ */
+
+#if !defined(EXRANDOM_NORMAL_ZIGGURAT_TABLE_HPP)
+#define EXRANDOM_NORMAL_ZIGGURAT_TABLE_HPP 1
+
+#include <vector>               // for the tables
+#include <cstdint>              // for uint32_t, uint64_t
+#include <cstddef>              // for size_t
+
+#include <exrandom/u_rand.hpp>
+#include <exrandom/fixed_point.hpp>
+
+namespace exrandom {
+
+  /**
+   * @brief Carry out step 4 of Algorithm N using a table.
+   *
+   * @tparam b the base for the digits, a power of two no less than
+   *   2<sup>8</sup>.
+   *
+   * Step 4 of Algorithm N accepts the fraction x &isin; [0,1) of the
+   * deviate with probability p<sub>k</sub>(x) = exp(&minus;x(2k +
+   * x)/2).  The original algorithm does this with k + 1 applications of
+   * Algorithm B.  Here, instead, the test is carried out as y &lt;
+   * p<sub>k</sub>(x) where y is a uniform u-rand.  For k &lt; K, [0,1) is
+   * divided into M strips according to the leading bits of x, and, for each
+   * strip, lower and upper bounds on p<sub>k</sub>(x) are tabulated; these
+   * are the rectangles of a ziggurat lying inside and outside the curve
+   * p<sub>k</sub>(x).  The first digits of x and y then usually suffice to
+   * decide the test.  At the edges of the rectangles, digits of x and y are
+   * added, one at a time, and the test is decided with rigorous bounds on
+   * p<sub>k</sub>(x) computed with fixed point arithmetic.  Thus the result
+   * is exact and x remains a u-rand whose subsequent digits are generated
+   * lazily.
+   *
+   * The table is computed once and is available via
+   * normal_ziggurat_table::standard().
+   */
+  template<uint_t b> class normal_ziggurat_table {
+  public:
+    /**
+     * The base for the digits (or 0 if the base is 2<sup>32</sup>).
+     */
+    static const uint_t base = digit_arithmetic<b>::base;
+    /**
+     * The number of values of k which are tabulated.
+     */
+    static const int K = 4;
+    /**
+     * The base 2 logarithm of the number of strips.
+     */
+    static const int m = 8;
+    /**
+     * The number of strips.
+     */
+    static const int M = 1 << m;
+    /**
+     * Construct the table.
+     */
+    normal_ziggurat_table() : _t(4 * K * M) { init(); }
+    /**
+     * @return a reference to the table.
+     */
+    static const normal_ziggurat_table& standard() {
+      static const normal_ziggurat_table t;
+      return t;
+    }
+    /**
+     * Perform step 4.
+     *
+     * @tparam Generator the type of g.
+     * @tparam digit_gen the type of digit generator.
+     * @tparam store1 the digit_store for x.
+     * @tparam store2 the digit_store for y.
+     * @param g the random generator engine.
+     * @param k the integer part of the deviate, in [0, K).
+     * @param x the fraction of the deviate, which is initialized before
+     *   use.
+     * @param y a u_rand, which is initialized and used as a uniform deviate.
+     * @return true with probability exp(&minus;x(2k + x)/2).
+     */
+    template<typename Generator, typename digit_gen,
+             typename store1, typename store2>
+    bool operator()(Generator& g, int k, u_rand<digit_gen, store1>& x,
+                    u_rand<digit_gen, store2>& y) const {
+      static_assert(digit_gen::base == base,
+                    "normal_ziggurat_table: mismatch in base");
+      // Quantities are scaled by 2^32; the first digit of x gives the strip
+      // and x - a in [t, t + dt), where a = j/M and dt = 2^-bits.
+      const std::uint64_t dt = std::uint64_t(1) << (32 - bits),
+        mask = (std::uint64_t(1) << (bits - m)) - 1U;
+      uint_t d = x.init().digit(g, 0);
+      const std::uint64_t* c = &_t[4 * (size_t(k * M) + (d >> (bits - m)))];
+      std::uint64_t t = (std::uint64_t(d) & mask) << (32 - bits),
+        // lower and upper bounds on p_k(x)
+        plo = ((t + dt) * c[2] + 0xffffffffULL) >> 32,
+        phi = c[1] - ((t * c[3]) >> 32);
+      plo = plo < c[0] ? c[0] - plo : 0U;
+      // y in [u, u + dt)
+      std::uint64_t u = std::uint64_t(y.init().digit(g, 0)) << (32 - bits);
+      if (u + dt <= plo) return true;
+      if (u >= phi) return false;
+      return exact(g, k, x, y);
+    }
+  private:
+    static const int bits = digit_arithmetic<b>::bits;
+    static_assert(digit_arithmetic<b>::power_of_two && bits >= m,
+                  "normal_ziggurat_table: base must be a power of two "
+                  "no less than 2^8");
+    typedef fixed_point F;
+    typedef F::number fixed;
+    // For strip j, i.e., x in [a, a + h) with a = j/M and h = 1/M, the 4
+    // elements of _t starting at 4*(k*M + j) are, scaled by 2^32,
+    // - a lower bound on p_k(a),
+    // - an upper bound on p_k(a),
+    // - an upper bound on the slope (k + a + h) p_k(a),
+    // - a lower bound on the slope (k + a) p_k(a + h).
+    // Since p_k is decreasing and |p_k'(x)| = (k + x) p_k(x), p_k(x) lies
+    // between p_k(a) - (x - a) * the first slope and p_k(a) - (x - a) * the
+    // second slope.
+    std::vector<std::uint64_t> _t;
+    // Set z to bounds on x * (2*k + x) / 2.
+    static fixed zbound(const fixed& x, int k, bool up) {
+      fixed s(x);
+      s[0] += std::uint32_t(2 * k);
+      fixed z = F::mul(x, s, up);
+      F::div(z, 2U, up);
+      return z;
+    }
+    // Bounds on p_k(x) for x given exactly.
+    static fixed pbound(const fixed& x, int k, bool up) {
+      fixed lo, hi;
+      F::expneg(zbound(x, k, !up), lo, hi);
+      return up ? hi : lo;
+    }
+    // The first n digits of u as a fixed point number with w words in the
+    // fraction.  If up, add 1 in the last digit.
+    template<typename digit_gen, typename store>
+    static fixed tofixed(const u_rand<digit_gen, store>& u, size_t n,
+                         size_t w, bool up)
+    { return F::digits(u, bits, n, w, up); }
+    // Decide y < p_k(x) by generating more digits of x and y.
+    template<typename Generator, typename digit_gen,
+             typename store1, typename store2>
+    static bool exact(Generator& g, int k, u_rand<digit_gen, store1>& x,
+                      u_rand<digit_gen, store2>& y) {
+      for (size_t n = 2;; ++n) {
+        x.digit(g, n - 1); y.digit(g, n - 1);
+        size_t w = (n * bits + 31) / 32 + 2;
+        // x in [xlo, xhi), y in [ylo, yhi)
+        fixed
+          plo = pbound(tofixed(x, n, w, true), k, false),
+          phi = pbound(tofixed(x, n, w, false), k, true);
+        if (!F::less(plo, tofixed(y, n, w, true))) return true;
+        if (!F::less(tofixed(y, n, w, false), phi)) return false;
+      }
+    }
+    // A fixed point number in [0, 2^32) scaled by 2^32, rounded up if up
+    static std::uint64_t scaled(const fixed& a, bool up) {
+      bool inexact = false;
+      for (size_t i = 2; i < a.size(); ++i) inexact = inexact || a[i] != 0U;
+      return ((std::uint64_t(a[0]) << 32) | a[1]) + (up && inexact ? 1U : 0U);
+    }
+    void init() {
+      const size_t w = 3;
+      for (int k = 0; k < K; ++k) {
+        for (int j = 0; j < M; ++j) {
+          fixed a(w + 1, 0U), ah(w + 1, 0U);
+          a[1] = std::uint32_t(j) << (32 - m);
+          if (j + 1 < M) ah[1] = std::uint32_t(j + 1) << (32 - m);
+          else ah[0] = 1U;
+          fixed plo = pbound(a, k, false), phi = pbound(a, k, true),
+            phlo = pbound(ah, k, false), ka(a), kah(ah);
+          ka[0] += std::uint32_t(k); kah[0] += std::uint32_t(k);
+          std::uint64_t* c = &_t[4 * size_t(k * M + j)];
+          c[0] = scaled(plo, false);
+          c[1] = scaled(phi, true);
+          c[2] = scaled(F::mul(kah, phi, true), true);
+          c[3] = scaled(F::mul(ka, phlo, false), false);
+        }
+      }
+    }
+  };
+
+}
+
+#endif  // EXRANDOM_NORMAL_ZIGGURAT_TABLE_HPP
@@ -0,0 +1,247 @@
+/**
+ * @file perf_stats.hpp
+ * @author Charles Karney <charles.karney@sri.com>
+ * @brief Definition of perf_stats
+ *
+ * Copyright (c) Charles Karney (2016) and licensed under the MIT/X11 License.
+ * For more information, see http://exrandom.sourceforge.net/
+ */
+
+#if !defined(EXRANDOM_PERF_STATS_HPP)
+#define EXRANDOM_PERF_STATS_HPP 1
+
+#include <iostream>             // for std::ostream
+#include <iomanip>              // for std::setw
+#include <cstring>              // for std::memset
+#include <cstdint>              // for std::uint64_t
+
+#include <exrandom/sample_stats.hpp>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#define EXRANDOM_PERF_EVENTS 1
+#else
+#define EXRANDOM_PERF_EVENTS 0
+#endif
+
+namespace exrandom {
+
+  /**
+   * @brief A statistics policy which also records hardware performance
+   * counters for each sample_stage.
+   *
+   * This extends sample_stats by reading the cycle, branch-miss, and
+   * cache-miss counters of the CPU (via perf_event_open on Linux) at the
+   * start of each sample and at the end of each sample_stage, attributing
+   * the counts to the stages in the same way as the digits.  The counters
+   * only include user-space events for the calling thread; the cost of
+   * reading the counters, measured by the constructor, is subtracted.  If
+   * the counters can't be opened (a platform other than Linux,
+   * /proc/sys/kernel/perf_event_paranoid too restrictive, or no hardware
+   * support), available() returns false and only the sample_stats counts
+   * are recorded.
+   *
+   * Because the counters are read for each stage, which takes a system
+   * call, this is much slower than sample_stats; use it to find where the
+   * time goes, not to time the distributions.  A perf_stats belongs to the
+   * thread which constructs it.  See profile_distributions.cpp for an
+   * example.
+   */
+  class perf_stats : public sample_stats {
+  public:
+    /**
+     * The hardware counters.  num gives the number of counters.
+     */
+    enum counter { cycles = 0, branch_misses, cache_misses, num };
+    /**
+     * The constructor (this opens the counters).
+     */
+    perf_stats() : sample_stats() { open(); reset(); }
+    /**
+     * The copy constructor.
+     *
+     * @param s the perf_stats to copy.
+     *
+     * The counts are copied and the copy opens its own counters.
+     */
+    perf_stats(const perf_stats& s) : sample_stats(s) {
+      open();
+      std::memcpy(_counts, s._counts, sizeof(_counts));
+    }
+    /**
+     * The assignment operator (only the counts are copied).
+     *
+     * @param s the perf_stats to copy.
+     * @return *this.
+     */
+    perf_stats& operator=(const perf_stats& s) {
+      sample_stats::operator=(s);
+      std::memcpy(_counts, s._counts, sizeof(_counts));
+      return *this;
+    }
+    /**
+     * The destructor (this closes the counters).
+     */
+    ~perf_stats() {
+#if EXRANDOM_PERF_EVENTS
+      for (int k = 0; k < num; ++k) if (_fd[k] >= 0) close(_fd[k]);
+#endif
+    }
+    /**
+     * Set all the counts to zero.
+     */
+    void reset() {
+      sample_stats::reset();
+      std::memset(_counts, 0, sizeof(_counts));
+    }
+    /**
+     * @return whether the hardware counters are being read.
+     */
+    bool available() const { return _available; }
+    /**
+     * @param k a counter.
+     * @param s a sample_stage.
+     * @return the count of @e k in stage @e s.
+     */
+    long long count(counter k, sample_stage::type s) const
+    { return _counts[k][s]; }
+    /**
+     * @param k a counter.
+     * @return the total count of @e k.
+     */
+    long long count(counter k) const {
+      long long n = 0;
+      for (int i = 0; i < sample_stage::num; ++i) n += _counts[k][i];
+      return n;
+    }
+    /**
+     * Add the counts from another perf_stats.
+     *
+     * @param s the other perf_stats.
+     * @return *this.
+     */
+    perf_stats& operator+=(const perf_stats& s) {
+      sample_stats::operator+=(s);
+      for (int k = 0; k < num; ++k)
+        for (int i = 0; i < sample_stage::num; ++i)
+          _counts[k][i] += s._counts[k][i];
+      return *this;
+    }
+    /**
+     * Print a summary of the counts (the sample_stats summary followed by a
+     * table of the counters per sample for each stage).
+     *
+     * @param os an output stream.
+     * @param s the perf_stats.
+     * @return os.
+     */
+    friend std::ostream& operator<<(std::ostream& os, const perf_stats& s) {
+      static const char* const names[sample_stage::num] =
+        {"G", "P", "X", "B", "sign", "round"};
+      os << static_cast<const sample_stats&>(s);
+      if (!s._available) {
+        os << "hardware counters not available\n";
+        return os;
+      }
+      double n = double(s.samples() > 0 ? s.samples() : 1);
+      os << "per sample:  stage   digits   cycles  branch-misses"
+         << "  cache-misses\n";
+      for (int i = 0; i < sample_stage::num; ++i) {
+        sample_stage::type t = sample_stage::type(i);
+        os << std::setw(19) << names[i] << std::fixed << std::setprecision(2)
+           << std::setw(9) << s.digits(t) / n
+           << std::setw(9) << s.count(cycles, t) / n
+           << std::setw(15) << s.count(branch_misses, t) / n
+           << std::setw(14) << s.count(cache_misses, t) / n << "\n";
+      }
+      os.unsetf(std::ios::floatfield);
+      return os;
+    }
+    /// \cond SKIP
+    // The interface used by the distributions
+    template<typename digit_gen>
+    long long start(const digit_gen& D) {
+      if (_available) read(_last);
+      return sample_stats::start(D);
+    }
+    template<typename digit_gen>
+    void tally(sample_stage::type s, const digit_gen& D, long long& c) {
+      sample_stats::tally(s, D, c);
+      if (_available) {
+        std::uint64_t v[num];
+        read(v);
+        for (int k = 0; k < num; ++k) {
+          long long d = (long long)(v[k] - _last[k]) - _overhead[k];
+          _counts[k][s] += d > 0 ? d : 0;
+          _last[k] = v[k];
+        }
+      }
+    }
+    /// \endcond
+  private:
+    int _fd[num];
+    bool _available;
+    std::uint64_t _last[num];
+    long long _overhead[num];
+    long long _counts[num][sample_stage::num];
+
+    // Open the counters as a group (so they are read together) and measure
+    // the counts for reading them.
+    void open() {
+      _available = false;
+      for (int k = 0; k < num; ++k)
+        { _fd[k] = -1; _last[k] = 0; _overhead[k] = 0; }
+#if EXRANDOM_PERF_EVENTS
+      static const unsigned long long config[num] = {
+        PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_BRANCH_MISSES,
+        PERF_COUNT_HW_CACHE_MISSES
+      };
+      for (int k = 0; k < num; ++k) {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = config[k];
+        attr.read_format = PERF_FORMAT_GROUP;
+        attr.disabled = k == 0 ? 1 : 0;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        _fd[k] = int(syscall(__NR_perf_event_open, &attr, 0, -1,
+                             k == 0 ? -1 : _fd[0], 0));
+        if (_fd[k] < 0) {
+          for (int i = 0; i < k; ++i) { close(_fd[i]); _fd[i] = -1; }
+          return;
+        }
+      }
+      ioctl(_fd[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+      _available = true;
+      // The smallest counts for an empty interval
+      std::uint64_t a[num], b[num];
+      for (int k = 0; k < num; ++k) _overhead[k] = -1;
+      for (int j = 0; j < 100; ++j) {
+        read(a); read(b);
+        for (int k = 0; k < num; ++k) {
+          long long d = (long long)(b[k] - a[k]);
+          if (_overhead[k] < 0 || d < _overhead[k]) _overhead[k] = d;
+        }
+      }
+#endif
+    }
+    void read(std::uint64_t v[]) {
+#if EXRANDOM_PERF_EVENTS
+      std::uint64_t buf[1 + num];
+      if (::read(_fd[0], buf, sizeof(buf)) == ssize_t(sizeof(buf))) {
+        for (int k = 0; k < num; ++k) v[k] = buf[1 + k];
+        return;
+      }
+#endif
+      for (int k = 0; k < num; ++k) v[k] = _last[k];
+    }
+  };
+
+}
+
+#endif  // EXRANDOM_PERF_STATS_HPP
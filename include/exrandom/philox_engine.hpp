@@ -0,0 +1,225 @@
+/**
+ * @file philox_engine.hpp
+ * @author Charles Karney <charles.karney@sri.com>
+ * @brief Definition of philox_engine
+ *
+ * Copyright (c) Charles Karney (2016) and licensed under the MIT/X11 License.
+ * For more information, see http://exrandom.sourceforge.net/
+ */
+
+#if !defined(EXRANDOM_PHILOX_ENGINE_HPP)
+#define EXRANDOM_PHILOX_ENGINE_HPP 1
+
+#include <iostream>             // for std::ostream, etc.
+#include <cstdint>              // for uint32_t, uint64_t
+
+#include <exrandom/digit_arithmetic.hpp>
+
+#if defined(_MSC_VER) && defined(_M_X64)
+#  include <intrin.h>           // for _umul128
+#endif
+
+namespace exrandom {
+
+  /**
+   * @brief A counter-based random number engine.
+   *
+   * This implements the Philox2x64-10 generator of Salmon et al.,
+   * <a href="https://doi.org/10.1145/2063384.2063405"> Parallel random
+   * numbers: as easy as 1, 2, 3</a> (2011).  The output for block @e n of
+   * stream @e s with key @e k is the Philox bijection, keyed by @e k, of the
+   * 128-bit counter (@e n, @e s); the two 64-bit results make up block @e n.
+   * Because there is no other state, the engine can move to any point in any
+   * stream in constant time.  Each key provides 2<sup>64</sup> streams each
+   * of length 2<sup>63</sup> 64-bit results; so it is easy to give each
+   * thread or each node of a cluster its own stream.  The results agree with
+   * the known-answer tests in the Random123 library.
+   *
+   * This satisfies the requirements for a C++11 random number engine with
+   * min() = 0 and max() = 2<sup>64</sup> &minus; 1.  In addition
+   * - discard(n) and jump() run in constant time;
+   * - next32() returns half a 64-bit result (the more significant half
+   *   first); when rand_digit is used with a power-of-two base, each digit
+   *   is taken from a call to next32() (see word32_engine);
+   * - tell() and seek(p) give and set the position in the stream in units
+   *   of 32 bits.
+   * .
+   * The last two features mean that rand_digit::count() gives the offset in
+   * the engine's stream (in units of 32 bits) for a power-of-two base.  So
+   * a particular sample from, e.g., unit_normal_dist can be reproduced
+   * exactly by recording the value of tell() before the sample is
+   * generated, and, later (possibly on another machine), resetting the
+   * engine with the same key and stream, calling seek(p), and generating
+   * the sample again.
+   */
+  class philox_engine {
+  public:
+    /**
+     * The type of the results.
+     */
+    typedef std::uint64_t result_type;
+    /**
+     * The default key.
+     */
+    static const result_type default_seed = 20111113ULL;
+#if EXRANDOM_CONSTEXPR
+    /**
+     * @return the smallest result.
+     */
+    static constexpr result_type min() { return 0U; }
+    /**
+     * @return the largest result.
+     */
+    static constexpr result_type max() { return ~result_type(0); }
+#else
+    static result_type min() { return 0U; }
+    static result_type max() { return ~result_type(0); }
+#endif
+    /**
+     * The constructor.
+     *
+     * @param key the key.
+     * @param stream the stream number.
+     */
+    explicit philox_engine(result_type key = default_seed,
+                           result_type stream = 0U)
+    { seed(key, stream); }
+    /**
+     * Start the stream @e stream with key @e key.
+     *
+     * @param key the key.
+     * @param stream the stream number.
+     */
+    void seed(result_type key = default_seed, result_type stream = 0U)
+    { _key = key; _stream = stream; _pos = 0U; _valid = false; _blk = 0U; }
+    /**
+     * @return the next 64-bit result.
+     */
+    result_type operator()() {
+      _pos += _pos & 1U;        // Skip an unused half of a result
+      fill();
+      result_type r = _out[(_pos >> 1) & 1U];
+      _pos += 2U;
+      return r;
+    }
+    /**
+     * @return the next 32 random bits.
+     */
+    std::uint32_t next32() {
+      fill();
+      std::uint32_t r = std::uint32_t(_out[(_pos >> 1) & 1U] >>
+                                      ((_pos & 1U) ? 0 : 32));
+      ++_pos;
+      return r;
+    }
+    /**
+     * Skip over results.
+     *
+     * @param n the number of 64-bit results to skip.
+     */
+    void discard(unsigned long long n) { _pos += (_pos & 1U) + 2U * n; }
+    /**
+     * Move to the start of the next stream.
+     */
+    void jump() { ++_stream; _pos = 0U; _valid = false; }
+    /**
+     * @return the position in the stream, in units of 32 bits.
+     *
+     * This is the number of calls to next32() since the start of the stream
+     * (each call to operator()() counts as two calls).  Positions beyond
+     * 2<sup>64</sup> are reduced modulo 2<sup>64</sup>.
+     */
+    unsigned long long tell() const { return _pos; }
+    /**
+     * Set the position in the stream.
+     *
+     * @param p the position in units of 32 bits.
+     */
+    void seek(unsigned long long p) { _pos = p; }
+    /**
+     * @return the key.
+     */
+    result_type key() const { return _key; }
+    /**
+     * @return the stream number.
+     */
+    result_type stream() const { return _stream; }
+    /**
+     * @return true if the engines will produce the same results.
+     */
+    friend bool operator==(const philox_engine& a, const philox_engine& b)
+    { return a._key == b._key && a._stream == b._stream && a._pos == b._pos; }
+    /**
+     * @return true if the engines will produce different results.
+     */
+    friend bool operator!=(const philox_engine& a, const philox_engine& b)
+    { return !(a == b); }
+    /**
+     * Inserts the state of the engine into the output stream @e os.
+     *
+     * @param os an output stream.
+     * @param e the engine.
+     * @return os.
+     */
+    friend std::ostream& operator<<(std::ostream& os, const philox_engine& e)
+    { os << e._key << " " << e._stream << " " << e._pos; return os; }
+    /**
+     * Extracts the state of the engine from the input stream @e is.
+     *
+     * @param is an input stream.
+     * @param e the engine.
+     * @return is.
+     */
+    friend std::istream& operator>>(std::istream& is, philox_engine& e) {
+      result_type key, stream; unsigned long long pos;
+      if (is >> key >> stream >> pos) { e.seed(key, stream); e.seek(pos); }
+      return is;
+    }
+  private:
+    result_type _key, _stream;
+    unsigned long long _pos;    // the position in units of 32 bits
+    bool _valid;                // is _out block _blk?
+    result_type _blk, _out[2];
+    // High and low halves of the product a * b
+    static result_type mulhilo(result_type a, result_type b,
+                               result_type& hi) {
+#if defined(__SIZEOF_INT128__)
+      unsigned __int128 p = (unsigned __int128)a * b;
+      hi = result_type(p >> 64);
+      return result_type(p);
+#elif defined(_MSC_VER) && defined(_M_X64)
+      return _umul128(a, b, &hi);
+#else
+      const result_type m = 0xffffffffULL;
+      result_type
+        a0 = a & m, a1 = a >> 32, b0 = b & m, b1 = b >> 32,
+        p00 = a0 * b0, p01 = a0 * b1, p10 = a1 * b0, p11 = a1 * b1,
+        mid = (p00 >> 32) + (p01 & m) + (p10 & m);
+      hi = p11 + (p01 >> 32) + (p10 >> 32) + (mid >> 32);
+      return a * b;
+#endif
+    }
+    // Compute the block containing _pos if necessary
+    void fill() {
+      result_type blk = _pos >> 2;
+      if (_valid && blk == _blk) return;
+      result_type x0 = blk, x1 = _stream, k = _key, hi, lo;
+      for (int r = 0; r < 10; ++r) {
+        if (r) k += 0x9E3779B97F4A7C15ULL; // the Weyl sequence for the key
+        lo = mulhilo(0xD2B74407B1CE6E93ULL, x0, hi);
+        x0 = hi ^ k ^ x1; x1 = lo;
+      }
+      _out[0] = x0; _out[1] = x1; _blk = blk; _valid = true;
+    }
+  };
+
+  /// \cond SKIP
+  template<> class word32_engine<philox_engine> {
+  public:
+    static const bool value = true;
+  };
+  /// \endcond
+
+}
+
+#endif  // EXRANDOM_PHILOX_ENGINE_HPP
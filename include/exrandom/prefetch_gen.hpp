@@ -0,0 +1,207 @@
+/**
+ * @file prefetch_gen.hpp
+ * @author Charles Karney <charles.karney@sri.com>
+ * @brief Definition of prefetch_gen
+ *
+ * Copyright (c) Charles Karney (2016) and licensed under the MIT/X11 License.
+ * For more information, see http://exrandom.sourceforge.net/
+ */
+
+#if !defined(EXRANDOM_PREFETCH_GEN_HPP)
+#define EXRANDOM_PREFETCH_GEN_HPP 1
+
+#include <vector>               // for the ring buffer
+#include <atomic>               // for the indices of the ring buffer
+#include <thread>               // for the producer thread
+#include <chrono>               // for std::chrono::microseconds
+#include <exception>            // for std::exception_ptr
+#include <cstddef>              // for size_t
+#include <stdexcept>            // for std::runtime_error
+
+#include <exrandom/exrandom_config.hpp>
+
+namespace exrandom {
+
+  /**
+   * @brief A random number engine which prefetches the results of another
+   * engine in a background thread.
+   *
+   * @tparam Engine the type of the underlying engine.
+   *
+   * This is intended for engines with a high latency per call, e.g., a
+   * hardware source of random bits.  A producer thread calls the underlying
+   * engine and puts the results into a single-producer single-consumer ring
+   * buffer; operator()() takes them out without locking.  The results are
+   * the same, and in the same order, as calling the underlying engine
+   * directly.  Thus a prefetch_gen can be used as the engine for
+   * rand_digit, buffered_rand_digit, and the distributions, taking the
+   * latency of the engine off the critical path of the sampling loops.
+   *
+   * The producer adds results in blocks of @e block words, each published
+   * with a single atomic store, and stops when the buffer is full; the
+   * counts consumer_waits() and producer_waits() report how often the buffer
+   * was found empty (the latency was not hidden) and how often it was found
+   * full (the consumer is the bottleneck).  If the underlying engine throws
+   * an exception, the results it produced before the exception are returned
+   * and then operator()() throws the exception.
+   *
+   * The underlying engine is used by the producer thread for the lifetime
+   * of the prefetch_gen and must not be used or destroyed in the meantime.
+   * A prefetch_gen is used by a single consumer thread and cannot be copied.
+   */
+  template<typename Engine> class prefetch_gen {
+  public:
+    /**
+     * The type of the results.
+     */
+    typedef typename Engine::result_type result_type;
+#if EXRANDOM_CONSTEXPR
+    /**
+     * @return the smallest result.
+     */
+    static constexpr result_type min() { return Engine::min(); }
+    /**
+     * @return the largest result.
+     */
+    static constexpr result_type max() { return Engine::max(); }
+#else
+    static result_type min() { return Engine::min(); }
+    static result_type max() { return Engine::max(); }
+#endif
+    /**
+     * The constructor.
+     *
+     * @param g the underlying engine.
+     * @param depth the size of the ring buffer (this is rounded up to a
+     *   power of two).
+     * @param block the number of results added to the ring buffer at a time.
+     * @exception std::runtime_error if @e block is 0 or exceeds half of the
+     *   (rounded) depth.
+     *
+     * This starts the producer thread which fills the ring buffer.
+     */
+    explicit prefetch_gen(Engine& g, size_t depth = 4096, size_t block = 64)
+      : _g(g), _buf(round_depth(depth)), _mask(_buf.size() - 1)
+      , _block(check_block(block, _buf.size()))
+      , _r(0), _avail(0), _publish(_block), _consumer_waits(0), _tail(0)
+      , _head(0), _producer_waits(0), _stop(false), _failed(false) {
+      _thread = std::thread(&prefetch_gen::produce, this);
+    }
+    /**
+     * The destructor (this stops the producer thread).
+     */
+    ~prefetch_gen() {
+      _stop.store(true, std::memory_order_relaxed);
+      _thread.join();
+    }
+    /**
+     * @return the next result of the underlying engine.
+     * @exception any exception thrown by the underlying engine.
+     */
+    result_type operator()() {
+      if (_r == _avail) wait();
+      result_type x = _buf[_r++ & _mask];
+      // Release the space in blocks
+      if (_r == _publish) release();
+      return x;
+    }
+    /**
+     * @return the size of the ring buffer.
+     */
+    size_t depth() const { return _buf.size(); }
+    /**
+     * @return the number of results returned by operator()().
+     */
+    unsigned long long consumed() const { return _r; }
+    /**
+     * @return the number of results produced by the underlying engine so
+     *   far (some may not have been consumed yet).
+     */
+    unsigned long long produced() const
+    { return _head.load(std::memory_order_acquire); }
+    /**
+     * @return how many times operator()() found the buffer empty and had to
+     *   wait for the producer.
+     */
+    unsigned long long consumer_waits() const { return _consumer_waits; }
+    /**
+     * @return how many times the producer found the buffer full and had to
+     *   wait for the consumer.
+     */
+    unsigned long long producer_waits() const
+    { return _producer_waits.load(std::memory_order_relaxed); }
+  private:
+    // Disable copy constructor and copy assignment
+    prefetch_gen(const prefetch_gen&);
+    prefetch_gen& operator=(const prefetch_gen&);
+    Engine& _g;
+    std::vector<result_type> _buf;
+    const size_t _mask, _block;
+    // The consumer's data: the number of results read, the number known to
+    // be available, when next to publish the number read, and the published
+    // number read.  The indices are not reduced modulo the depth.  The
+    // padding puts the producer's data on a separate cache line.
+    size_t _r, _avail, _publish;
+    unsigned long long _consumer_waits;
+    std::atomic<size_t> _tail;
+    char _pad[64];
+    // The producer's data
+    std::atomic<size_t> _head;
+    std::atomic<unsigned long long> _producer_waits;
+    std::atomic<bool> _stop, _failed;
+    std::exception_ptr _error;
+    std::thread _thread;
+
+    static size_t round_depth(size_t depth) {
+      size_t n = 2;
+      while (n < depth) n *= 2;
+      return n;
+    }
+    static size_t check_block(size_t block, size_t depth) {
+      if (!(block > 0 && block <= depth / 2))
+        throw std::runtime_error("prefetch_gen: block out of range");
+      return block;
+    }
+    // Publish the number read (this makes space for the producer)
+    void release() {
+      _tail.store(_r, std::memory_order_release);
+      _publish = _r + _block;
+    }
+    // Wait until results are available (or rethrow the producer's exception)
+    void wait() {
+      release();
+      for (;;) {
+        bool failed = _failed.load(std::memory_order_acquire);
+        _avail = _head.load(std::memory_order_acquire);
+        if (_avail != _r) return;
+        if (failed) std::rethrow_exception(_error);
+        ++_consumer_waits;
+        std::this_thread::yield();
+      }
+    }
+    void produce() {
+      size_t w = 0, n = 0;
+      try {
+        while (!_stop.load(std::memory_order_relaxed)) {
+          if (w + _block - _tail.load(std::memory_order_acquire) >
+              _buf.size()) {
+            _producer_waits.fetch_add(1, std::memory_order_relaxed);
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+            continue;
+          }
+          for (n = 0; n < _block; ++n) _buf[(w + n) & _mask] = _g();
+          w += _block; n = 0;
+          _head.store(w, std::memory_order_release);
+        }
+      } catch (...) {
+        // Publish the results produced before the exception
+        _error = std::current_exception();
+        _head.store(w + n, std::memory_order_release);
+        _failed.store(true, std::memory_order_release);
+      }
+    }
+  };
+
+}
+
+#endif  // EXRANDOM_PREFETCH_GEN_HPP
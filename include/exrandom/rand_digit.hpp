@@ -12,6 +12,8 @@
 
 #include <random>               // for uniform_int_distribution
 #include <cmath>                // for std::ldexp
+#include <type_traits>          // for std::integral_constant
+#include <cstddef>              // for size_t
 
 #include <exrandom/digit_arithmetic.hpp>
 
@@ -65,21 +67,24 @@ namespace exrandom {
     template<typename Generator>
     uint_t operator()(Generator& g) { // a random digit
       ++_count;
-      if ( power_of_two &&
-           Generator::min() == 0UL &&
-           Generator::max() == 0xffffffffUL )
-        // optimize for std::mt19937 which creates 32 bits of randomness
-        return uint_t(g() >> (32 - bits));
-      else if ( power_of_two &&
-                Generator::min() == 0UL &&
-                Generator::max() == 0xffffffffffffffffULL )
-        // optimize for std::mt19937_64 which creates 64 bits of randomness
-        return uint_t((g() & 0xffffffffUL) >> (32 - bits));
-      else {
-        // In some cases _gen loses track of its parameters, so supply them
-        // here instead of in the constructor.
-        return _gen(g, uint_random_t::param_type(min_value, max_value));
-      }
+      return digit(g, source<Generator>());
+    }
+    /**
+     * Produce several random digits.
+     *
+     * @tparam Generator the type of g.
+     * @param g the random generator engine.
+     * @param[out] p where to put the digits.
+     * @param n the number of digits.
+     *
+     * The digits are the same as @e n calls to operator()(g) would return;
+     * but the count is only updated once.
+     */
+    template<typename Generator>
+    void generate(Generator& g, uint_t* p, size_t n) {
+      _count += n;
+      for (uint_t* e = p + n; p != e; ++p)
+        *p = digit(g, source<Generator>());
     }
     /**
      * @return the count.
@@ -98,6 +103,46 @@ namespace exrandom {
     typedef std::uniform_int_distribution<uint_t>  uint_random_t;
     uint_random_t _gen;
     long long _count;
+    // How to get a digit from Generator, selected at compile time: 1 = the
+    // top of next32(), 32 (or 64) = the top of an engine word of 32 (or 64)
+    // bits, 0 = _gen, -1 = check the range of the engine at run time.
+    template<typename Generator> class source :
+      public std::integral_constant<int, !power_of_two ? 0 :
+                                    word32_engine<Generator>::value ? 1 :
+                                    engine_bits<Generator>::value == 32 ? 32 :
+                                    engine_bits<Generator>::value == 64 ? 64 :
+                                    engine_bits<Generator>::value < 0 ?
+                                    -1 : 0> {};
+    // Take the digit from the top of the next 32 bits (e.g., philox_engine)
+    template<typename Generator>
+    uint_t digit(Generator& g, std::integral_constant<int, 1>)
+    { return uint_t(g.next32() >> (32 - bits)); }
+    // optimize for std::mt19937 which creates 32 bits of randomness
+    template<typename Generator>
+    uint_t digit(Generator& g, std::integral_constant<int, 32>)
+    { return uint_t(g() >> (32 - bits)); }
+    // optimize for std::mt19937_64 which creates 64 bits of randomness
+    template<typename Generator>
+    uint_t digit(Generator& g, std::integral_constant<int, 64>)
+    { return uint_t((g() & 0xffffffffUL) >> (32 - bits)); }
+    template<typename Generator>
+    uint_t digit(Generator& g, std::integral_constant<int, 0>) {
+      // In some cases _gen loses track of its parameters, so supply them
+      // here instead of in the constructor.
+      return _gen(g, uint_random_t::param_type(min_value, max_value));
+    }
+    // The range of the engine isn't known at compile time
+    template<typename Generator>
+    uint_t digit(Generator& g, std::integral_constant<int, -1>) {
+      if ( Generator::min() == 0UL &&
+           Generator::max() == 0xffffffffUL )
+        return digit(g, std::integral_constant<int, 32>());
+      else if ( Generator::min() == 0UL &&
+                Generator::max() == 0xffffffffffffffffULL )
+        return digit(g, std::integral_constant<int, 64>());
+      else
+        return digit(g, std::integral_constant<int, 0>());
+    }
   };
 
 }
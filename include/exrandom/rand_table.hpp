@@ -10,6 +10,8 @@
 #if !defined(EXRANDOM_RAND_TABLE_HPP)
 #define EXRANDOM_RAND_TABLE_HPP 1
 
+#include <cstddef>              // for size_t
+
 #include <exrandom/digit_arithmetic.hpp>
 
 namespace exrandom {
@@ -51,6 +53,15 @@ namespace exrandom {
     template<typename Generator>
     uint_t operator()(Generator& g)
     { ++_count; return g(); }
+    /**
+     * @tparam Generator the type of g.
+     * @param g the random generator engine.
+     * @param[out] p where to put the digits.
+     * @param n the number of digits.
+     */
+    template<typename Generator>
+    void generate(Generator& g, uint_t* p, size_t n)
+    { _count += n; for (uint_t* e = p + n; p != e; ++p) *p = g(); }
     /**
      * @return the count.
      */
@@ -0,0 +1,214 @@
+/**
+ * @file sample_stats.hpp
+ * @author Charles Karney <charles.karney@sri.com>
+ * @brief Definition of sample_stage, no_stats, and sample_stats
+ *
+ * Copyright (c) Charles Karney (2016) and licensed under the MIT/X11 License.
+ * For more information, see http://exrandom.sourceforge.net/
+ */
+
+#if !defined(EXRANDOM_SAMPLE_STATS_HPP)
+#define EXRANDOM_SAMPLE_STATS_HPP 1
+
+#include <iostream>             // for std::ostream
+#include <algorithm>            // for std::min
+
+namespace exrandom {
+
+  /**
+   * @brief The stages of an algorithm to which digits are attributed.
+   *
+   * The mapping of the stages to the steps of the algorithms is
+   * - G: step 1 of Algorithms N and D; with @e tabulated = true this includes
+   *   the table lookup for steps 1 and 2.
+   * - P: step 2 of Algorithms N and D.
+   * - X: sampling the fraction; step 3 of Algorithm D, the whole of
+   *   Algorithms E and V, the exponential deviates in Algorithm K.
+   * - B: step 4 of Algorithms N and D (Algorithm B), the acceptance test in
+   *   Algorithm K.
+   * - sign: step 6 of Algorithms N and D, the sign in Algorithm K.
+   * - round: the conversion of the result to a number by value() or
+   *   operator()().
+   */
+  struct sample_stage {
+    /**
+     * The stages.  num gives the number of stages.
+     */
+    enum type { G = 0, P, X, B, sign, round, num };
+  };
+
+  /**
+   * @brief The default statistics policy which collects nothing.
+   *
+   * This is the default value of the @e stats template parameter of
+   * unit_normal_dist, unit_exponential_dist, discrete_normal_dist, and
+   * unit_normal_kahn.  All its member functions do nothing and are inlined
+   * away; thus there's no cost to the instrumentation.  See sample_stats
+   * for a description of the member functions.
+   */
+  class no_stats {
+  public:
+    /**
+     * Are statistics being collected?
+     */
+    static const bool enabled = false;
+    /// \cond SKIP
+    template<typename digit_gen>
+    long long start(const digit_gen& /*D*/) const { return 0; }
+    template<typename digit_gen>
+    void tally(sample_stage::type /*s*/, const digit_gen& /*D*/,
+               long long& /*c*/) {}
+    void reject(int /*step*/) {}
+    void sample() {}
+    /// \endcond
+  };
+
+  /**
+   * @brief A statistics policy which records where digits are used.
+   *
+   * Specify this as the @e stats template parameter of unit_normal_dist,
+   * unit_exponential_dist, discrete_normal_dist, or unit_normal_kahn to
+   * record
+   * - the number of samples;
+   * - the number of digits used in each sample_stage;
+   * - the number of rejections at each step of the algorithm (each rejection
+   *   restarts the algorithm);
+   * - a histogram of the number of restarts needed for each sample.
+   * .
+   * The statistics are available via the @e statistics() member function of
+   * the distribution.  The digits are counted with digit_gen::count(); so
+   * if several objects share a digit generator, digits are only attributed
+   * correctly if the objects are used one at a time.
+   *
+   * In a multi-threaded application, use a separate distribution (and
+   * therefore a separate sample_stats) in each thread and combine the
+   * results with operator+=.
+   */
+  class sample_stats {
+  public:
+    /**
+     * Are statistics being collected?
+     */
+    static const bool enabled = true;
+    /**
+     * The number of bins in the histogram of restarts.  The last bin counts
+     * the samples with nhist &minus; 1 or more restarts.
+     */
+    static const int nhist = 16;
+    /**
+     * The maximum step number for which rejections are counted.
+     */
+    static const int maxstep = 7;
+    /**
+     * The constructor.  All the counters are zero.
+     */
+    sample_stats() { reset(); }
+    /**
+     * Set all the counters to zero.
+     */
+    void reset() {
+      _samples = _cur = 0;
+      for (int i = 0; i < sample_stage::num; ++i) _digits[i] = 0;
+      for (int i = 0; i <= maxstep; ++i) _rejects[i] = 0;
+      for (int i = 0; i < nhist; ++i) _hist[i] = 0;
+    }
+    /**
+     * @return the number of samples.
+     */
+    long long samples() const { return _samples; }
+    /**
+     * @param s a sample_stage.
+     * @return the number of digits used in stage @e s.
+     */
+    long long digits(sample_stage::type s) const { return _digits[s]; }
+    /**
+     * @return the total number of digits used.
+     */
+    long long digits() const {
+      long long n = 0;
+      for (int i = 0; i < sample_stage::num; ++i) n += _digits[i];
+      return n;
+    }
+    /**
+     * @param step the step of the algorithm.
+     * @return the number of rejections at step @e step.
+     */
+    long long rejects(int step) const
+    { return step >= 0 && step <= maxstep ? _rejects[step] : 0; }
+    /**
+     * @return the total number of restarts.
+     */
+    long long restarts() const {
+      long long n = 0;
+      for (int i = 0; i <= maxstep; ++i) n += _rejects[i];
+      return n;
+    }
+    /**
+     * @param n the number of restarts.
+     * @return the number of samples which needed @e n restarts (or, if @e n
+     *   = nhist &minus; 1, @e n or more restarts).
+     */
+    long long restart_histogram(int n) const
+    { return n >= 0 && n < nhist ? _hist[n] : 0; }
+    /**
+     * Add the counts from another sample_stats.
+     *
+     * @param s the other sample_stats.
+     * @return *this.
+     */
+    sample_stats& operator+=(const sample_stats& s) {
+      _samples += s._samples; _cur += s._cur;
+      for (int i = 0; i < sample_stage::num; ++i) _digits[i] += s._digits[i];
+      for (int i = 0; i <= maxstep; ++i) _rejects[i] += s._rejects[i];
+      for (int i = 0; i < nhist; ++i) _hist[i] += s._hist[i];
+      return *this;
+    }
+    /**
+     * Add two sets of counts.
+     *
+     * @param a the first sample_stats.
+     * @param b the second sample_stats.
+     * @return the combined counts.
+     */
+    friend sample_stats operator+(sample_stats a, const sample_stats& b)
+    { return a += b; }
+    /**
+     * Print a summary of the counts.
+     *
+     * @param os an output stream.
+     * @param s the sample_stats.
+     * @return os.
+     */
+    friend std::ostream& operator<<(std::ostream& os, const sample_stats& s) {
+      static const char* const names[sample_stage::num] =
+        {"G", "P", "X", "B", "sign", "round"};
+      os << "samples " << s._samples << "\ndigits";
+      for (int i = 0; i < sample_stage::num; ++i)
+        os << " " << names[i] << " " << s._digits[i];
+      os << "\nrejects";
+      for (int i = 1; i <= maxstep; ++i)
+        if (s._rejects[i]) os << " step" << i << " " << s._rejects[i];
+      os << "\nrestarts";
+      for (int i = 0; i < nhist; ++i) os << " " << s._hist[i];
+      os << "\n";
+      return os;
+    }
+    /// \cond SKIP
+    // The interface used by the distributions
+    template<typename digit_gen>
+    long long start(const digit_gen& D) const { return D.count(); }
+    template<typename digit_gen>
+    void tally(sample_stage::type s, const digit_gen& D, long long& c)
+    { long long n = D.count(); _digits[s] += n - c; c = n; }
+    void reject(int step) { ++_rejects[step]; ++_cur; }
+    void sample()
+    { ++_samples; ++_hist[(std::min)(_cur, (long long)(nhist - 1))]; _cur = 0; }
+    /// \endcond
+  private:
+    long long _samples, _cur;   // _cur = restarts in current sample
+    long long _digits[sample_stage::num], _rejects[maxstep + 1], _hist[nhist];
+  };
+
+}
+
+#endif  // EXRANDOM_SAMPLE_STATS_HPP
@@ -0,0 +1,252 @@
+/**
+ * @file sample_stream.hpp
+ * @author Charles Karney <charles.karney@sri.com>
+ * @brief Definition of sample_stream
+ *
+ * Copyright (c) Charles Karney (2016) and licensed under the MIT/X11 License.
+ * For more information, see http://exrandom.sourceforge.net/
+ */
+
+#if !defined(EXRANDOM_SAMPLE_STREAM_HPP)
+#define EXRANDOM_SAMPLE_STREAM_HPP 1
+
+#include <iostream>             // for std::ostream, std::istream
+
+#include <exrandom/rand_digit.hpp>
+#include <exrandom/philox_engine.hpp>
+
+namespace exrandom {
+
+  /**
+   * @brief A reproducible stream of samples divided into independent blocks.
+   *
+   * @tparam b the base of the digits; this must be a power of two (the
+   *   default, b = 0, means 2<sup>32</sup>).
+   *
+   * This pairs a philox_engine with a rand_digit for use by the
+   * distributions.  Block @e i of the samples uses stream @e stream0 +
+   * @e i of the engine, so that a large job can be divided between the
+   * nodes of a cluster (e.g., the MPI rank @e r of @e R handles blocks
+   * @e r, @e r + @e R, ...) with each block starting in constant time and
+   * no communication needed.  Because each digit is taken from a call to
+   * philox_engine::next32(), the position in the engine's stream is the
+   * number of digits consumed since the start of the block.
+   *
+   * Call mark() before generating each sample with engine() (as the
+   * engine) and a distribution constructed with digit_generator() (as the
+   * digit generator); this returns a checkpoint which records the block,
+   * the index of the sample within the block, the position in the engine's
+   * stream, and the number of digits consumed.  Any sample can be
+   * regenerated later, possibly on another machine, by calling seek() with
+   * its checkpoint on a sample_stream with the same key and @e stream0.
+   *
+   * The distributions keep no state between samples (their u_rand
+   * temporaries are initialized at the start of each sample), so that the
+   * state of a sample_stream, written with operator<<() and read with
+   * operator>>(), allows a failed worker to resume in the middle of a block
+   * without replaying it.  u_rands held by the caller are saved with
+   * u_rand::serialize.
+   *
+   * Example:
+   * @code
+   * exrandom::sample_stream<> s(key);
+   * exrandom::unit_normal_dist<exrandom::rand_digit<0U> >
+   *   N(s.digit_generator());
+   * s.block(i);
+   * for (long long j = 0; j < n; ++j) {
+   *   exrandom::sample_stream<>::checkpoint c = s.mark();
+   *   double x = N.value<double>(s.engine());
+   *   // ... if x is of interest, save c
+   * }
+   * // later: s.seek(c); s.mark(); x = N.value<double>(s.engine());
+   * @endcode
+   */
+  template<uint_t b = 0U> class sample_stream {
+  public:
+    /**
+     * The type of the digit generator.
+     */
+    typedef rand_digit<b> digit_gen;
+    /**
+     * The type of the engine's key and stream number.
+     */
+    typedef philox_engine::result_type result_type;
+    /**
+     * @brief The position of a sample in a sample_stream.
+     */
+    class checkpoint {
+    public:
+      /**
+       * The block.
+       */
+      unsigned long long block;
+      /**
+       * The index of the sample in the block.
+       */
+      unsigned long long sample;
+      /**
+       * The position in the engine's stream (in units of 32 bits).
+       */
+      unsigned long long position;
+      /**
+       * The number of digits consumed in the block (equal to @e position).
+       */
+      long long count;
+      /**
+       * The constructor (for the start of block 0).
+       */
+      checkpoint() : block(0U), sample(0U), position(0U), count(0) {}
+      /**
+       * @return true if the checkpoints are the same.
+       */
+      friend bool operator==(const checkpoint& x, const checkpoint& y) {
+        return x.block == y.block && x.sample == y.sample &&
+          x.position == y.position && x.count == y.count;
+      }
+      /**
+       * @return true if the checkpoints differ.
+       */
+      friend bool operator!=(const checkpoint& x, const checkpoint& y)
+      { return !(x == y); }
+      /**
+       * Inserts a checkpoint into the output stream @e os.
+       *
+       * @param os an output stream.
+       * @param c the checkpoint.
+       * @return os.
+       */
+      friend std::ostream& operator<<(std::ostream& os, const checkpoint& c) {
+        os << c.block << " " << c.sample << " " << c.position << " "
+           << c.count;
+        return os;
+      }
+      /**
+       * Extracts a checkpoint from the input stream @e is.
+       *
+       * @param is an input stream.
+       * @param c the checkpoint.
+       * @return is.
+       */
+      friend std::istream& operator>>(std::istream& is, checkpoint& c) {
+        checkpoint t;
+        if (is >> t.block >> t.sample >> t.position >> t.count) c = t;
+        return is;
+      }
+    };
+    /**
+     * The constructor.
+     *
+     * @param key the key for the engine.
+     * @param stream0 the engine's stream for block 0.
+     *
+     * The sample_stream starts at the beginning of block 0.
+     */
+    explicit sample_stream(result_type key = philox_engine::default_seed,
+                           result_type stream0 = 0U)
+      : _g(key, stream0), _stream0(stream0), _block(0U), _sample(0U)
+      , _count0(0) {}
+    /**
+     * Move to the start of a block.
+     *
+     * @param i the block.
+     */
+    void block(unsigned long long i) {
+      checkpoint c; c.block = i;
+      seek(c);
+    }
+    /**
+     * Record the position of the next sample.
+     *
+     * @return the checkpoint for the sample about to be generated.
+     *
+     * This also advances the index of the sample in the block.
+     */
+    checkpoint mark() {
+      checkpoint c = position();
+      ++_sample;
+      return c;
+    }
+    /**
+     * @return the current position (this is the checkpoint that mark() would
+     *   return).
+     */
+    checkpoint position() const {
+      checkpoint c;
+      c.block = _block; c.sample = _sample; c.position = _g.tell();
+      c.count = _D.count() - _count0;
+      return c;
+    }
+    /**
+     * Move to a checkpoint.
+     *
+     * @param c the checkpoint.
+     *
+     * After this, mark() returns @e c and the digits and samples are those
+     * which followed @e c originally.
+     */
+    void seek(const checkpoint& c) {
+      _g.seed(_g.key(), _stream0 + c.block);
+      _g.seek(c.position);
+      _block = c.block; _sample = c.sample;
+      _count0 = _D.count() - c.count;
+    }
+    /**
+     * @return a reference to the engine for generating samples.
+     */
+    philox_engine& engine() { return _g; }
+    /**
+     * @return a reference to the digit generator for the distributions.
+     */
+    digit_gen& digit_generator() { return _D; }
+    /**
+     * @return the key of the engine.
+     */
+    result_type key() const { return _g.key(); }
+    /**
+     * @return the engine's stream for block 0.
+     */
+    result_type stream0() const { return _stream0; }
+    /**
+     * Inserts the state of a sample_stream into the output stream @e os.
+     *
+     * @param os an output stream.
+     * @param s the sample_stream.
+     * @return os.
+     */
+    friend std::ostream& operator<<(std::ostream& os, const sample_stream& s)
+    { os << s.key() << " " << s._stream0 << " " << s.position(); return os; }
+    /**
+     * Extracts the state of a sample_stream from the input stream @e is.
+     *
+     * @param is an input stream.
+     * @param s the sample_stream.
+     * @return is.
+     *
+     * The digit generator keeps its identity (so the distributions using
+     * it are unaffected); its count continues from its current value.
+     */
+    friend std::istream& operator>>(std::istream& is, sample_stream& s) {
+      result_type key, stream0; checkpoint c;
+      if (is >> key >> stream0 >> c) {
+        s._g.seed(key, stream0); s._stream0 = stream0;
+        s.seek(c);
+      }
+      return is;
+    }
+  private:
+    static_assert(digit_arithmetic<b>::power_of_two,
+                  "sample_stream: base must be a power of two");
+    // Disable copy constructor and copy assignment (the distributions refer
+    // to _D)
+    sample_stream(const sample_stream&);
+    sample_stream& operator=(const sample_stream&);
+    philox_engine _g;
+    digit_gen _D;
+    result_type _stream0;
+    unsigned long long _block, _sample;
+    long long _count0;          // _D.count() at the start of the block
+  };
+
+}
+
+#endif  // EXRANDOM_SAMPLE_STREAM_HPP
@@ -0,0 +1,196 @@
+/**
+ * @file samplers.hpp
+ * @author Charles Karney <charles.karney@sri.com>
+ * @brief Definition of per_thread and the sampling functions
+ *
+ * Copyright (c) Charles Karney (2016) and licensed under the MIT/X11 License.
+ * For more information, see http://exrandom.sourceforge.net/
+ */
+
+#if !defined(EXRANDOM_SAMPLERS_HPP)
+#define EXRANDOM_SAMPLERS_HPP 1
+
+#include <random>               // for std::mt19937_64, std::random_device
+
+#include <exrandom/exrandom_config.hpp>
+#include <exrandom/unit_uniform_distribution.hpp>
+#include <exrandom/unit_exponential_distribution.hpp>
+#include <exrandom/unit_normal_distribution.hpp>
+#include <exrandom/discrete_normal_distribution.hpp>
+
+#if !EXRANDOM_THREAD_LOCAL
+#error samplers.hpp needs a compiler which supports thread_local
+#endif
+
+namespace exrandom {
+
+  /**
+   * @brief A distribution for each thread.
+   *
+   * @tparam Distribution the type of the distribution, e.g.,
+   *   unit_normal_distribution<double>.
+   *
+   * per_thread<Distribution>::get() returns a reference to an instance of
+   * @e Distribution which belongs to the calling thread.  It is constructed
+   * (with the default constructor) on the first call in a thread.  Because
+   * the instance is not shared, it can be used without locking; and the
+   * digit generator and temporary u_rands which it holds are reused on
+   * subsequent calls.
+   */
+  template<typename Distribution> class per_thread {
+  public:
+    /**
+     * @return a reference to the distribution for the calling thread.
+     */
+    static Distribution& get() {
+      static thread_local Distribution d;
+      return d;
+    }
+  };
+
+  /**
+   * @return a reference to a random number engine for the calling thread.
+   *
+   * The engine is a std::mt19937_64 seeded with std::random_device on the
+   * first call in a thread.  Use thread_engine().seed(s) to obtain
+   * reproducible results.
+   *
+   * This is used by the versions of normal(), exponential(), uniform(), and
+   * discrete_normal() which don't take an engine argument.
+   */
+  inline std::mt19937_64& thread_engine() {
+    static thread_local std::mt19937_64 g(std::random_device{}());
+    return g;
+  }
+
+  /**
+   * Sample from the unit normal distribution.
+   *
+   * @tparam RealType the floating point type of the result.
+   * @tparam Generator the type of g.
+   * @param g the random generator engine.
+   * @return a normal deviate.
+   *
+   * This uses per_thread< unit_normal_distribution<RealType> >; so it is
+   * safe to call this concurrently from several threads provided that each
+   * thread uses its own engine @e g.  The results are the same as with
+   * unit_normal_distribution<RealType>.
+   */
+  template<typename RealType, typename Generator>
+  RealType normal(Generator& g)
+  { return per_thread< unit_normal_distribution<RealType> >::get()(g); }
+
+  /**
+   * Sample from the unit normal distribution using thread_engine().
+   *
+   * @tparam RealType the floating point type of the result.
+   * @return a normal deviate.
+   */
+  template<typename RealType>
+  RealType normal() { return normal<RealType>(thread_engine()); }
+
+  /**
+   * Sample from the unit exponential distribution.
+   *
+   * @tparam RealType the floating point type of the result.
+   * @tparam Generator the type of g.
+   * @param g the random generator engine.
+   * @return an exponential deviate.
+   *
+   * This uses per_thread< unit_exponential_distribution<RealType> >; see
+   * normal(g).
+   */
+  template<typename RealType, typename Generator>
+  RealType exponential(Generator& g)
+  { return per_thread< unit_exponential_distribution<RealType> >::get()(g); }
+
+  /**
+   * Sample from the unit exponential distribution using thread_engine().
+   *
+   * @tparam RealType the floating point type of the result.
+   * @return an exponential deviate.
+   */
+  template<typename RealType>
+  RealType exponential() { return exponential<RealType>(thread_engine()); }
+
+  /**
+   * Sample from the unit uniform distribution.
+   *
+   * @tparam RealType the floating point type of the result.
+   * @tparam Generator the type of g.
+   * @param g the random generator engine.
+   * @return a uniform deviate.
+   *
+   * This uses per_thread< unit_uniform_distribution<RealType> >; see
+   * normal(g).
+   */
+  template<typename RealType, typename Generator>
+  RealType uniform(Generator& g)
+  { return per_thread< unit_uniform_distribution<RealType> >::get()(g); }
+
+  /**
+   * Sample from the unit uniform distribution using thread_engine().
+   *
+   * @tparam RealType the floating point type of the result.
+   * @return a uniform deviate.
+   */
+  template<typename RealType>
+  RealType uniform() { return uniform<RealType>(thread_engine()); }
+
+  /**
+   * Sample from the discrete normal distribution.
+   *
+   * @tparam Generator the type of g.
+   * @param g the random generator engine.
+   * @param p the parameters of the distribution.
+   * @return a discrete normal deviate.
+   *
+   * This uses per_thread<discrete_normal_distribution>; see normal(g).  The
+   * setup for @e p is repeated on each call, but this is only a few
+   * integer operations: no discrete_normal_table is built and Algorithm D
+   * is always used.  For small &sigma;, pass a
+   * discrete_normal_distribution::prepared_param (which holds the table)
+   * instead for faster sampling.
+   */
+  template<typename Generator>
+  int discrete_normal(Generator& g,
+                      const discrete_normal_distribution::param_type& p)
+  { return per_thread<discrete_normal_distribution>::get()(g, p); }
+
+  /**
+   * Sample from the discrete normal distribution with prepared parameters.
+   *
+   * @tparam Generator the type of g.
+   * @param g the random generator engine.
+   * @param p the prepared parameters of the distribution.
+   * @return a discrete normal deviate.
+   */
+  template<typename Generator>
+  int discrete_normal(Generator& g,
+                      const discrete_normal_distribution::prepared_param& p)
+  { return per_thread<discrete_normal_distribution>::get()(g, p); }
+
+  /**
+   * Sample from the discrete normal distribution using thread_engine().
+   *
+   * @param p the parameters of the distribution.
+   * @return a discrete normal deviate.
+   */
+  inline int
+  discrete_normal(const discrete_normal_distribution::param_type& p)
+  { return discrete_normal(thread_engine(), p); }
+
+  /**
+   * Sample from the discrete normal distribution with prepared parameters
+   * using thread_engine().
+   *
+   * @param p the prepared parameters of the distribution.
+   * @return a discrete normal deviate.
+   */
+  inline int
+  discrete_normal(const discrete_normal_distribution::prepared_param& p)
+  { return discrete_normal(thread_engine(), p); }
+
+}
+
+#endif  // EXRANDOM_SAMPLERS_HPP
@@ -0,0 +1,279 @@
+/**
+ * @file scaled_u_rand.hpp
+ * @author Charles Karney <charles.karney@sri.com>
+ * @brief Definition of scaled_u_rand
+ *
+ * Copyright (c) Charles Karney (2016) and licensed under the MIT/X11 License.
+ * For more information, see http://exrandom.sourceforge.net/
+ */
+
+#if !defined(EXRANDOM_SCALED_U_RAND_HPP)
+#define EXRANDOM_SCALED_U_RAND_HPP 1
+
+#include <vector>
+#include <utility>              // for std::pair
+#include <limits>               // for conversion to floating point
+#include <cmath>                // for std::ldexp
+#include <cstdint>              // for uint32_t, uint64_t
+#include <cstddef>              // for size_t
+#include <stdexcept>            // for std::runtime_error
+
+#include <exrandom/u_rand.hpp>
+#include <exrandom/fixed_point.hpp>
+
+namespace exrandom {
+
+  /**
+   * @brief A u_rand transformed by an exact affine map.
+   *
+   * @tparam digit_gen the type of digit generator; the base must be a power
+   *   of two.
+   * @tparam digit_store the digit_store for the u_rand.
+   *
+   * This is a view of a u_rand x which represents &mu; + &sigma;x, where
+   * &mu; and &sigma; &gt; 0 are rational.  scaled_u_rand::value returns the
+   * correctly rounded value of this quantity; e.g., a normal deviate with
+   * mean &mu; and standard deviation &sigma; is obtained by applying this to
+   * the u_rand from unit_normal_dist and an exponential deviate with rate
+   * &lambda; is obtained with &sigma; = 1/&lambda;.  This avoids the double
+   * rounding of computing &mu; + &sigma; * x.value<RealType>().
+   *
+   * The conversion bounds the transformed quantity using the digits of x
+   * (computing rigorous bounds with fixed point arithmetic) and checks whether
+   * the bounds round to the same floating point number.  If not, more digits
+   * of x are generated.  The number of digits needed depends on the
+   * precision of RealType and the magnitudes of &mu; and &sigma;x; no
+   * digits are generated if the existing ones suffice.
+   *
+   * RealType must have radix 2 and no more than 64 digits, and its exponent
+   * range must include [&minus;64, 64].  The numerators and denominators of
+   * &mu; and &sigma; are ints.
+   */
+  template<typename digit_gen, typename digit_store = std::vector<uint_t> >
+  class scaled_u_rand {
+  public:
+    /**
+     * The constructor.
+     *
+     * @param x the u_rand to transform (this holds a reference to @e x).
+     * @param mu_num the numerator of &mu;.
+     * @param mu_den the denominator of &mu;.
+     * @param sigma_num the numerator of &sigma;.
+     * @param sigma_den the denominator of &sigma;.
+     * @exception std::runtime_error if a denominator is not positive or
+     *   &sigma; is not positive.
+     *
+     * Represents &mu; + &sigma; @e x with &mu; = @e mu_num / @e mu_den and
+     * &sigma; = @e sigma_num / @e sigma_den.
+     */
+    scaled_u_rand(u_rand<digit_gen, digit_store>& x,
+                  int mu_num, int mu_den, int sigma_num, int sigma_den)
+      : _x(x), _mu_num(mu_num), _mu_den(mu_den),
+        _sigma_num(sigma_num), _sigma_den(sigma_den), _w(0) {
+      if (!(mu_den > 0 && sigma_den > 0))
+        throw std::runtime_error("scaled_u_rand: need positive denominators");
+      if (!(sigma_num > 0))
+        throw std::runtime_error("scaled_u_rand: need positive sigma");
+    }
+    /**
+     * Return the value rounded to the nearest RealType (or with the rounding
+     * style of RealType if this is not std::round_to_nearest), generating
+     * more digits of the u_rand if necessary.
+     *
+     * @tparam RealType the floating point type to convert to.
+     * @tparam Generator the type of g.
+     * @param g the random generator engine.
+     * @return &mu; + &sigma;x rounded to a RealType.
+     */
+    template<typename RealType, typename Generator>
+    RealType value(Generator& g) {
+      return value<RealType, Generator>
+        (g, std::numeric_limits<RealType>::round_style);
+    }
+    /**
+     * Return the value with specified rounding, generating more digits of the
+     * u_rand if necessary.
+     *
+     * @tparam RealType the floating point type to convert to.
+     * @tparam Generator the type of g.
+     * @param g the random generator engine.
+     * @param rnd the rounding mode, one of std::round_indeterminate (taken
+     *   to mean round away from zero), std::round_toward_zero,
+     *   std::round_to_nearest, std::round_toward_infinity, or
+     *   std::round_toward_neg_infinity.
+     * @return &mu; + &sigma;x rounded to a RealType.
+     */
+    template<typename RealType, typename Generator>
+    RealType value(Generator& g, std::float_round_style rnd) {
+      static_assert(std::numeric_limits<RealType>::radix == 2 &&
+                    std::numeric_limits<RealType>::digits <= 64 &&
+                    std::numeric_limits<RealType>::max_exponent > 64 &&
+                    std::numeric_limits<RealType>::min_exponent < -64,
+                    "scaled_u_rand: unsupported RealType");
+      const int digits = std::numeric_limits<RealType>::digits;
+      int e = 0;
+      std::frexp(double(_sigma_num) / _sigma_den, &e); // sigma < 2^e
+      {
+        // Estimate the number of digits of x needed: the width of the
+        // interval is about 2^(e - k*bits) and the precision needed is about
+        // 2^(lead - digits) where 2^lead ~ |mu + sigma * x|.
+        std::pair<double, double> r = _x.template range<double>();
+        int lead = 0, k = int(_x.ndigits() * bits);
+        std::frexp(double(_mu_num) / _mu_den +
+                   double(_sigma_num) / _sigma_den *
+                   (r.first + r.second) / 2, &lead);
+        lead = lead > e - k ? lead : e - k;
+        int need = e - (lead - digits) + 2;
+        if (need > k)
+          _x.extend(g, size_t((need + bits - 1) / bits));
+      }
+      for (;;) {
+        size_t k = _x.ndigits();
+        // Quantities are scaled by 2^-64; w words in the fraction is enough
+        // to represent x exactly (plus some guard words).
+        size_t w = (k * bits + 31) / 32 + 4;
+        int slo, shi;
+        fixed lo, hi;
+        bounds(k, w, slo, lo, shi, hi);
+        RealType zlo = round<RealType>(slo, lo, rnd),
+          zhi = round<RealType>(shi, hi, rnd);
+        if (zlo == zhi) return zlo;
+        _x.digit(g, k);
+      }
+    }
+    /**
+     * @return the u_rand which is transformed.
+     */
+    u_rand<digit_gen, digit_store>& x() const { return _x; }
+    /**
+     * @return the numerator of &mu;.
+     */
+    int mu_num() const { return _mu_num; }
+    /**
+     * @return the denominator of &mu;.
+     */
+    int mu_den() const { return _mu_den; }
+    /**
+     * @return the numerator of &sigma;.
+     */
+    int sigma_num() const { return _sigma_num; }
+    /**
+     * @return the denominator of &sigma;.
+     */
+    int sigma_den() const { return _sigma_den; }
+  private:
+    static const int bits = digit_gen::bits;
+    static_assert(digit_gen::power_of_two,
+                  "scaled_u_rand: base must be a power of two");
+    typedef fixed_point F;
+    typedef F::number fixed;
+    // Disable copy assignment
+    scaled_u_rand& operator=(const scaled_u_rand&);
+    u_rand<digit_gen, digit_store>& _x;
+    int _mu_num, _mu_den, _sigma_num, _sigma_den;
+    size_t _w;
+    fixed _slo, _shi, _mlo, _mhi;
+    // Shift a right by k words (keeping the size) rounding in direction up.
+    static void shift(fixed& a, size_t k, bool up) {
+      bool inexact = false;
+      for (size_t i = a.size() - k; i < a.size(); ++i)
+        inexact = inexact || a[i] != 0U;
+      for (size_t i = a.size(); i-- > k;) a[i] = a[i - k];
+      for (size_t i = 0; i < k; ++i) a[i] = 0U;
+      if (up && inexact) F::ulp(a);
+    }
+    // s*a + t*c for signs s and t with the sign of the result in s.
+    static void signed_add(int& s, fixed& a, int t, const fixed& c) {
+      if (s == t)
+        F::add(a, c);
+      else if (F::less(a, c)) {
+        fixed d(c); F::sub(d, a); a.swap(d); s = t;
+      } else
+        F::sub(a, c);
+    }
+    // Compute bounds on sigma * 2^-32 and |mu| * 2^-64 with at least w words
+    // in the fraction (these are saved in case w doesn't increase).
+    void constants(size_t w) {
+      if (w <= _w) return;
+      _w = w;
+      std::uint64_t mn = std::uint64_t(_mu_num < 0 ? -(long long)(_mu_num) :
+                                       _mu_num);
+      _slo = F::quotient(std::uint64_t(_sigma_num),
+                         std::uint64_t(_sigma_den), w, false);
+      _shi = F::quotient(std::uint64_t(_sigma_num),
+                         std::uint64_t(_sigma_den), w, true);
+      _mlo = F::quotient(mn, std::uint64_t(_mu_den), w, false);
+      _mhi = F::quotient(mn, std::uint64_t(_mu_den), w, true);
+      shift(_slo, 1, false); shift(_shi, 1, true);
+      shift(_mlo, 2, false); shift(_mhi, 2, true);
+    }
+    // Lower bound s1 * a1 and upper bound s2 * a2 on (mu + sigma * x) * 2^-64
+    // using the first k digits of x.
+    void bounds(size_t k, size_t w, int& s1, fixed& a1,
+                int& s2, fixed& a2) {
+      constants(w);
+      w = _w;
+      // x in sx * [xlo, xhi], scaled by 2^-32
+      fixed xlo = F::digits(_x, bits, k, w, false),
+        xhi = F::digits(_x, bits, k, w, true);
+      xlo[0] = std::uint32_t(_x.integer()); xhi[0] += xlo[0];
+      shift(xlo, 1, false); shift(xhi, 1, true);
+      int sm = _mu_num < 0 ? -1 : 1, sx = _x.sign();
+      // |mu| in [mlo, mhi], sigma * |x| in [plo, phi]
+      fixed plo = F::mul(_slo, xlo, false), phi = F::mul(_shi, xhi, true);
+      if (sm > 0) { a1 = _mlo; a2 = _mhi; } else { a1 = _mhi; a2 = _mlo; }
+      s1 = s2 = sm;
+      if (sx > 0) {
+        signed_add(s1, a1, 1, plo); signed_add(s2, a2, 1, phi);
+      } else {
+        signed_add(s1, a1, -1, phi); signed_add(s2, a2, -1, plo);
+      }
+    }
+    // The word of a at index i, 0 if beyond the end
+    static std::uint64_t word(const fixed& a, size_t i)
+    { return i < a.size() ? a[i] : 0U; }
+    // The 64 bits of a starting at position p (0 is the top bit of a[0])
+    static std::uint64_t bits64(const fixed& a, size_t p) {
+      size_t i = p / 32; int o = int(p % 32);
+      std::uint64_t v = (word(a, i) << 32) | word(a, i + 1);
+      return o ? (v << o) | (word(a, i + 2) >> (32 - o)) : v;
+    }
+    // Round s * a * 2^64 to RealType with rounding rnd.
+    template<typename RealType>
+    static RealType round(int s, const fixed& a, std::float_round_style rnd) {
+      const int digits = std::numeric_limits<RealType>::digits,
+        min_exp = std::numeric_limits<RealType>::min_exponent;
+      // Bit p has exponent 95 - p
+      size_t i = 0;
+      while (i < a.size() && !a[i]) ++i;
+      if (i == a.size()) return RealType(0);
+      int p0 = 32 * int(i);
+      for (std::uint32_t t = a[i]; !(t & 0x80000000U); t <<= 1) ++p0;
+      // The exponent of the leading bit
+      int lead = 95 - p0;
+      // The exponent of the last bit kept (allowing for denormals) and its
+      // position
+      int last = (lead < min_exp - 1 ? min_exp - 1 : lead) - digits + 1,
+        p1 = 95 - last, nkeep = p1 - p0 + 1;
+      std::uint64_t m = nkeep > 0 ? bits64(a, size_t(p0)) >> (64 - nkeep) : 0U,
+        // The rounding bit and the rest
+        r = bits64(a, size_t(p1 + 1));
+      std::uint32_t rbit = std::uint32_t(r >> 63),
+        sticky = (r << 1) != 0U ? 1U : 0U;
+      for (size_t j = size_t(p1 + 1) / 32 + 2; j < a.size() && !sticky; ++j)
+        sticky = a[j] ? 1U : 0U;
+      bool up =
+        rnd == std::round_to_nearest ? rbit != 0U :
+        rnd == std::round_toward_zero ? false :
+        rnd == std::round_toward_infinity ? s > 0 && (rbit | sticky) :
+        rnd == std::round_toward_neg_infinity ? s < 0 && (rbit | sticky) :
+        (rbit | sticky) != 0U;
+      RealType z = real_ldexp<RealType>(RealType(m) + RealType(up ? 1 : 0),
+                                        last);
+      return s < 0 ? -z : z;
+    }
+  };
+
+}
+
+#endif  // EXRANDOM_SCALED_U_RAND_HPP
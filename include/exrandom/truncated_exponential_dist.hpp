@@ -0,0 +1,200 @@
+/**
+ * @file truncated_exponential_dist.hpp
+ * @author Charles Karney <charles.karney@sri.com>
+ * @brief Definition of truncated_exponential_dist
+ *
+ * Copyright (c) Charles Karney (2016) and licensed under the MIT/X11 License.
+ * For more information, see http://exrandom.sourceforge.net/
+ */
+
+#if !defined(EXRANDOM_TRUNCATED_EXPONENTIAL_DIST_HPP)
+#define EXRANDOM_TRUNCATED_EXPONENTIAL_DIST_HPP 1
+
+#include <limits>
+#include <stdexcept>            // for std::runtime_error
+
+#include <exrandom/u_rand.hpp>
+#include <exrandom/unit_exponential_dist.hpp>
+#include <exrandom/scaled_u_rand.hpp>
+
+namespace exrandom {
+
+  /**
+   * @brief Sample exactly from the unit exponential distribution restricted
+   * to an interval.
+   *
+   * @tparam digit_gen the type of digit generator; the base must be a power
+   *   of two.
+   *
+   * This samples from the unit exponential distribution conditioned on x
+   * &isin; [a, b) where 0 &le; a &lt; b &le; &infin; and a and b are
+   * rational.  Because the exponential distribution is memoryless, the
+   * result is a + y where y is exponentially distributed in [0, w) and w = b
+   * &minus; a.  If w &ge; 1 (in particular for the tail, b = &infin;), y is
+   * a unit exponential u-rand from unit_exponential_dist and samples with y
+   * &ge; w are rejected (with probability less than 0.37) using
+   * u_rand::compare.  Otherwise y = wU where U is a uniform u-rand which is
+   * accepted with probability exp(&minus;wU) using von Neumann's algorithm
+   * (the first comparison uses u_rand::less_than with multipliers); the
+   * probability of acceptance exceeds 0.63.  Thus the cost is bounded
+   * independent of a and b.  The result is converted to a floating point
+   * number with scaled_u_rand.
+   *
+   * The numerators and denominators of a and w must be ints.
+   */
+  template<typename digit_gen>
+  class truncated_exponential_dist {
+  public:
+    /**
+     * Construct the distribution for the tail [a, &infin;).
+     *
+     * @param D a reference to the digit generator to be used.
+     * @param a_num the numerator of a.
+     * @param a_den the denominator of a.
+     * @exception std::runtime_error if the parameters are out of range.
+     */
+    truncated_exponential_dist(digit_gen& D, int a_num, int a_den = 1)
+      : _D(D), _E(D), _u(D), _y(D), _z(D)
+      , _a_num(check(a_num, a_den)), _a_den(a_den), _w_num(1), _w_den(0)
+      , _S(_u, a_num, a_den, 1, 1) {}
+    /**
+     * Construct the distribution for the interval [a, b).
+     *
+     * @param D a reference to the digit generator to be used.
+     * @param a_num the numerator of a.
+     * @param a_den the denominator of a.
+     * @param b_num the numerator of b.
+     * @param b_den the denominator of b.
+     * @exception std::runtime_error if the parameters are out of range or
+     *   b &minus; a overflows.
+     */
+    truncated_exponential_dist(digit_gen& D, int a_num, int a_den,
+                               int b_num, int b_den)
+      : _D(D), _E(D), _u(D), _y(D), _z(D)
+      , _a_num(check(a_num, a_den)), _a_den(a_den)
+      , _w_num(width(a_num, a_den, b_num, b_den, true))
+      , _w_den(width(a_num, a_den, b_num, b_den, false))
+      , _S(_u, a_num, a_den,
+           _w_num < _w_den ? _w_num : 1, _w_num < _w_den ? _w_den : 1) {}
+
+    /**
+     * Generate the next deviate and round it to a floating point number.
+     *
+     * @tparam RealType the floating point type of the result.
+     * @tparam Generator the type of g.
+     * @param g the random generator engine.
+     * @return the exponential deviate in [a, b), rounded with the rounding
+     *   style of RealType.
+     */
+    template<typename RealType, typename Generator>
+    RealType value(Generator& g) {
+      return value<RealType, Generator>
+        (g, std::numeric_limits<RealType>::round_style);
+    }
+    /**
+     * Generate the next deviate with specified rounding.
+     *
+     * @tparam RealType the floating point type of the result.
+     * @tparam Generator the type of g.
+     * @param g the random generator engine.
+     * @param rnd the rounding mode (see scaled_u_rand::value).
+     * @return the exponential deviate in [a, b).
+     *
+     * The result can equal b after rounding.
+     */
+    template<typename RealType, typename Generator>
+    RealType value(Generator& g, std::float_round_style rnd) {
+      if (_w_den == 0 || _w_num >= _w_den) {
+        for (;;) {
+          _E.generate(g, _u);
+          if (_w_den == 0 || _u.compare(g, _w_num, _w_num, _w_den) < 0)
+            break;
+        }
+      } else
+        while (!V(g)) {}
+      return _S.template value<RealType>(g, rnd);
+    }
+
+    /**
+     * @return the numerator of a.
+     */
+    int a_num() const { return _a_num; }
+    /**
+     * @return the denominator of a.
+     */
+    int a_den() const { return _a_den; }
+    /**
+     * @return the numerator of w = b &minus; a (1 for the tail).
+     */
+    int w_num() const { return _w_num; }
+    /**
+     * @return the denominator of w = b &minus; a (0 for the tail).
+     */
+    int w_den() const { return _w_den; }
+    /**
+     * @return a reference to the digit generator used in the constructor.
+     */
+    digit_gen& digit_generator() const { return _D; }
+
+    /**
+     * The base of the digit generator.
+     */
+    static const uint_t base = digit_gen::base;
+  private:
+    static_assert(digit_gen::power_of_two,
+                  "truncated_exponential_dist: base must be a power of two");
+    // Disable copy construction (_S refers to _u) and copy assignment
+    truncated_exponential_dist(const truncated_exponential_dist&);
+    truncated_exponential_dist& operator=(const truncated_exponential_dist&);
+    digit_gen& _D;
+    unit_exponential_dist<digit_gen> _E;
+    u_rand<digit_gen> _u, _y, _z; // temporary storage
+    int _a_num, _a_den, _w_num, _w_den;
+    // a + _u if w >= 1, else a + w * _u
+    scaled_u_rand<digit_gen> _S;
+
+    static int check(int a_num, int a_den) {
+      if (!(a_den > 0 && a_num >= 0))
+        throw std::runtime_error
+          ("truncated_exponential_dist: need a_den > 0, a >= 0");
+      return a_num;
+    }
+    // The numerator (if num) or denominator of w = b - a in lowest terms
+    static int width(int a_num, int a_den, int b_num, int b_den, bool num) {
+      if (!(b_den > 0))
+        throw std::runtime_error("truncated_exponential_dist: need b_den > 0");
+      long long n = (long long)(b_num) * a_den - (long long)(a_num) * b_den,
+        d = (long long)(a_den) * b_den, l = gcd(n, d);
+      n /= l; d /= l;
+      if (!(n > 0))
+        throw std::runtime_error("truncated_exponential_dist: need a < b");
+      if (!(n <= std::numeric_limits<int>::max() &&
+            d <= std::numeric_limits<int>::max()))
+        throw std::runtime_error("truncated_exponential_dist: b - a overflow");
+      return int(num ? n : d);
+    }
+    // Knuth, TAOCP, vol 2, 4.5.2, Algorithm A
+    static long long gcd(long long u, long long v) {
+      u = u < 0 ? -u : u; v = v < 0 ? -v : v;
+      while (v > 0) { long long r = u % v; u = v; v = r; }
+      return u;
+    }
+    // Set _u to a uniform u_rand U and return true with probability exp(-w*U)
+    // (von Neumann).  The first comparison z < w*U is w_den*z < w_num*U.
+    template<typename Generator>
+    bool V(Generator& g) {
+      _u.init();
+      int n = 0;
+      for (;; ++n) {
+        if (!(n ? _z.init().less_than(g, _y) :
+              _z.init().less_than(g, _w_den, _u, _w_num)))
+          break;
+        _y.swap(_z);            // an efficient way of doing y = z
+      }
+      return (n % 2) == 0;
+    }
+  };
+
+}
+
+#endif  // EXRANDOM_TRUNCATED_EXPONENTIAL_DIST_HPP
@@ -15,10 +15,14 @@
 #include <sstream>              // for print routines
 #include <iomanip>              // for print routines
 #include <algorithm>            // for std::swap, std::max
+#include <cstdint>              // for uint64_t
+#include <type_traits>          // for std::integral_constant
 #include <utility>              // for std::pair
 #include <vector>               // for fraction in u_rand
 #include <limits>               // for conversion to floating point
 #include <cmath>                // for std::ldexp
+#include <cstddef>              // for size_t
+#include <stdexcept>            // for std::runtime_error
 
 #include <exrandom/digit_arithmetic.hpp>
 #include <exrandom/i_rand.hpp>
@@ -79,6 +83,20 @@ namespace exrandom {
   { return std::numeric_limits<mpfr::mpreal>::round_style(); }
 #endif
 
+  // Is RealType a wrapper for an mpfr_t which can be set with
+  // u_rand::to_mpfr?
+  template<typename RealType> class real_is_mpfr {
+  public:
+    static const bool value = false;
+  };
+
+#if defined(MPREAL_VERSION_STRING) && defined(MPFR_VERSION)
+  template<> class real_is_mpfr<mpfr::mpreal> {
+  public:
+    static const bool value = true;
+  };
+#endif
+
   template<typename RealType>
   inline RealType real_ldexp(const RealType& x, int n) {
     static_assert(!std::numeric_limits<RealType>::is_integer,
@@ -89,6 +107,32 @@ namespace exrandom {
     //   using std::scalbn; return scalbn(x, n);
   }
 
+  // The floating point format of RealType used by u_rand::value.  The result
+  // is computed in compute_type and converted with convert (which may
+  // adjust the inexact flag, e.g., on overflow); the rounding is to digits()
+  // radix digits with exponents in [min_exponent(), ...) with subnormals if
+  // denorm().  Specializations for low precision formats (where
+  // compute_type is wider than RealType and the conversion is exact) are
+  // given in low_precision.hpp.
+  template<typename RealType> class real_format {
+  public:
+    typedef RealType compute_type;
+    static const unsigned radix = std::numeric_limits<RealType>::radix;
+    static int digits() { return real_digits<RealType>(); }
+    static int min_exponent() {
+      // Put a sane lower limit on min_exp.  Boost's gmp_float has
+      // min_exponent = -2^63 which doesn't fit into an int.
+      return std::numeric_limits<RealType>::min_exponent < -(1<<30) ?
+        -(1<<30) : int(std::numeric_limits<RealType>::min_exponent);
+    }
+    static bool denorm() {
+      return std::numeric_limits<RealType>::has_denorm == std::denorm_present;
+    }
+    static RealType min() { return std::numeric_limits<RealType>::min(); }
+    static RealType convert(const RealType& x, std::float_round_style, int&)
+    { return x; }
+  };
+
 #if !defined(EXRANDOM_CXX11_MATH)
   // Some (maybe?) optimizations for non Windows (g++ 4.8, clang 5.1)
 
@@ -139,8 +183,18 @@ namespace exrandom {
    * n and K are non-negative integers, and d<sub>k</sub> &isin; [0,b).
    *
    * @tparam digit_gen the type of digit generator.
+   * @tparam digit_store the container holding the digits of the fraction.
+   *   This can be std::vector<uint_t> (the default) or inline_digits<N>,
+   *   which avoids allocating memory provided that there are no more than N
+   *   digits.  It needs to provide size(), clear(), push_back(uint_t),
+   *   resize(size_t), swap(digit_store&), operator[](size_t), and copy
+   *   semantics.
+   *
+   * Operations which take a pair of u_rands, e.g., u_rand::less_than, accept
+   * u_rands using different digit_stores.
    */
-  template<typename digit_gen> class u_rand {
+  template<typename digit_gen, typename digit_store = std::vector<uint_t> >
+  class u_rand {
   public:
     /**
      * The constructor.
@@ -150,6 +204,14 @@ namespace exrandom {
      * The initial state represents a random deviate uniform in (0,1)
      */
     u_rand(digit_gen& D) : _s(1), _n(0U), _D(D) {}
+    /**
+     * The copy constructor.
+     *
+     * @param t the u_rand to copy.
+     *
+     * The copy uses the same digit generator as @e t.
+     */
+    u_rand(const u_rand& t) : _s(t._s), _n(t._n), _d(t._d), _D(t._D) {}
     /**
      * Reset to the initial state.
      *
@@ -219,6 +281,36 @@ namespace exrandom {
       for (size_t i = ndigits(); i <= k; ++i) _d.push_back(_D(g));
       return _d[k];
     }
+    /**
+     * Make sure that at least k digits of the fraction have been generated.
+     *
+     * @tparam Generator the type of g.
+     * @param g the random generator engine used to generate the digits.
+     * @param k the number of digits needed.
+     *
+     * The missing digits are generated in one call to digit_gen::generate;
+     * the result is the same as calling digit(g, k - 1) but the per-digit
+     * overhead is lower.
+     */
+    template<typename Generator>
+    void extend(Generator& g, size_t k) {
+      size_t n = ndigits();
+      if (k <= n) return;
+      _d.resize(k);
+      _D.generate(g, &_d[n], k - n);
+    }
+    /**
+     * Append a digit to the fraction.
+     *
+     * @param d the digit, in [0, base).
+     * @return the u_rand itself.
+     *
+     * The digit must have been obtained from the digit generator (and not
+     * otherwise used in a way which depends on its value) for the u_rand to
+     * remain uniformly distributed.  This allows digits which have been
+     * generated in bulk to be used.
+     */
+    u_rand& append(uint_t d) { _d.push_back(d); return *this; }
     /**
      * The k'th digit (which must already be generated).
      *
@@ -240,16 +332,34 @@ namespace exrandom {
      * @param g the random generator engine used to generate the digit.
      * @param t the u_rand to compare with.
      * @return *this &lt; t.
+     *
+     * Digits are generated alternately for *this and t until they differ.  If
+     * digit_gen is peekable (see peekable_digits) and t uses the same digit
+     * generator, the new digits for both u_rands are examined a 64-bit word
+     * at a time; the first differing pair of digits is found with a single
+     * exclusive or and the digits up to that point are consumed.  The
+     * resulting digits are the same as with the digit-by-digit comparison.
      */
-    template<typename Generator>
-    bool less_than(Generator& g, u_rand& t) {
-      if (this == &t) return false;
+    template<typename Generator, typename store>
+    bool less_than(Generator& g, u_rand<digit_gen, store>& t) {
+      if (static_cast<const void*>(this) == static_cast<const void*>(&t))
+        return false;
       if (_s != t._s) return _s < t._s;
       if (_n != t._n) return (_s < 0) ^ (_n < t._n);
-      for (size_t k = 0;; ++k) {
+      size_t k = 0;
+      // First compare the digits already generated for both
+      for (size_t m = (std::min)(ndigits(), t.ndigits()); k < m; ++k)
+        if (_d[k] != t._d[k]) return (_s < 0) ^ (_d[k] < t._d[k]);
+      // Then the digits already generated for one of them
+      for (size_t m = (std::max)(ndigits(), t.ndigits()); k < m; ++k) {
         uint_t a = digit(g, k), b = t.digit(g, k);
         if (a != b) return (_s < 0) ^ (a < b);
       }
+      // Finally generate new digits for both
+      return (_s < 0) ^
+        new_less_than(g, t,
+                      std::integral_constant<bool,
+                      peekable_digits<digit_gen>::value>());
     }
     /**
      * Test *this &lt; 1/2.
@@ -297,26 +407,86 @@ namespace exrandom {
      * @return -1 if *this &lt; u1/v, +1 if frac(*this) &gt; u2/v, and 0
      *   otherwise.
      *
-     * This function requires v &gt; 0, u2 &gt; u1.
+     * This function requires v &gt; 0, u2 &gt; u1, and v &times; base &le;
+     * 2<sup>63</sup>.
+     *
+     * If the base is a power of two, m digits, where v &times;
+     * base<sup>m</sup> &lt; 2<sup>62</sup>, are handled in one step, either
+     * from the digits already generated or, if digit_gen is peekable (see
+     * peekable_digits), from new digits examined with peek; if v is a power
+     * of two, the step uses shifts instead of multiplications.  If the
+     * result is decided within such a step, it is redone a digit at a time.
+     * So the digits consumed are the same as with the digit-by-digit
+     * comparison.
      */
     template<typename Generator>
     int compare(Generator& g, long long u1, long long u2, long long v) {
-      long long lbase = base;
+      long long lbase = (long long)(bm1) + 1; // allow for base = 2^32
       u1 = (std::max)(0LL, _s * u1 - (long long)(_n) * v);
       u2 = (std::min)( v , _s * u2 - (long long)(_n) * v);
-      for (size_t k = 0;; ++k) {
+      // m = digits per step, j = log2(v) if v is a power of two, else -1
+      int m = -1, j = -1;
+      for (size_t k = 0;;) {
         if (u1 >= v) return -_s; // u1/v >= 1, so *this < u1/v
         if (u2 <= 0) return  _s; // u2/v <= 0, so *this > u2/v
         if (u1 <= 0 && u2 >= v) return 0;
-        long long d = digit(g, k);
-        u1 = (std::max)(0LL, u1 * lbase - d * v);
-        u2 = (std::min)( v , u2 * lbase - d * v);
+        if (m < 0) {
+          int h = highest_bit_idx64(std::uint64_t(v));
+          j = (v & (v - 1)) == 0 ? h : -1;
+          m = power_of_two ? (61 - h) / bits : 0;
+        }
+        std::uint64_t x = 0U;
+        bool peeked = false;
+        if (m > 1 && k + m <= ndigits()) {
+          for (int i = 0; i < m; ++i) x = (x << bits) | _d[k + i];
+        } else if (m > 1 && k == ndigits() &&
+                   peek(g, m, x, std::integral_constant<bool,
+                        peekable_digits<digit_gen>::value>()))
+          peeked = true;
+        else {
+          long long d = digit(g, k++);
+          u1 = (std::max)(0LL, u1 * lbase - d * v);
+          u2 = (std::min)( v , u2 * lbase - d * v);
+          continue;
+        }
+        // The results of m digit-by-digit steps without the clamping
+        long long X = (long long)(x),
+          w = j >= 0 ? X << j : X * v,
+          a1 = j >= 0 ? (u1 << (m * bits)) - w : u1 * (1LL << (m * bits)) - w,
+          a2 = j >= 0 ? (u2 << (m * bits)) - w : u2 * (1LL << (m * bits)) - w;
+        if (a1 < v && a2 > 0 && !(a1 <= 0 && a2 >= v)) {
+          // Undecided after these digits, hence also after each of them
+          if (peeked) {
+            for (int i = m; i--;) _d.push_back(uint_t(x >> (i * bits)) & bm1);
+            discard(m, std::integral_constant<bool,
+                    peekable_digits<digit_gen>::value>());
+          }
+          k += m;
+          u1 = (std::max)(0LL, a1);
+          u2 = (std::min)( v , a2);
+          continue;
+        }
+        // Decided within these digits; redo them one at a time
+        for (int i = m; i--;) {
+          long long d = (long long)(uint_t(x >> (i * bits)) & bm1);
+          if (peeked) _d.push_back(uint_t(d));
+          ++k;
+          u1 = (std::max)(0LL, u1 * lbase - d * v);
+          u2 = (std::min)( v , u2 * lbase - d * v);
+          if (u1 >= v || u2 <= 0 || (u1 <= 0 && u2 >= v)) {
+            if (peeked)
+              discard(m - i, std::integral_constant<bool,
+                      peekable_digits<digit_gen>::value>());
+            break;
+          }
+        }
       }
     }
     /**
      * Compare *this with a i_rand.
      *
      * @tparam Generator the type of g.
+     * @tparam int_type the integer type of the i_rand.
      * @param g the random generator engine.
      * @param u0 the offset in the numerator.
      * @param c the multiplier for the i_rand.
@@ -326,9 +496,9 @@ namespace exrandom {
      *
      * This function requires v &gt; 0, c &gt; 0.
      */
-    template<typename Generator>
+    template<typename Generator, typename int_type>
     bool less_than(Generator& g, long long u0, long long c, long long v,
-                   i_rand<digit_gen>& h) {
+                   i_rand<digit_gen, int_type>& h) {
       for (;;) {
         int r = compare(g, u0 + h.min()*c, u0 + h.max()*c, v);
         if (r < 0) return true;
@@ -336,6 +506,52 @@ namespace exrandom {
         h.refine(g);
       }
     }
+    /**
+     * Compare multiples of *this and another u_rand.
+     *
+     * @tparam Generator the type of g.
+     * @tparam store the digit_store for t.
+     * @param g the random generator engine.
+     * @param a the multiplier for *this.
+     * @param t the u_rand to compare with.
+     * @param c the multiplier for t.
+     * @return a &times; *this &lt; c &times; t.
+     *
+     * This function requires a &gt; 0, c &gt; 0, and a + c &lt;
+     * 2<sup>46</sup>; if the base is not a power of two, it must not exceed
+     * 2<sup>16</sup>.  The difference of the two sides is accumulated exactly
+     * as digits are generated (one digit at a time for *this and t in turn)
+     * until its sign is known; digits with more than 16 bits are consumed
+     * in 16-bit pieces.
+     */
+    template<typename Generator, typename store>
+    bool less_than(Generator& g, long long a, u_rand<digit_gen, store>& t,
+                   long long c) {
+      static_assert(power_of_two || bm1 < (uint_t(1) << 16),
+                    "u_rand::less_than: base too large");
+      const int piece = power_of_two && bits > 16 ? 16 : bits;
+      long long A = _s * a, C = t._s * c,
+        // The remaining fractions contribute (lo, hi) to d
+        lo = (std::min)(0LL, A) + (std::min)(0LL, -C),
+        hi = (std::max)(0LL, A) + (std::max)(0LL, -C),
+        // The difference A * *this - C * t scaled by the digits consumed
+        d = A * (long long)(_n) - C * (long long)(t._n);
+      for (size_t k = 0;; ++k) {
+        if (d + hi <= 0) return true;
+        if (d + lo >= 0) return false;
+        long long x = digit(g, k), y = t.digit(g, k);
+        if (!power_of_two || piece == bits) {
+          d = d * (long long)(base) + A * x - C * y;
+          continue;
+        }
+        for (int r = bits; r > 0;) {
+          int p = (std::min)(piece, r); r -= p;
+          long long m = (1LL << p) - 1;
+          d = d * (m + 1) + A * ((x >> r) & m) - C * ((y >> r) & m);
+          if (r > 0 && (d + hi <= 0 || d + lo >= 0)) break;
+        }
+      }
+    }
     /**
      * The lower end of the range as a rational.
      *
@@ -498,14 +714,201 @@ namespace exrandom {
      * Special treatment is included for
      * - mpfr::mpreal (std::numeric_limits has digits() and round_style()
      *   instead of digits and round_style)
+     * - half, bfloat16, fixed_q, _Float16, and __bf16 (see low_precision.hpp)
+     *   which are rounded in a wider type to their precision and exponent
+     *   range and then converted exactly
      **********************************************************************/
     template<typename RealType, typename Generator>
     RealType value(Generator& g, std::float_round_style rnd, int& flag) {
+      return value<RealType, Generator>
+        (g, 0, rnd, flag,
+         std::integral_constant<bool, real_is_mpfr<RealType>::value>());
+    }
+
+    /**
+     * Return the value of the u_rand rounded to nearest floating point number
+     * of type RealType and, if necessary, creating additional digits of the
+     * number.  Also return inexact flag to indicate whether the rounded result
+     * is greater or less than the true result.
+     *
+     * @tparam RealType the floating point type to convert to.
+     * @tparam Generator the type of g.
+     * @param g the random generator engine.
+     * @param[out] flag the inexact flag, +1 (resp. -1) if rounded result is
+     *   greater (resp. less) than the true result.
+     * @return the value of the u_rand rounded to a RealType.
+     *
+     * This function is only implemented if the base is a power of two for
+     * conventional floating point types (which have radix = 2).  If the
+     * floating point radix is not two (e.g., radix = 10), then the base needs
+     * to match the radix and be even.  The meaning for the inexact flag is the
+     * same as in the MPFR library.
+     **********************************************************************/
+    template<typename RealType, typename Generator>
+    RealType value(Generator& g, int& flag) {
+      return value<RealType, Generator>(g, real_round_style<RealType>(), flag);
+    }
+    /**
+     * Return the value of the u_rand rounded to nearest floating point number
+     * of type RealType and, if necessary, creating additional digits of the
+     * number.
+     *
+     * @tparam RealType the floating point type to convert to.
+     * @tparam Generator the type of g.
+     * @param g the random generator engine.
+     * @return the value of the u_rand rounded to a RealType.
+     *
+     * This function is only implemented if the base is a power of two for
+     * conventional floating point types (which have radix = 2).  If the
+     * floating point radix is not two (e.g., radix = 10), then the base needs
+     * to match the radix and be even.
+     **********************************************************************/
+    template<typename RealType, typename Generator>
+    RealType value(Generator& g) {
+      int flag;
+      return value<RealType, Generator>(g, real_round_style<RealType>(), flag);
+    }
+
+    /**
+     * Return the value of the u_rand with specified rounding to a reduced
+     * precision as a floating point number of type RealType and, if
+     * necessary, creating additional digits of the number.  Also return
+     * inexact flag to indicate whether the rounded result is greater or less
+     * than the true result.
+     *
+     * @tparam RealType the floating point type to convert to.
+     * @tparam Generator the type of g.
+     * @param g the random generator engine.
+     * @param precision the number of (radix) digits in the result.
+     * @param rnd the rounding mode.
+     * @param[out] flag the inexact flag, +1 (resp. -1) if rounded result is
+     *   greater (resp. less) than the true result.
+     * @return the value of the u_rand rounded to @e precision digits.
+     *
+     * The result is correctly rounded to a floating point system with
+     * @e precision digits and the exponent range of RealType (so subnormal
+     * results are multiples of RealType::min() &times;
+     * radix<sup>1&minus;precision</sup>).  It is exactly representable as a
+     * RealType.  The number of digits of the u_rand which need to be
+     * generated is reduced roughly in proportion to the precision.  If
+     * @e precision &le; 0 or @e precision &ge; RealType::digits, this is the
+     * same as value(g, rnd, flag).  The requirements on the base and RealType
+     * are the same as for value(g, rnd, flag).
+     **********************************************************************/
+    template<typename RealType, typename Generator>
+    RealType reduced_value(Generator& g, int precision,
+                           std::float_round_style rnd, int& flag) {
+      return value<RealType, Generator>
+        (g, precision, rnd, flag,
+         std::integral_constant<bool, real_is_mpfr<RealType>::value>());
+    }
+    /**
+     * Return the value of the u_rand rounded to nearest floating point number
+     * with a reduced precision, creating additional digits of the number, if
+     * necessary.
+     *
+     * @tparam RealType the floating point type to convert to.
+     * @tparam Generator the type of g.
+     * @param g the random generator engine.
+     * @param precision the number of (radix) digits in the result.
+     * @return the value of the u_rand rounded to @e precision digits.
+     *
+     * See reduced_value(g, precision, rnd, flag).
+     **********************************************************************/
+    template<typename RealType, typename Generator>
+    RealType reduced_value(Generator& g, int precision) {
+      int flag;
+      return reduced_value<RealType, Generator>
+        (g, precision, real_round_style<RealType>(), flag);
+    }
+
+#if defined(MPFR_VERSION)
+    /**
+     * Set an MPFR number to the value of the u_rand with specified rounding,
+     * creating additional digits of the number, if necessary.
+     *
+     * @tparam Generator the type of g.
+     * @param g the random generator engine.
+     * @param[out] z the MPFR number to set (its precision is used).
+     * @param rnd the MPFR rounding mode.
+     * @return the inexact flag, +1 (resp. -1) if rounded result is greater
+     *   (resp. less) than the true result.
+     *
+     * This is only defined if mpfr.h is included before this file and is
+     * only implemented if the base is a power of two.  Instead of building up
+     * the result one digit at a time with MPFR arithmetic, the digits are
+     * imported into an mpz_t and followed by a 1 bit (standing in for the
+     * digits which haven't been generated) and the result is formed with a
+     * single rounding.  Thus the cost is linear in the precision of @e z.
+     * value<mpfr::mpreal>() uses this function.
+     **********************************************************************/
+    template<typename Generator>
+    int to_mpfr(Generator& g, mpfr_ptr z, mpfr_rnd_t rnd) {
+      static_assert(power_of_two, "to_mpfr requires base a power of two");
+      int lead;             // Position of leading bit (0.5 = position 0)
+      if (_n)
+        lead = highest_bit_idx(_n);
+      else {
+        size_t i = 0;
+        while (digit(g, i) == 0) ++i;
+        lead = highest_bit_idx(_d[i]) - int(i + 1) * bits;
+      }
+      // Position of rounding bit (0.5 = position 0)
+      long trail = long(lead) - long(mpfr_get_prec(z));
+      // Round to nearest needs all the digits through the rounding bit; the
+      // directed roundings only need the digits through the last retained
+      // bit (position trail + 1).
+      if (rnd == MPFR_RNDN) {
+        if (trail <= 0) extend(g, size_t((-trail)/bits) + 1U);
+      } else if (trail < 0)
+        extend(g, size_t((-trail - 1)/bits) + 1U);
+      size_t k = ndigits();
+      mpz_t m, t;
+      mpz_init(m); mpz_init(t);
+      if (k)
+        mpz_import(m, k, 1, sizeof(uint_t), 0,
+                   8 * sizeof(uint_t) - bits, &_d[0]);
+      mpz_set_ui(t, _n);
+      mpz_mul_2exp(t, t, k * bits);
+      mpz_add(m, m, t);
+      // The sticky bit for the missing digits; the result lies strictly
+      // within a rounding interval, so there are no ties.
+      mpz_mul_2exp(m, m, 1);
+      mpz_add_ui(m, m, 1U);
+      if (_s < 0) mpz_neg(m, m);
+      int flag = mpfr_set_z_2exp(z, m, -mpfr_exp_t(k * bits) - 1, rnd);
+      mpz_clear(t); mpz_clear(m);
+      return flag > 0 ? 1 : flag < 0 ? -1 : 0;
+    }
+#endif
+
+  private:
+#if defined(MPREAL_VERSION_STRING) && defined(MPFR_VERSION)
+    template<typename RealType, typename Generator>
+    RealType value(Generator& g, int prec, std::float_round_style rnd,
+                   int& flag, std::true_type) {
+      RealType z;
+      if (prec > 0 && prec < z.get_prec()) z.set_prec(prec);
+      flag = to_mpfr(g, z.mpfr_ptr(),
+                     rnd == std::round_to_nearest ? MPFR_RNDN :
+                     rnd == std::round_toward_zero ? MPFR_RNDZ :
+                     rnd == std::round_toward_infinity ? MPFR_RNDU :
+                     rnd == std::round_toward_neg_infinity ? MPFR_RNDD :
+                     MPFR_RNDA);
+      return z;
+    }
+#endif
+    template<typename RealType, typename Generator>
+    RealType value(Generator& g, int prec, std::float_round_style rnd,
+                   int& flag, std::false_type) {
       // Need to treat rounding explicitly since the missing digits always
       // imply rounding up.
       static_assert(!std::numeric_limits<RealType>::is_integer,
                     "invalid real type RealType");
-      static const uint_t radix = std::numeric_limits<RealType>::radix;
+      // The rounding is done in real, the compute type of the format
+      typedef real_format<RealType> format;
+      typedef typename format::compute_type real;
+      static const uint_t radix = format::radix;
       static const bool binary = radix == 2U;
         // How many RealType digits fit into a u_rand digit
       static const int xbits = binary ? bits  : 1;
@@ -515,16 +918,14 @@ namespace exrandom {
                     "or RealType::radix = base = even");
       // Check that overflow cannot happen (skip this check if radix is not 2
       // or 10)
-      static_assert(binary ? std::numeric_limits<RealType>::max_exponent >= 32 :
+      static_assert(binary ? std::numeric_limits<real>::max_exponent >= 32 :
                     radix == 10U ?
-                    std::numeric_limits<RealType>::max_exponent >= 10 : true,
+                    std::numeric_limits<real>::max_exponent >= 10 : true,
                     "RealType::max_exponent too small");
       // std::numeric_limits<RealType>::digits isn't defined for mpreals
-      const int digits = real_digits<RealType>(),
-        // Put a sane lower limit on min_exp.  Boost's gmp_float has
-        // min_exponent = -2^63 which doesn't fit into an int.
-        min_exp = std::numeric_limits<RealType>::min_exponent < -(1<<30) ?
-        -(1<<30) : std::numeric_limits<RealType>::min_exponent;
+      const int digits = prec > 0 && prec < format::digits() ? prec :
+        format::digits(),
+        min_exp = format::min_exponent();
       // round_dir is rounding direction for magnitude of number:
       // -1 = down, 0 = nearest, 1 = up
       flag =
@@ -535,13 +936,15 @@ namespace exrandom {
         +1;                 // round_indeterminate taken to mean away from zero
       int lead;             // Position of leading bit (0.5 = position 0)
       if (_n) {
-        if (binary)
+        EXRANDOM_IF_CONSTEXPR (binary)
           lead = highest_bit_idx(_n);
         else {
           uint_t n = _n;
           lead = 0;
           while (n) {++lead; n /= radix;}
         }
+        // Only fixed point formats have min_exp > 0
+        lead = lead >= min_exp ? lead : min_exp;
       } else {
         int i = 0;
         while ( digit(g, size_t(i)) == 0 && i < (-min_exp)/xbits ) ++i;
@@ -550,13 +953,16 @@ namespace exrandom {
         lead = lead >= min_exp ? lead :
           // To handle denormalized numbers set lead = max(lead, min_exp); if
           // no denormalized min_exp - 1 marks underflow.
-          std::numeric_limits<RealType>::has_denorm == std::denorm_present ?
-          min_exp : min_exp - 1;
+          format::denorm() ? min_exp : min_exp - 1;
       }
       // Position of rounding bit (0.5 = position 0)
       int trail = lead - (lead >= min_exp ? digits : 0);
+      // Generate the digits needed for the result (including the rounding
+      // bit if round to nearest) in one go.
+      if (flag == 0 ? trail <= 0 : trail < 0 && lead >= min_exp)
+        extend(g, size_t((flag == 0 ? -trail : -trail - 1) / xbits) + 1U);
       if (flag == 0) {          // Get the rounding bit
-        if (binary)
+        EXRANDOM_IF_CONSTEXPR (binary)
           flag = int((trail > 0 ? _n >> (trail - 1) :
                       digit(g, size_t( (-trail)/xbits ))
                       >> (xbits - 1 - (-trail) % xbits)) & 1U);
@@ -570,12 +976,12 @@ namespace exrandom {
         }
         flag = flag == 0 ? -1 : 1;
       }
-      RealType z(flag > 0 ? 1 : 0);
+      real z(flag > 0 ? 1 : 0);
       // Result is given by the bits in [trail+1, lead] + rounding, where
       // rounding = z * 2^trail
       if (trail >= 0) {
-        if (binary)
-          z = real_ldexp<RealType>(z, trail) + (_n & (~uint_t(0) << trail));
+        EXRANDOM_IF_CONSTEXPR (binary)
+          z = real_ldexp<real>(z, trail) + (_n & (~uint_t(0) << trail));
         else {
           uint_t n = _n;
           for (int t = 0; t < trail; ++t) n /= radix;
@@ -585,66 +991,23 @@ namespace exrandom {
       } else if (lead >= min_exp) {
         // digit with bit trail+1
         size_t k = size_t((-trail-1) / xbits);
-        if (binary) {
-          z = real_ldexp<RealType>(z, int(k + 1) * xbits + trail) +
+        EXRANDOM_IF_CONSTEXPR (binary) {
+          z = real_ldexp<real>(z, int(k + 1) * xbits + trail) +
             (digit(g, k) & (~uint_t(0) << ((k + 1) * xbits + trail)));
-          while (k--) z = real_ldexp<RealType>(z, -xbits) + _d[k];
-          z = real_ldexp<RealType>(z, -xbits) + _n;
+          while (k--) z = real_ldexp<real>(z, -xbits) + _d[k];
+          z = real_ldexp<real>(z, -xbits) + _n;
         } else {
           z += digit(g, k);
           while (k--) z = z / radix + _d[k];
           z = z / radix + _n;
         }
       } else
-        z *= std::numeric_limits<RealType>::min(); // Handle underflow
+        z *= format::min(); // Handle underflow
       flag *= _s;
-      return _s * z;
-    }
-
-    /**
-     * Return the value of the u_rand rounded to nearest floating point number
-     * of type RealType and, if necessary, creating additional digits of the
-     * number.  Also return inexact flag to indicate whether the rounded result
-     * is greater or less than the true result.
-     *
-     * @tparam RealType the floating point type to convert to.
-     * @tparam Generator the type of g.
-     * @param g the random generator engine.
-     * @param[out] flag the inexact flag, +1 (resp. -1) if rounded result is
-     *   greater (resp. less) than the true result.
-     * @return the value of the u_rand rounded to a RealType.
-     *
-     * This function is only implemented if the base is a power of two for
-     * conventional floating point types (which have radix = 2).  If the
-     * floating point radix is not two (e.g., radix = 10), then the base needs
-     * to match the radix and be even.  The meaning for the inexact flag is the
-     * same as in the MPFR library.
-     **********************************************************************/
-    template<typename RealType, typename Generator>
-    RealType value(Generator& g, int& flag) {
-      return value<RealType, Generator>(g, real_round_style<RealType>(), flag);
-    }
-    /**
-     * Return the value of the u_rand rounded to nearest floating point number
-     * of type RealType and, if necessary, creating additional digits of the
-     * number.
-     *
-     * @tparam RealType the floating point type to convert to.
-     * @tparam Generator the type of g.
-     * @param g the random generator engine.
-     * @return the value of the u_rand rounded to a RealType.
-     *
-     * This function is only implemented if the base is a power of two for
-     * conventional floating point types (which have radix = 2).  If the
-     * floating point radix is not two (e.g., radix = 10), then the base needs
-     * to match the radix and be even.
-     **********************************************************************/
-    template<typename RealType, typename Generator>
-    RealType value(Generator& g) {
-      int flag;
-      return value<RealType, Generator>(g, real_round_style<RealType>(), flag);
+      return format::convert(_s * z, rnd, flag);
     }
 
+  public:
     /**
      * Print a u_rand in u-rand format.
      *
@@ -675,6 +1038,7 @@ namespace exrandom {
      */
     template<typename Generator>
     std::string print_fixed(Generator& g, size_t k) {
+      extend(g, k + 1U);
       bool trunc = truncatep(g, k);
       u_rand x(*this);
       x._d.resize(k);
@@ -706,6 +1070,80 @@ namespace exrandom {
      **********************************************************************/
     friend std::ostream& operator<<(std::ostream& os, const u_rand& x)
     { os << x.print(); return os; }
+    /**
+     * @return the number of bytes needed by serialize().
+     */
+    size_t serialized_size() const {
+      std::uint64_t h = (std::uint64_t(_n) << 1) | (_s < 0 ? 1U : 0U);
+      return varint_size(h) + varint_size(_d.size()) +
+        (_d.size() * bits + 7) / 8;
+    }
+    /**
+     * Write the u_rand in a compact binary form.
+     *
+     * @param p where to write the serialized_size() bytes of the result.
+     * @return a pointer to the byte after the result.
+     *
+     * The format is: the sign and the integer part, 2 @e n + (@e s &lt; 0 ?
+     * 1 : 0), as a variable-length integer; the number of digits as a
+     * variable-length integer; the digits packed at @e bits bits each, most
+     * significant first, padded with zero bits to a whole number of bytes.
+     * A variable-length integer is split into 7-bit groups which are stored
+     * in successive bytes, least significant first, with the high bit set
+     * in all bytes except the last.  The base isn't included, so the reader
+     * must know it; u_rand_writer and u_rand_reader include it in a header.
+     */
+    unsigned char* serialize(unsigned char* p) const {
+      p = put_varint(p, (std::uint64_t(_n) << 1) | (_s < 0 ? 1U : 0U));
+      p = put_varint(p, _d.size());
+      std::uint64_t acc = 0; int nacc = 0;
+      for (size_t k = 0; k < _d.size(); ++k) {
+        acc = (acc << bits) | _d[k]; nacc += bits;
+        while (nacc >= 8) { nacc -= 8; *p++ = (unsigned char)(acc >> nacc); }
+      }
+      if (nacc) *p++ = (unsigned char)(acc << (8 - nacc));
+      return p;
+    }
+    /**
+     * Read a u_rand written by serialize().
+     *
+     * @param p the beginning of the data.
+     * @param end the end of the available data.
+     * @exception std::runtime_error if the data is invalid.
+     * @return a pointer to the byte after the u_rand, or 0 if the data ends
+     *   before the u_rand is complete (in which case *this is unchanged).
+     *
+     * The u_rand can then be used normally; in particular, further digits
+     * are generated as needed with the digit generator supplied in the
+     * constructor.
+     */
+    const unsigned char* deserialize(const unsigned char* p,
+                                     const unsigned char* end) {
+      std::uint64_t h, nd;
+      if (!(p = get_varint(p, end, h)) || !(p = get_varint(p, end, nd)))
+        return 0;
+      if ((h >> 1) > std::uint64_t(~0U))
+        throw std::runtime_error("u_rand: integer part too large");
+      if (nd > std::uint64_t(~size_t(0)) / 64U)
+        throw std::runtime_error("u_rand: too many digits");
+      std::uint64_t nbytes = (nd * bits + 7) / 8;
+      if (std::uint64_t(end - p) < nbytes) return 0;
+      _s = h & 1U ? -1 : 1; _n = unsigned(h >> 1);
+      _d.resize(size_t(nd));
+      std::uint64_t acc = 0; int nacc = 0;
+      const std::uint64_t mask = (std::uint64_t(1) << bits) - 1U;
+      for (size_t k = 0; k < size_t(nd); ++k) {
+        while (nacc < bits) { acc = (acc << 8) | *p++; nacc += 8; }
+        nacc -= bits;
+        std::uint64_t d = (acc >> nacc) & mask;
+        if (d > bm1) {
+          init();
+          throw std::runtime_error("u_rand: digit out of range");
+        }
+        _d[k] = uint_t(d);
+      }
+      return p;
+    }
 
     /**
      * The base of the digit generator.
@@ -713,13 +1151,99 @@ namespace exrandom {
     static const uint_t base = digit_gen::base;
 
   private:
+    template<typename, typename> friend class u_rand;
     int _s;                     // the sign
     unsigned _n;                // the integer part; N.B. _n >= 0
-    std::vector<uint_t> _d;     // the digits in the fraction
+    digit_store _d;             // the digits in the fraction
     digit_gen& _D;
     static const uint_t bm1 = digit_gen::max_value;
     static const int bits = digit_gen::bits;
     static const bool power_of_two = digit_gen::power_of_two;
+    // Compare new digits of *this and t (which have the same number of
+    // digits), one pair at a time.
+    template<typename Generator, typename store>
+    bool new_less_than(Generator& g, u_rand<digit_gen, store>& t,
+                       std::false_type) {
+      for (;;) {
+        uint_t a = _D(g); _d.push_back(a);
+        uint_t b = t._D(g); t._d.push_back(b);
+        if (a != b) return a < b;
+      }
+    }
+    // Compare new digits of *this and t (which have the same number of
+    // digits), m pairs at a time.  The digits are peeked by _D in the order
+    // a[0], b[0], a[1], b[1], ..., a[m-1], b[m-1] with a[0] the most
+    // significant.  This requires that t use the same digit generator (the
+    // digits of both are drawn from _D); otherwise compare one pair at a
+    // time.
+    template<typename Generator, typename store>
+    bool new_less_than(Generator& g, u_rand<digit_gen, store>& t,
+                       std::true_type) {
+      if (&_D != &t._D) return new_less_than(g, t, std::false_type());
+      const int m = 32 / bits, l = 2 * m * bits; // l <= 64 bits are peeked
+      // A mask for the b digits of the right-justified pairs
+      const std::uint64_t mask =
+        (~std::uint64_t(0) >> (64 - l)) /
+        ((std::uint64_t(1) << 2 * bits) - 1U) * bm1;
+      for (;;) {
+        std::uint64_t w = _D.peek(g, 2 * m),
+          x = (w ^ (w >> bits)) & mask;
+        // i = index of the first pair with a[i] != b[i], or m if none
+        int i = x ? m - 1 - highest_bit_idx64(x) / (2 * bits) : m;
+        int n = i < m ? i + 1 : m;
+        uint_t a = 0U, b = 0U;
+        w <<= 64 - l;           // left-justify the pairs
+        for (int j = 0; j < n; ++j, w <<= 2 * bits) {
+          a = uint_t(w >> (64 - bits));
+          b = uint_t(w >> (64 - 2 * bits)) & bm1;
+          _d.push_back(a); t._d.push_back(b);
+        }
+        _D.discard(2 * n);
+        if (i < m) return a < b;
+      }
+    }
+    // Set x to the next m digits (the first most significant) without
+    // consuming them, if digit_gen is peekable.
+    template<typename Generator>
+    bool peek(Generator& g, int m, std::uint64_t& x, std::true_type)
+    { x = _D.peek(g, m); return true; }
+    template<typename Generator>
+    bool peek(Generator&, int, std::uint64_t&, std::false_type)
+    { return false; }
+    void discard(int n, std::true_type) { _D.discard(n); }
+    void discard(int, std::false_type) {}
+    // The position of the most significant bit in x, counting from 0;
+    // requires x != 0.
+    static int highest_bit_idx64(std::uint64_t x) {
+#if defined(__GNUC__)
+      return 63 - __builtin_clzll(x);
+#else
+      int n = 0;
+      for (int s = 32; s; s >>= 1)
+        if (x >> s) { x >>= s; n += s; }
+      return n;
+#endif
+    }
+    // Variable-length integers for serialize and deserialize
+    static size_t varint_size(std::uint64_t x)
+    { size_t n = 1; while (x >>= 7) ++n; return n; }
+    static unsigned char* put_varint(unsigned char* p, std::uint64_t x) {
+      for (; x >= 0x80U; x >>= 7) *p++ = (unsigned char)(x | 0x80U);
+      *p++ = (unsigned char)(x);
+      return p;
+    }
+    static const unsigned char* get_varint(const unsigned char* p,
+                                           const unsigned char* end,
+                                           std::uint64_t& x) {
+      x = 0;
+      for (int s = 0; p < end; s += 7) {
+        if (s > 63) throw std::runtime_error("u_rand: bad integer");
+        unsigned char c = *p++;
+        x |= std::uint64_t(c & 0x7fU) << s;
+        if (!(c & 0x80U)) return p;
+      }
+      return 0;
+    }
     static std::string bareprint(const u_rand& x) {
       // Print in the current base, except that use hexadecimal for base > 16.
       // For that reason if base > 16, we require that it be a power of 16.
@@ -0,0 +1,199 @@
+/**
+ * @file u_rand_stream.hpp
+ * @author Charles Karney <charles.karney@sri.com>
+ * @brief Definition of u_rand_writer and u_rand_reader
+ *
+ * Copyright (c) Charles Karney (2016) and licensed under the MIT/X11 License.
+ * For more information, see http://exrandom.sourceforge.net/
+ */
+
+#if !defined(EXRANDOM_U_RAND_STREAM_HPP)
+#define EXRANDOM_U_RAND_STREAM_HPP 1
+
+#include <iostream>             // for std::ostream, std::istream
+#include <vector>               // for the buffers
+#include <algorithm>            // for std::max
+#include <cstring>              // for std::memmove
+#include <cstddef>              // for size_t
+#include <stdexcept>            // for std::runtime_error
+
+#include <exrandom/u_rand.hpp>
+
+namespace exrandom {
+
+  /// \cond SKIP
+  // The header for a stream of u_rands: a 4-byte magic number, a version
+  // byte, the bits per digit, and the base as 4 bytes, least significant
+  // first (0 for base 2^32).
+  class u_rand_stream_header {
+  public:
+    enum { size = 10, version = 1 };
+    static void set(unsigned char* h, uint_t base, int bits) {
+      h[0] = 'E'; h[1] = 'x'; h[2] = 'R'; h[3] = 'u';
+      h[4] = (unsigned char)(version); h[5] = (unsigned char)(bits);
+      for (int i = 0; i < 4; ++i)
+        h[6 + i] = (unsigned char)(base >> (8 * i));
+    }
+  };
+  /// \endcond
+
+  /**
+   * @brief Write u_rands in binary to a stream.
+   *
+   * @tparam digit_gen the type of digit generator for the u_rands.
+   *
+   * The output begins with a header giving the base, followed by the
+   * u_rands in the format given by u_rand::serialize.  The output is
+   * accumulated in a buffer which is written to the stream when it is full,
+   * when flush() is called, and by the destructor.  The u_rands can be read
+   * back with u_rand_reader.
+   */
+  template<typename digit_gen> class u_rand_writer {
+  public:
+    /**
+     * The constructor.
+     *
+     * @param os the output stream (which should be opened in binary mode).
+     * @param bufsize the size of the buffer in bytes.
+     *
+     * This writes the header to the buffer.
+     */
+    explicit u_rand_writer(std::ostream& os, size_t bufsize = 65536)
+      : _os(os), _buf((std::max)(bufsize, size_t(hsize))), _n(hsize)
+      , _count(0) {
+      u_rand_stream_header::set(&_buf[0], digit_gen::base, digit_gen::bits);
+    }
+    /**
+     * The destructor (which calls flush()).
+     */
+    ~u_rand_writer() { flush(); }
+    /**
+     * Write a u_rand.
+     *
+     * @tparam store the digit_store for x.
+     * @param x the u_rand to write.
+     */
+    template<typename store>
+    void write(const u_rand<digit_gen, store>& x) {
+      size_t m = x.serialized_size();
+      if (_n + m > _buf.size()) {
+        flush();
+        if (m > _buf.size()) _buf.resize(m);
+      }
+      _n = size_t(x.serialize(&_buf[_n]) - &_buf[0]);
+      ++_count;
+    }
+    /**
+     * Write the contents of the buffer to the stream and flush the stream.
+     */
+    void flush() {
+      if (_n) _os.write(reinterpret_cast<const char*>(&_buf[0]),
+                        std::streamsize(_n));
+      _n = 0;
+      _os.flush();
+    }
+    /**
+     * @return the number of u_rands written.
+     */
+    long long count() const { return _count; }
+  private:
+    static const size_t hsize = u_rand_stream_header::size;
+    // Disable copy assignment
+    u_rand_writer& operator=(const u_rand_writer&);
+    std::ostream& _os;
+    std::vector<unsigned char> _buf;
+    size_t _n;                  // the number of bytes in _buf
+    long long _count;
+  };
+
+  /**
+   * @brief Read u_rands written by u_rand_writer.
+   *
+   * @tparam digit_gen the type of digit generator for the u_rands.
+   *
+   * The input is read into a buffer in large blocks.  The u_rands which are
+   * read can be used normally; in particular, further digits are generated
+   * as needed.  Thus archived samples can be refined to higher precision.
+   */
+  template<typename digit_gen> class u_rand_reader {
+  public:
+    /**
+     * The constructor.
+     *
+     * @param is the input stream (which should be opened in binary mode).
+     * @param bufsize the size of the buffer in bytes.
+     * @exception std::runtime_error if the header is missing or is for a
+     *   different base.
+     */
+    explicit u_rand_reader(std::istream& is, size_t bufsize = 65536)
+      : _is(is), _buf((std::max)(bufsize, size_t(hsize))), _beg(0), _end(0)
+      , _count(0) {
+      unsigned char h[u_rand_stream_header::size];
+      u_rand_stream_header::set(h, digit_gen::base, digit_gen::bits);
+      while (_end < hsize && fill()) {}
+      if (_end < hsize || std::memcmp(h, &_buf[0], 4) != 0)
+        throw std::runtime_error("u_rand_reader: not a u_rand stream");
+      if (std::memcmp(h, &_buf[0], hsize) != 0)
+        throw std::runtime_error("u_rand_reader: mismatch in base");
+      _beg = hsize;
+    }
+    /**
+     * Read a u_rand.
+     *
+     * @tparam store the digit_store for x.
+     * @param[out] x the u_rand to set.
+     * @exception std::runtime_error if the data is invalid or the stream
+     *   ends in the middle of a u_rand.
+     * @return true if a u_rand was read, false at the end of the stream.
+     */
+    template<typename store>
+    bool read(u_rand<digit_gen, store>& x) {
+      for (;;) {
+        if (_beg < _end) {
+          const unsigned char* p =
+            x.deserialize(&_buf[_beg], &_buf[0] + _end);
+          if (p) {
+            _beg = size_t(p - &_buf[0]);
+            ++_count;
+            return true;
+          }
+        }
+        if (!fill()) {
+          if (_beg < _end)
+            throw std::runtime_error("u_rand_reader: truncated u_rand");
+          return false;
+        }
+      }
+    }
+    /**
+     * @return the number of u_rands read.
+     */
+    long long count() const { return _count; }
+  private:
+    static const size_t hsize = u_rand_stream_header::size;
+    // Disable copy assignment
+    u_rand_reader& operator=(const u_rand_reader&);
+    std::istream& _is;
+    std::vector<unsigned char> _buf;
+    size_t _beg, _end;          // the unread data is in [_beg, _end)
+    long long _count;
+    // Read more data, discarding the data already read, and enlarging the
+    // buffer if it's full; return false if there's no more data.
+    bool fill() {
+      if (_beg) {
+        if (_end > _beg)
+          std::memmove(&_buf[0], &_buf[_beg], _end - _beg);
+        _end -= _beg; _beg = 0;
+      }
+      if (_end == _buf.size()) _buf.resize(2 * _buf.size());
+      _is.read(reinterpret_cast<char*>(&_buf[_end]),
+               std::streamsize(_buf.size() - _end));
+      size_t n = size_t(_is.gcount());
+      _end += n;
+      return n > 0;
+    }
+  };
+
+}
+
+#endif  // EXRANDOM_U_RAND_STREAM_HPP
@@ -0,0 +1,83 @@
+/**
+ * @file u_rand_workspace.hpp
+ * @author Charles Karney <charles.karney@sri.com>
+ * @brief Definition of u_rand_workspace
+ *
+ * Copyright (c) Charles Karney (2016) and licensed under the MIT/X11 License.
+ * For more information, see http://exrandom.sourceforge.net/
+ */
+
+#if !defined(EXRANDOM_U_RAND_WORKSPACE_HPP)
+#define EXRANDOM_U_RAND_WORKSPACE_HPP 1
+
+#include <vector>               // for the slots
+#include <stdexcept>            // for std::runtime_error
+
+#include <exrandom/u_rand.hpp>
+
+namespace exrandom {
+
+  /**
+   * @brief Temporary u_rands shared by several distributions.
+   *
+   * @tparam digit_gen the type of digit generator.
+   *
+   * The *_dist classes need a few u_rands as temporary storage while
+   * sampling; by default, each distribution holds its own.  A
+   * u_rand_workspace holds u_rand_workspace::size u_rands (the slots) bound
+   * to one digit generator, and several distributions constructed with the
+   * same workspace use its slots instead.  Because the temporaries are
+   * reinitialized on each call, the results are the same as with
+   * separate storage.  The slots are allocated together when the workspace
+   * is constructed, their digit vectors retain their capacity from call to
+   * call, and constructing a distribution from a workspace allocates
+   * nothing.
+   *
+   * The slots used by a distribution start at the @e first argument of its
+   * constructor; unit_normal_dist and unit_exponential_dist use 3 slots,
+   * discrete_normal_dist uses 2, unit_normal_kahn uses 5, and
+   * unit_uniform_dist uses 1.  Distributions may share slots provided that
+   * their sampling calls are not nested and not concurrent.  A workspace
+   * cannot be copied; a copy of a distribution which uses a workspace
+   * shares the workspace.
+   */
+  template<typename digit_gen> class u_rand_workspace {
+  public:
+    /**
+     * The number of slots.
+     */
+    static const int size = 8;
+    /**
+     * The constructor.
+     *
+     * @param D a reference to the digit generator to be used.
+     */
+    explicit u_rand_workspace(digit_gen& D)
+      : _D(D), _u(size, u_rand<digit_gen>(D)) {}
+    /**
+     * Return a slot.
+     *
+     * @param k the index of the slot.
+     * @exception std::runtime_error if @e k is not in [0, size).
+     * @return a reference to the u_rand in slot @e k.
+     */
+    u_rand<digit_gen>& slot(int k) {
+      if (!(k >= 0 && k < size))
+        throw std::runtime_error("u_rand_workspace: slot out of range");
+      return _u[k];
+    }
+    /**
+     * @return a reference to the digit generator used in the constructor.
+     */
+    digit_gen& digit_generator() const { return _D; }
+  private:
+    // Disable copy construction and copy assignment
+    u_rand_workspace(const u_rand_workspace&);
+    u_rand_workspace& operator=(const u_rand_workspace&);
+    digit_gen& _D;
+    std::vector<u_rand<digit_gen> > _u;
+  };
+
+}
+
+#endif  // EXRANDOM_U_RAND_WORKSPACE_HPP
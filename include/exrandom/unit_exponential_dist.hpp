@@ -11,6 +11,8 @@
 #define EXRANDOM_UNIT_EXPONENTIAL_DIST_HPP 1
 
 #include <exrandom/u_rand.hpp>
+#include <exrandom/u_rand_workspace.hpp>
+#include <exrandom/sample_stats.hpp>
 
 #if defined(_MSC_VER)
 // Squelch warnings about constant conditional expressions
@@ -28,6 +30,8 @@ namespace exrandom {
    *
    * @tparam digit_gen the type of digit generator.
    * @tparam bit_optimized if true use Algorithm E, else use Algorithm V.
+   * @tparam stats the statistics policy, no_stats (the default) or
+   *   sample_stats.
    *
    * This class allows a u-rand to be returned via the
    * unit_exponential_dist::generate member function or a floating point
@@ -38,8 +42,15 @@ namespace exrandom {
    * the constructor locks you into a specific floating point type.)
    *
    * If bit_optimized is true, digit_gen::base must be even.
+   *
+   * With @e stats = sample_stats, the digits used are recorded under
+   * sample_stage::X (and sample_stage::round for value()) and each round of
+   * the loop which rejects the fractional part (incrementing the multiple of
+   * 1/2, or 1 for Algorithm V) is recorded as a rejection at step 1; these
+   * are available via statistics().
    */
-  template<typename digit_gen, bool bit_optimized = true>
+  template<typename digit_gen, bool bit_optimized = true,
+           typename stats = no_stats>
   class unit_exponential_dist {
   public:
     /**
@@ -47,24 +58,51 @@ namespace exrandom {
      *
      * @param D a reference to the digit generator to be used.
      */
-    unit_exponential_dist(digit_gen& D) : _D(D), _v(D), _w(D), _x(D) {}
+    unit_exponential_dist(digit_gen& D)
+      : _D(D), _v0(D), _w0(D), _x0(D), _v(_v0), _w(_w0), _x(_x0) {}
+    /**
+     * Construct using the temporary storage of a u_rand_workspace.
+     *
+     * @param w the workspace; its digit generator is used.
+     * @param first the first of the 3 slots of @e w to use (default 0).
+     */
+    explicit unit_exponential_dist(u_rand_workspace<digit_gen>& w,
+                                   int first = 0)
+      : _D(w.digit_generator()), _v0(_D), _w0(_D), _x0(_D)
+      , _v(w.slot(first)), _w(w.slot(first + 1)), _x(w.slot(first + 2)) {}
+    /**
+     * The copy constructor.
+     *
+     * @param d the distribution to copy.
+     *
+     * The copy uses the same workspace as @e d (if any).
+     */
+    unit_exponential_dist(const unit_exponential_dist& d)
+      : _D(d._D), _v0(d._v0), _w0(d._w0), _x0(d._x0)
+      , _v(d.owned() ? _v0 : d._v), _w(d.owned() ? _w0 : d._w)
+      , _x(d.owned() ? _x0 : d._x), _stats(d._stats) {}
 
     /**
      * Generate the next deviate as a u_rand.
      *
      * @tparam Generator the type of g.
+     * @tparam store the digit_store for x.
      * @param g the random generator engine.
      * @param[out] x the u_rand to set.
      */
-    template<typename Generator>
-    void generate(Generator& g, u_rand<digit_gen>& x) {
+    template<typename Generator, typename store>
+    void generate(Generator& g, u_rand<digit_gen, store>& x) {
       // A simple rejection method gives the 1/2 fractional part.  The number of
       // rejections gives the multiples of 1/2.
       //           bits: used    fract
       // original stats: 9.31615 2.05429
       // new      stats: 7.23226 1.74305
+      long long c = _stats.start(_D);
       int k = 0;
-      while (!F(g, x)) ++k;     // Executed 1/(1 - exp(-1/2)) on average
+      // Executed 1/(1 - exp(-1/2)) on average
+      while (!F(g, x)) { ++k; _stats.reject(1); }
+      _stats.tally(sample_stage::X, _D, c);
+      _stats.sample();
       // If k is odd, add base/2 to first digit (allowing for base = 2^32)
       if (bit_optimized && (k % 2) != 0) x.rawdigit(0) += (bm1 - 1U) / 2U + 1U;
       x.set_integer(bit_optimized ? k/2 : k);
@@ -82,9 +120,42 @@ namespace exrandom {
     template<typename RealType, typename Generator>
     RealType value(Generator& g) {
       generate(g, _x);
-      return _x.template value<RealType>(g);
+      long long c = _stats.start(_D);
+      RealType v = _x.template value<RealType>(g);
+      _stats.tally(sample_stage::round, _D, c);
+      return v;
     }
 
+    /**
+     * Generate the next deviate and round it to nearest floating point number
+     * with a reduced precision.
+     *
+     * @tparam RealType the floating point type of the result.
+     * @tparam Generator the type of g.
+     * @param g the random generator engine.
+     * @param precision the number of (radix) digits in the result.
+     * @return the exponential deviate (see u_rand::reduced_value).
+     */
+    template<typename RealType, typename Generator>
+    RealType reduced_value(Generator& g, int precision) {
+      generate(g, _x);
+      long long c = _stats.start(_D);
+      RealType v = _x.template reduced_value<RealType>(g, precision);
+      _stats.tally(sample_stage::round, _D, c);
+      return v;
+    }
+
+    /**
+     * @return the statistics collected (only useful with @e stats =
+     *   sample_stats).
+     */
+    const stats& statistics() const { return _stats; }
+    /**
+     * @return the statistics collected (only useful with @e stats =
+     *   sample_stats); use this to reset the counters.
+     */
+    stats& statistics() { return _stats; }
+
     /**
      * @return a reference to the digit generator used in the constructor.
      */
@@ -101,9 +172,13 @@ namespace exrandom {
     digit_gen& _D;
     static_assert(!bit_optimized || (bm1 & 1U),
                   "unit_exponential_dist: base must be even");
-    u_rand<digit_gen> _v, _w, _x; // temporary storage
-    template<typename Generator>
-    bool F(Generator& g, u_rand<digit_gen>& p) {
+    u_rand<digit_gen> _v0, _w0, _x0; // own temporary storage
+    // The temporary storage, _v0, etc., or slots in a u_rand_workspace
+    u_rand<digit_gen> &_v, &_w, &_x;
+    stats _stats;
+    bool owned() const { return &_x == &_x0; }
+    template<typename Generator, typename store>
+    bool F(Generator& g, u_rand<digit_gen, store>& p) {
       p.init();
       // The early bale out
       if (bit_optimized && !p.less_than_half(g)) return false;
@@ -0,0 +1,206 @@
+/**
+ * @file unit_exponential_lanes.hpp
+ * @author Charles Karney <charles.karney@sri.com>
+ * @brief Definition of unit_exponential_lanes
+ *
+ * Copyright (c) Charles Karney (2016) and licensed under the MIT/X11 License.
+ * For more information, see http://exrandom.sourceforge.net/
+ */
+
+#if !defined(EXRANDOM_UNIT_EXPONENTIAL_LANES_HPP)
+#define EXRANDOM_UNIT_EXPONENTIAL_LANES_HPP 1
+
+#include <vector>               // for the pending results
+#include <cstdint>              // for uint32_t
+#include <cstddef>              // for size_t
+#include <cmath>                // for std::ldexp
+#include <limits>
+
+#include <exrandom/u_rand.hpp>
+
+namespace exrandom {
+
+  /**
+   * @brief Sample exponential deviates exactly in batches using several
+   * lanes.
+   *
+   * @tparam digit_gen the type of digit generator; the base must be even.
+   * @tparam L the number of lanes (default 8).
+   *
+   * This implements Algorithm E, as unit_exponential_dist does, but runs L
+   * independent instances in lock step.  On each step, L digits are drawn
+   * with a single call to digit_gen::generate and each lane advances by one
+   * comparison of its von Neumann chain using only the first digits of the
+   * u-rands involved.  This update has no branches and the compiler usually
+   * vectorizes it (use, e.g., -O3 -march=native to enable AVX2 or AVX-512);
+   * a large base, e.g., rand_digit<0> (base 2<sup>32</sup>), makes the first
+   * digits almost always decisive.  A lane whose comparison is tied on the
+   * first digit (with probability 1/base) is finished with exact,
+   * digit-by-digit, comparisons of u-rands.  Accepted deviates are rounded
+   * with u_rand::value which generates additional digits as needed.  Thus
+   * the results are exactly exponentially distributed.
+   *
+   * The results are returned in the order in which the lanes complete them
+   * and so differ from those of unit_exponential_dist with the same engine.
+   * The state of incomplete lanes is retained between calls to generate().
+   */
+  template<typename digit_gen, int L = 8>
+  class unit_exponential_lanes {
+  public:
+    /**
+     * The number of lanes.
+     */
+    static const int lanes = L;
+    /**
+     * The constructor.
+     *
+     * @param D a reference to the digit generator to be used.
+     */
+    unit_exponential_lanes(digit_gen& D) : _D(D), _v(D), _w(D), _x(D) {
+      for (int l = 0; l < L; ++l) _k[l] = _m[l] = _xd[l] = _p[l] = 0U;
+    }
+    /**
+     * Fill an array with exponential deviates.
+     *
+     * @tparam RealType the floating point type of the results.
+     * @tparam Generator the type of g.
+     * @param g the random generator engine.
+     * @param p a pointer to the first element of the array.
+     * @param n the number of elements of the array.
+     */
+    template<typename RealType, typename Generator>
+    void generate(Generator& g, RealType* p, size_t n) {
+      size_t i = 0;
+      for (; i < n && !_pending.empty(); ++i) {
+        p[i] = _pending.back().template value<RealType>(g);
+        _pending.pop_back();
+      }
+      uint_t d[L];
+      std::uint32_t v[L], acc[L], tie[L];
+      int ev[L];
+      while (i < n) {
+        _D.generate(g, d, L);
+        std::uint32_t event = 0U;
+        for (int l = 0; l < L; ++l) v[l] = std::uint32_t(d[l]);
+        // Advance each lane.  _m[l] is the length of the chain of decreasing
+        // values starting with x (0 if x is needed) and _p[l] is the last
+        // value; the first digit of the next value is v[l].
+        for (int l = 0; l < L; ++l) {
+          std::uint32_t m = _m[l], a = v[l], b = _p[l],
+            in = m != 0U ? 1U : 0U,
+            start = (1U - in) & (a <= halfm1 ? 1U : 0U),
+            cont = in & (a < b ? 1U : 0U),
+            fin = in & (a > b ? 1U : 0U),
+            // reject if x >= 1/2 or the chain length is even
+            rej = ((1U - in) - start) | (fin & (1U - (m & 1U)));
+          tie[l] = in & (a == b ? 1U : 0U);
+          acc[l] = fin & m & 1U;
+          _k[l] += rej;
+          // Select with masks (0 - 1U is all ones)
+          _xd[l] ^= (_xd[l] ^ a) & (0U - start);
+          _p[l] = b ^ ((a ^ b) & (0U - (start | cont)));
+          _m[l] = (m + start + cont) & (fin - 1U);
+          event |= acc[l] | tie[l];
+        }
+        if (!event) continue;
+        // Gather the lanes with events without branches
+        int ne = 0;
+        for (int l = 0; l < L; ++l) {
+          ev[ne] = l; ne += int(acc[l] | tie[l]);
+        }
+        for (int j = 0; j < ne; ++j) {
+          int l = ev[j];
+          std::uint32_t k = _k[l], x0 = _xd[l];
+          bool onedigit = true;
+          if (tie[l]) {
+            _x.init().append(x0);
+            bool a = resolve(g, _m[l], _p[l], v[l]);
+            _m[l] = 0U;
+            if (!a) { ++_k[l]; continue; }
+            onedigit = _x.ndigits() == 1U;
+          }
+          _k[l] = 0U;
+          // If k is odd, add base/2 to first digit (allowing for base = 2^32)
+          if (k & 1U) x0 += halfm1 + 1U;
+          if (onedigit && i < n) {
+            if (round(g, k / 2U, x0, p[i])) { ++i; continue; }
+          } else if (onedigit)
+            _x.init().append(x0);
+          else
+            _x.rawdigit(0) = x0;
+          _x.set_integer(unsigned(k / 2U));
+          if (i < n)
+            p[i++] = _x.template value<RealType>(g);
+          else
+            _pending.push_back(_x);
+        }
+      }
+    }
+    /**
+     * @return a reference to the digit generator used in the constructor.
+     */
+    digit_gen& digit_generator() const { return _D; }
+    /**
+     * The base of the digit generator.
+     */
+    static const uint_t base = digit_gen::base;
+  private:
+    static const uint_t bm1 = digit_gen::max_value;
+    static const std::uint32_t halfm1 = std::uint32_t((bm1 - 1U) / 2U);
+    static_assert(bm1 & 1U, "unit_exponential_lanes: base must be even");
+    static_assert(L > 0, "unit_exponential_lanes: L must be positive");
+    // Disable copy assignment
+    unit_exponential_lanes& operator=(const unit_exponential_lanes&);
+    digit_gen& _D;
+    u_rand<digit_gen> _v, _w, _x; // temporary storage
+    std::vector<u_rand<digit_gen> > _pending;
+    // The state of the lanes: the integer part, the chain length, the first
+    // digits of x and of the last value in the chain
+    std::uint32_t _k[L], _m[L], _xd[L], _p[L];
+    // Round n + x to nearest, where the first digit of x is x0, with one
+    // more digit x1 if RealType is an IEEE type with digits < 63 and the base
+    // is 2^32.  The 64-bit integer M = n * 2^58 + (x0 * 2^32 + x1) / 2^6 (or
+    // x0 * 2^32 + x1 if n = 0) is truncated and the remaining part is in
+    // (0, 1); so setting the low bit of M gives the correct rounding when M
+    // has at least digits + 2 significant bits.  Return false (with _x
+    // holding x0 and x1) if this doesn't apply.
+    template<typename Generator, typename RealType>
+    bool round(Generator& g, std::uint32_t n, std::uint32_t x0, RealType& z) {
+      static const int digits = std::numeric_limits<RealType>::digits;
+      if (!(std::numeric_limits<RealType>::is_iec559 &&
+            std::numeric_limits<RealType>::round_style ==
+            std::round_to_nearest && digit_gen::bits == 32 && digits < 63)) {
+        _x.init().append(x0);
+        return false;
+      }
+      uint_t x1 = _D(g);
+      std::uint64_t f = (std::uint64_t(x0) << 32) | std::uint64_t(x1),
+        M = n ? (std::uint64_t(n) << 58) | (f >> 6) : f;
+      bool ok = n ? n < 64U : (f >> (digits < 63 ? digits + 1 : 0)) != 0U;
+      const RealType s64 = RealType(1) / RealType(4294967296.0) /
+        RealType(4294967296.0);
+      if (ok)
+        z = RealType(M | 1U) * (n ? 64 * s64 : s64);
+      else
+        _x.init().append(x0).append(x1);
+      return ok;
+    }
+    // The chain of length m ending with first digit p is followed by a value
+    // with the same first digit v.  _x holds the first digit of x.  Finish
+    // the chain with exact comparisons and return true if x is accepted.
+    template<typename Generator>
+    bool resolve(Generator& g, std::uint32_t m, std::uint32_t p,
+                 std::uint32_t v) {
+      if (m > 1U) _v.init().append(p);
+      _w.init().append(v);
+      if (!_w.less_than(g, m > 1U ? _v : _x)) return (m & 1U) != 0U;
+      for (++m;; ++m) {
+        _w.swap(_v);            // _v is now the last value in the chain
+        if (!_w.init().less_than(g, _v)) return (m & 1U) != 0U;
+      }
+    }
+  };
+
+}
+
+#endif  // EXRANDOM_UNIT_EXPONENTIAL_LANES_HPP
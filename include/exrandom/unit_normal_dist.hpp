@@ -11,8 +11,20 @@
 #define EXRANDOM_UNIT_NORMAL_DIST_HPP 1
 
 #include <algorithm>            // for std::min, std::max
+#include <type_traits>          // for std::integral_constant
 
 #include <exrandom/u_rand.hpp>
+#include <exrandom/u_rand_workspace.hpp>
+#include <exrandom/normal_k_table.hpp>
+#include <exrandom/normal_ziggurat_table.hpp>
+#include <exrandom/sample_stats.hpp>
+#include <exrandom/bernoulli.hpp>
+
+#if defined(_MSC_VER)
+// Squelch warnings about constant conditional expressions
+#  pragma warning (push)
+#  pragma warning (disable: 4127)
+#endif
 
 namespace exrandom {
 
@@ -24,6 +36,12 @@ namespace exrandom {
    * This implements Algorithm N.
    *
    * @tparam digit_gen the type of digit generator.
+   * @tparam tabulated if true carry out steps 1 and 2 with normal_k_table
+   *   (default false).
+   * @tparam stats the statistics policy, no_stats (the default) or
+   *   sample_stats.
+   * @tparam ziggurat if true carry out step 4 with normal_ziggurat_table
+   *   (default false).
    *
    * This class allows a u-rand to be returned via the
    * unit_normal_dist::generate member function or a floating point result via
@@ -34,33 +52,76 @@ namespace exrandom {
    * constructor locks you into a specific floating point type.)
    *
    * digit_gen::base must be less than 2<sup>15</sup> or a power of two.
+   *
+   * Setting @e tabulated = true gives the same distribution of results,
+   * but it is faster because steps 1 and 2 are usually accomplished by
+   * generating a single digit.  (The default is false so that the results
+   * with a given seed are unchanged.)
+   *
+   * Setting @e ziggurat = true also gives the same distribution of results.
+   * For k &lt; normal_ziggurat_table::K, step 4 is then usually decided
+   * with one digit of the fraction and one additional digit, instead of
+   * k + 1 applications of Algorithm B.  This requires that the base be a
+   * power of two no less than 2<sup>8</sup>.
+   *
+   * With @e stats = sample_stats, the use of digits by the various steps of
+   * the algorithm and the rejections at steps 2 and 4 are recorded; these
+   * are available via statistics().
    */
-  template<typename digit_gen> class unit_normal_dist {
+  template<typename digit_gen, bool tabulated = false,
+           typename stats = no_stats, bool ziggurat = false>
+  class unit_normal_dist {
   public:
     /**
      * The constructor.
      *
      * @param D a reference to the digit generator to be used.
      */
-    unit_normal_dist(digit_gen& D) : _D(D), _y(D), _z(D), _x(D) {}
+    unit_normal_dist(digit_gen& D)
+      : _D(D), _y0(D), _z0(D), _x0(D), _y(_y0), _z(_z0), _x(_x0) {}
+    /**
+     * Construct using the temporary storage of a u_rand_workspace.
+     *
+     * @param w the workspace; its digit generator is used.
+     * @param first the first of the 3 slots of @e w to use (default 0).
+     */
+    explicit unit_normal_dist(u_rand_workspace<digit_gen>& w, int first = 0)
+      : _D(w.digit_generator()), _y0(_D), _z0(_D), _x0(_D)
+      , _y(w.slot(first)), _z(w.slot(first + 1)), _x(w.slot(first + 2)) {}
+    /**
+     * The copy constructor.
+     *
+     * @param d the distribution to copy.
+     *
+     * The copy uses the same workspace as @e d (if any).
+     */
+    unit_normal_dist(const unit_normal_dist& d)
+      : _D(d._D), _y0(d._y0), _z0(d._z0), _x0(d._x0)
+      , _y(d.owned() ? _y0 : d._y), _z(d.owned() ? _z0 : d._z)
+      , _x(d.owned() ? _x0 : d._x), _stats(d._stats) {}
 
     /**
      * Generate the next deviate as a u_rand.
      *
      * @tparam Generator the type of g.
+     * @tparam store the digit_store for x.
      * @param g the random generator engine.
      * @param[out] x the u_rand to set.
      */
-    template<typename Generator>
-    void generate(Generator& g, u_rand<digit_gen>& x) {
+    template<typename Generator, typename store>
+    void generate(Generator& g, u_rand<digit_gen, store>& x) {
+      long long c = _stats.start(_D);
       for (;;) {
-        int k = G(g);                                // step 1
-        if (!P(g, k * (k - 1))) continue;            // step 2
-        x.init();                                    // step 3
-        int j = k + 1; while (j-- && B(g, k, x)) {}; // step 4
-        if (!(j < 0)) continue;
+        int k = GP(g, c);                            // steps 1 and 2
+        if (k < 0) { _stats.reject(2); continue; }
+        bool accept = step34(g, k, x,                // steps 3 and 4
+                             std::integral_constant<bool, ziggurat>());
+        _stats.tally(sample_stage::B, _D, c);
+        if (!accept) { _stats.reject(4); continue; }
         x.set_integer(k);                            // step 5
         if (_y.init().less_than_half(g)) x.negate(); // step 6
+        _stats.tally(sample_stage::sign, _D, c);
+        _stats.sample();
         return;                                      // step 7
       }
     }
@@ -76,9 +137,42 @@ namespace exrandom {
     template<typename RealType, typename Generator>
     RealType value(Generator& g) {
       generate(g, _x);
-      return _x.template value<RealType>(g);
+      long long c = _stats.start(_D);
+      RealType v = _x.template value<RealType>(g);
+      _stats.tally(sample_stage::round, _D, c);
+      return v;
     }
 
+    /**
+     * Generate the next deviate and round it to nearest floating point number
+     * with a reduced precision.
+     *
+     * @tparam RealType the floating point type of the result.
+     * @tparam Generator the type of g.
+     * @param g the random generator engine.
+     * @param precision the number of (radix) digits in the result.
+     * @return the normal deviate (see u_rand::reduced_value).
+     */
+    template<typename RealType, typename Generator>
+    RealType reduced_value(Generator& g, int precision) {
+      generate(g, _x);
+      long long c = _stats.start(_D);
+      RealType v = _x.template reduced_value<RealType>(g, precision);
+      _stats.tally(sample_stage::round, _D, c);
+      return v;
+    }
+
+    /**
+     * @return the statistics collected (only useful with @e stats =
+     *   sample_stats).
+     */
+    const stats& statistics() const { return _stats; }
+    /**
+     * @return the statistics collected (only useful with @e stats =
+     *   sample_stats); use this to reset the counters.
+     */
+    stats& statistics() { return _stats; }
+
     /**
      * @return a reference to the digit generator used in the constructor.
      */
@@ -97,52 +191,65 @@ namespace exrandom {
     // Disable copy assignment
     unit_normal_dist& operator=(const unit_normal_dist&);
     digit_gen& _D;
-    u_rand<digit_gen> _y, _z, _x; // temporary storage
-    // Algorithm H: true with probability exp(-1/2).
+    u_rand<digit_gen> _y0, _z0, _x0; // own temporary storage
+    // The temporary storage, _y0, etc., or slots in a u_rand_workspace
+    u_rand<digit_gen> &_y, &_z, &_x;
+    stats _stats;
+    bool owned() const { return &_x == &_x0; }
+    // Algorithm H (and steps N1 and N2) and Algorithm C
+    typedef bernoulli_exp<digit_gen> H;
+    typedef bernoulli_rational<digit_gen> C;
+    // Steps N1 and N2: return k >= 0 with probability (1 - exp(-1/2)) *
+    // exp(-k^2/2), otherwise -1.  Digits are tallied using count c.
     template<typename Generator>
-    bool H(Generator& g) {
-      if (!_y.init().less_than_half(g)) return true;
-      for (;;) {
-        if (!_z.init().less_than(g, _y)) return false;
-        if (!_y.init().less_than(g, _z)) return true;
-      }
+    EXRANDOM_PROFILE_STEP
+    int GP(Generator& g, long long& c) {
+      typedef normal_k_table<base> table;
+      int k;
+      if (tabulated) {
+        k = table::standard()(g, _y);
+        if (k != table::K) {
+          _stats.tally(sample_stage::G, _D, c);
+          return k < table::K ? k : -1;
+        }
+        k += H::count_half(g, _y, _z); // k >= K
+      } else
+        k = H::count_half(g, _y, _z);
+      _stats.tally(sample_stage::G, _D, c);
+      bool accept = H::half_n(g, k * (k - 1), _y, _z);
+      _stats.tally(sample_stage::P, _D, c);
+      return accept ? k : -1;
     }
 
-    // Step N1: return n >= 0 with prob. exp(-n/2) * (1 - exp(-1/2)).
-    template<typename Generator>
-    int G(Generator& g)
-    { int n = 0; while (H(g)) ++n; return n; }
-
-    // Step N2: true with probability exp(-n/2).
-    template<typename Generator>
-    bool P(Generator& g, int n)
-    { while (n-- && H(g)) {}; return n < 0; }
-
-    // Algorithm C: return (-1, 0, 1) with prob (1/m, 1/m, 1-2/m).
-    template<typename Generator>
-    int C(Generator& g, int m) {
-      int n1 = 1, n2 = 2;
-      // Limit temporary base to 2^maxbits to avoid integer overflow
-      const int maxbits = 15;
-      const int shift = (power_of_two && bits > maxbits) ? bits - maxbits : 0;
-      const int tbase = (power_of_two && bits > maxbits) ?
-        (uint_t(1) << maxbits) : base;
-      for (;;) {
-        int d = int(_D(g) >> shift);
-        if ((n1 = (std::max)(0, n1 * tbase - d * m)) >= m) return -1;
-        if ((n2 = (std::min)(m, n2 * tbase - d * m)) <= 0) return +1;
-        if (n1 <= 0 && n2 >= m) return 0;
-      }
+    // Steps 3 and 4: set x to uniform deviate and accept it with probability
+    // exp(-x * (2*k + x) / 2).
+    template<typename Generator, typename store>
+    EXRANDOM_PROFILE_STEP
+    bool step34(Generator& g, int k, u_rand<digit_gen, store>& x,
+                std::false_type) {
+      x.init();
+      int j = k + 1; while (j-- && B(g, k, x)) {};
+      return j < 0;
+    }
+    template<typename Generator, typename store>
+    EXRANDOM_PROFILE_STEP
+    bool step34(Generator& g, int k, u_rand<digit_gen, store>& x,
+                std::true_type) {
+      typedef normal_ziggurat_table<base> table;
+      return k < table::K ? table::standard()(g, k, x, _y) :
+        step34(g, k, x, std::false_type());
     }
 
     // Algorithm B: true with prob exp(-x * (2*k + x) / (2*k + 2)).
-    template<typename Generator>
-    bool B(Generator& g, int k, u_rand<digit_gen>& x) {
+    template<typename Generator, typename store>
+    EXRANDOM_PROFILE_STEP
+    bool B(Generator& g, int k, u_rand<digit_gen, store>& x) {
       int n = 0, m = 2 * k + 2, f;
       for (;; ++n) {
-        f = k ? 0 : C(g, m); if (f < 0) break;
-        if (!_z.init().less_than(g, n ? _y : x)) break;
-        f = k ? C(g, m) : f; if (f < 0) break;
+        f = k ? 0 : C::compare(g, _D, 1, 2, m); if (f < 0) break;
+        if (!(n ? _z.init().less_than(g, _y) : _z.init().less_than(g, x)))
+          break;
+        f = k ? C::compare(g, _D, 1, 2, m) : f; if (f < 0) break;
         if (f == 0 && (!_y.init().less_than(g, x))) break;
         _y.swap(_z);            // an efficient way of doing y = z
       }
@@ -153,4 +260,8 @@ namespace exrandom {
 
 }
 
+#if defined(_MSC_VER)
+#  pragma warning (pop)
+#endif
+
 #endif  // EXRANDOM_UNIT_NORMAL_DIST_HPP
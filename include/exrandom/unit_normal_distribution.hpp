@@ -13,25 +13,131 @@
 /**
  * @relates exrandom::unit_normal_distribution
  *
- * Should exrandom::unit_normal_distribution use exrandom::unit_normal_kahn
- * instead of exrandom::unit_normal_dist as the underlying distribution.
+ * Should exrandom::unit_normal_distribution use exrandom::kahn_normal
+ * instead of exrandom::von_neumann_normal as the default algorithm.
  * Because the output of exrandom::unit_normal_kahn is slightly biased,
  * EXRANDOM_USE_KAHN should be set to 0.
  */
+#if !defined(EXRANDOM_USE_KAHN)
 #define EXRANDOM_USE_KAHN 0
+#endif
 
 #include <iostream>             // for std::ostream, etc.
 #include <limits>
+#include <cstddef>              // for size_t
 
 #include <exrandom/rand_digit.hpp>
-#if EXRANDOM_USE_KAHN
 #include <exrandom/unit_normal_kahn.hpp>
-#else
 #include <exrandom/unit_normal_dist.hpp>
-#endif
 
 namespace exrandom {
 
+  /**
+   * @brief The algorithm policy for unit_normal_distribution which uses
+   * Algorithm N.
+   *
+   * The underlying distribution is unit_normal_dist with a base of
+   * 2<sup>32</sup> if the radix of RealType is 2 and the radix otherwise.
+   * This is the default.
+   */
+  struct von_neumann_normal {
+    /**
+     * @brief The underlying distribution for a given RealType.
+     *
+     * @tparam RealType the floating point type of the deviates.
+     */
+    template<typename RealType> class dist {
+    public:
+      /**
+       * The base of the digits.
+       */
+      static const uint_t base = std::numeric_limits<RealType>::radix == 2 ?
+        0UL : std::numeric_limits<RealType>::radix;
+      /**
+       * The digit generator.
+       */
+      typedef rand_digit<base> digit_gen;
+      /**
+       * The distribution.
+       */
+      typedef unit_normal_dist<digit_gen> type;
+    };
+  };
+
+  /**
+   * @brief The algorithm policy for unit_normal_distribution which uses
+   * Algorithm K.
+   *
+   * The underlying distribution is unit_normal_kahn with the base set to the
+   * radix of RealType.  Because unit_normal_kahn is slightly biased, this is
+   * not recommended.
+   */
+  struct kahn_normal {
+    /**
+     * @brief The underlying distribution for a given RealType.
+     *
+     * @tparam RealType the floating point type of the deviates.
+     */
+    template<typename RealType> class dist {
+    public:
+      /**
+       * The base of the digits.
+       */
+      static const uint_t base = std::numeric_limits<RealType>::radix;
+      /**
+       * The digit generator.
+       */
+      typedef rand_digit<base> digit_gen;
+      /**
+       * The distribution.
+       */
+      typedef unit_normal_kahn<digit_gen> type;
+    };
+  };
+
+  /**
+   * @brief The algorithm policy for unit_normal_distribution which uses
+   * Algorithm N with tables.
+   *
+   * The underlying distribution is unit_normal_dist with the same base as
+   * von_neumann_normal and with @e tabulated = true and (if the radix of
+   * RealType is 2) @e ziggurat = true.  The results have the same
+   * distribution as with von_neumann_normal but the sampling is faster.
+   */
+  struct ziggurat_normal {
+    /**
+     * @brief The underlying distribution for a given RealType.
+     *
+     * @tparam RealType the floating point type of the deviates.
+     */
+    template<typename RealType> class dist {
+    public:
+      /**
+       * The base of the digits.
+       */
+      static const uint_t base = std::numeric_limits<RealType>::radix == 2 ?
+        0UL : std::numeric_limits<RealType>::radix;
+      /**
+       * The digit generator.
+       */
+      typedef rand_digit<base> digit_gen;
+      /**
+       * The distribution.
+       */
+      typedef unit_normal_dist<digit_gen, true, no_stats,
+                               std::numeric_limits<RealType>::radix == 2>
+      type;
+    };
+  };
+
+  /// \cond SKIP
+#if EXRANDOM_USE_KAHN
+  typedef kahn_normal default_normal_algorithm;
+#else
+  typedef von_neumann_normal default_normal_algorithm;
+#endif
+  /// \endcond
+
   /**
    * @brief Sample exactly from the unit normal distribution.
    *
@@ -50,13 +156,22 @@ namespace exrandom {
    * the base for unit_normal_dist is set to 2<sup>32</sup>; otherwise (e.g.,
    * RealType is a decimal system), the base is set to the radix.
    *
-   * If the macro EXRANDOM_USE_KAHN is set to 1, then unit_normal_kahn is used
-   * instead (with the base set to the radix for RealType).  Because this
-   * introduces a slight bias, this is not recommended.
+   * The algorithm is selected by @e algorithm which is von_neumann_normal
+   * (the default), ziggurat_normal which uses tables to speed up steps 1, 2,
+   * and 4 of Algorithm N, or kahn_normal which uses unit_normal_kahn instead
+   * (with the base set to the radix for RealType).  Because kahn_normal
+   * introduces a slight bias, it is not recommended.  The default can be
+   * changed to kahn_normal by defining the macro EXRANDOM_USE_KAHN to be 1.
+   * The program tune_normal.cpp in the benchmarks directory reports which
+   * algorithm is fastest on a given machine.
    *
    * @tparam RealType the floating point type of the resulting deviates.
+   * @tparam algorithm the algorithm policy; this provides a class template
+   *   dist<RealType> with typedefs digit_gen and type (the underlying
+   *   distribution which is constructed with a reference to a digit_gen).
    */
-  template<typename RealType = double>
+  template<typename RealType = double,
+           typename algorithm = default_normal_algorithm>
   class unit_normal_distribution {
   public:
     /**
@@ -66,28 +181,81 @@ namespace exrandom {
     /**
      * @brief Parameter type for unit_normal_distribution.
      *
-     * This holds no information because this distribution takes no parameters.
+     * The distribution takes no parameters; this holds the precision of the
+     * deviates.
      */
-    struct param_type {
+    class param_type {
+    public:
       /**
        * The type of the random number distribution.
        */
-      typedef unit_normal_distribution<RealType> distribution_type;
+      typedef unit_normal_distribution distribution_type;
+      /**
+       * Constructs a parameter set.
+       *
+       * @param precision the number of (radix) digits in the deviates; if
+       *   this is 0 (the default), the full precision of RealType is used.
+       */
+      explicit param_type(int precision = 0) : _precision(precision) {}
+      /**
+       * @return the precision of the deviates.
+       */
+      int precision() const { return _precision; }
+      /**
+       * Compare two param_types.
+       * @return true if the precisions are the same.
+       */
+      friend bool operator==(const param_type& p1, const param_type& p2)
+      { return p1._precision == p2._precision; }
+      /**
+       * Contrast two param_types.
+       * @return true if the precisions differ.
+       */
+      friend bool operator!=(const param_type& p1, const param_type& p2)
+      { return !(p1 == p2); }
+    private:
+      int _precision;
     };
     /**
      * Constructs a normal distribution.
+     *
+     * @param precision the number of (radix) digits in the deviates; if this
+     *   is 0 (the default), the full precision of RealType is used.  A
+     *   smaller precision reduces the number of random digits consumed (see
+     *   u_rand::reduced_value).
      */
     explicit
-    unit_normal_distribution() : _normal_dist(_D) {}
+    unit_normal_distribution(int precision = 0)
+      : _param(precision), _normal_dist(_D) {}
 
     /**
      * Constructs a normal distribution with a parameter.
      *
-     * The parameter is ignored because it has no state.
+     * @param p the parameter set.
      */
     explicit
-    unit_normal_distribution(const param_type& /*p*/)
-      : _normal_dist(_D) {}
+    unit_normal_distribution(const param_type& p)
+      : _param(p), _normal_dist(_D) {}
+
+    /**
+     * The copy constructor.
+     *
+     * @param d the distribution to copy.
+     *
+     * The copy has its own digit generator; so copies can be used
+     * independently, e.g., in different threads.
+     */
+    unit_normal_distribution(const unit_normal_distribution& d)
+      : _param(d._param), _D(d._D), _normal_dist(_D) {}
+
+    /**
+     * The copy assignment operator.
+     *
+     * @param d the distribution to copy.
+     * @return *this.
+     */
+    unit_normal_distribution& operator=(const unit_normal_distribution& d)
+    { _param = d._param; _D = d._D; return *this; }
 
     /**
      * Resets the distribution state.
@@ -97,14 +265,14 @@ namespace exrandom {
     /**
      * @return the parameter set of the distribution.
      */
-    param_type param() const { return param_type(); }
+    param_type param() const { return _param; }
 
     /**
      * Sets the parameter set of the distribution.
      *
-     * The function does not because a param_type has no state.
+     * @param p the new parameter set.
      */
-    void param(const param_type& /*param*/) {}
+    void param(const param_type& p) { _param = p; }
 
     /**
      * @return the greatest lower bound value of the distribution.
@@ -124,75 +292,106 @@ namespace exrandom {
      */
     template<typename Generator>
     result_type operator()(Generator& g)
-    { return _normal_dist.template value<result_type>(g); }
+    { return this->operator()(g, _param); }
 
     /**
      * @tparam Generator the type of g.
      * @param g the random generator engine.
+     * @param p the parameter set.
      * @return a normal deviate.
      */
     template<typename Generator>
-    result_type operator()(Generator& g, const param_type& /*p*/)
-    { return this->operator()(g); }
+    result_type operator()(Generator& g, const param_type& p)
+    { return _normal_dist.template reduced_value<result_type>
+        (g, p.precision()); }
+
+    /**
+     * Fill a range with normal deviates.
+     *
+     * @tparam ForwardIt the type of the iterators.
+     * @tparam Generator the type of g.
+     * @param first the beginning of the range.
+     * @param last the end of the range.
+     * @param g the random generator engine.
+     *
+     * This is equivalent to assigning operator()(g) to each element of the
+     * range in turn; so the results are the same as filling the range one
+     * deviate at a time.  However, this avoids the overhead of a separate call
+     * for each deviate.
+     */
+    template<typename ForwardIt, typename Generator>
+    void generate(ForwardIt first, ForwardIt last, Generator& g)
+    { for (; first != last; ++first)
+        *first = this->operator()(g); }
+
+    /**
+     * Fill an array with normal deviates.
+     *
+     * @tparam Generator the type of g.
+     * @param p a pointer to the first element of the array.
+     * @param n the number of elements of the array.
+     * @param g the random generator engine.
+     */
+    template<typename Generator>
+    void generate(result_type* p, size_t n, Generator& g)
+    { generate(p, p + n, g); }
 
   /**
    * Compare two unit_normal_distributions.
-   * @return true.
+   * @return true if the precisions are the same.
    */
   friend bool
-  operator==(const unit_normal_distribution<RealType>& /*d1*/,
-             const unit_normal_distribution<RealType>& /*d2*/)
-  { return true; }
+  operator==(const unit_normal_distribution& d1,
+             const unit_normal_distribution& d2)
+  { return d1._param == d2._param; }
 
   /**
    * Contrast two unit_normal_distributions.
-   * @return false.
+   * @return true if the precisions differ.
    */
   friend bool
-  operator!=(const unit_normal_distribution<RealType>& /*d1*/,
-             const unit_normal_distribution<RealType>& /*d2*/)
-  { return false; }
+  operator!=(const unit_normal_distribution& d1,
+             const unit_normal_distribution& d2)
+  { return d1._param != d2._param; }
 
   /**
    * Inserts a unit_normal_distribution random number distribution into the
    * output stream @e os.
    *
    * @param os an output stream.
+   * @param x the distribution.
    * @return os.
    *
-   * This function does nothing because this distribution has no state.
+   * This writes the precision of the deviates.
    */
   friend std::ostream&
-  operator<<(std::ostream& os, const unit_normal_distribution<RealType>& /*x*/)
-  { return os; }
+  operator<<(std::ostream& os, const unit_normal_distribution& x)
+  { return os << x._param.precision(); }
 
   /**
    * Extracts a unit_normal_distribution random number distribution from the
    * input stream @e is.
    *
    * @param is an input stream.
+   * @param x the distribution.
    * @return is.
    *
-   * This function does nothing because this distribution has no state.
+   * This reads the precision of the deviates.
    */
   friend std::istream&
-  operator>>(std::istream& is, unit_normal_distribution& /*x*/)
-  { return is; }
+  operator>>(std::istream& is, unit_normal_distribution& x) {
+    int precision;
+    if (is >> precision) x.param(param_type(precision));
+    return is;
+  }
 
   private:
     static_assert(!std::numeric_limits<RealType>::is_integer,
                   "template argument not a floating point type");
     param_type  _param;
-#if EXRANDOM_USE_KAHN
-    static const uint_t _base = std::numeric_limits<RealType>::radix;
-    rand_digit<_base> _D;
-    unit_normal_kahn<rand_digit<_base>> _normal_dist;
-#else
-    static const uint_t _base = std::numeric_limits<RealType>::radix ==  2 ?
-      0UL : std::numeric_limits<RealType>::radix;
-    rand_digit<_base> _D;
-    unit_normal_dist<rand_digit<_base>> _normal_dist;
-#endif
+    typedef typename algorithm::template dist<RealType> policy;
+    typename policy::digit_gen _D;
+    typename policy::type _normal_dist;
   };
 
 }
@@ -14,6 +14,8 @@
 
 #include <exrandom/u_rand.hpp>
 #include <exrandom/unit_exponential_dist.hpp>
+#include <exrandom/u_rand_workspace.hpp>
+#include <exrandom/sample_stats.hpp>
 
 namespace exrandom {
 
@@ -26,6 +28,8 @@ namespace exrandom {
    * This implements Algorithm K.
    *
    * @tparam digit_gen the type of digit generator.
+   * @tparam stats the statistics policy, no_stats (the default) or
+   *   sample_stats.
    *
    * <b>WARNING</b>: One of the steps of this algorithm requires the use of
    * arbitrary precision integer arithmetic.  However in this implementation
@@ -34,28 +38,59 @@ namespace exrandom {
    * in the results.  Use of this class is therefore <b>deprecated</b>.
    *
    * digit_gen::base cannot exceed 16.
+   *
+   * With @e stats = sample_stats, the digits used by the exponential
+   * deviates (sample_stage::X), the acceptance test (sample_stage::B), and
+   * the sign are recorded, together with the rejections by the acceptance
+   * test (counted as step 2); these are available via statistics().
    */
-  template<typename digit_gen> class unit_normal_kahn {
+  template<typename digit_gen, typename stats = no_stats>
+  class unit_normal_kahn {
   public:
     /**
      * The constructor.
      *
      * @param D a reference to the digit generator to be used.
      */
-    unit_normal_kahn(digit_gen& D) : _D(D), _x(D), _y(D), _e(D) {}
+    unit_normal_kahn(digit_gen& D)
+      : _D(D), _x0(D), _y0(D), _x(_x0), _y(_y0), _e(D) {}
+    /**
+     * Construct using the temporary storage of a u_rand_workspace.
+     *
+     * @param w the workspace; its digit generator is used.
+     * @param first the first of the 5 slots of @e w to use (default 0); the
+     *   last 3 are used by the embedded unit_exponential_dist.
+     */
+    explicit unit_normal_kahn(u_rand_workspace<digit_gen>& w, int first = 0)
+      : _D(w.digit_generator()), _x0(_D), _y0(_D)
+      , _x(w.slot(first)), _y(w.slot(first + 1)), _e(w, first + 2) {}
+    /**
+     * The copy constructor.
+     *
+     * @param d the distribution to copy.
+     *
+     * The copy uses the same workspace as @e d (if any).
+     */
+    unit_normal_kahn(const unit_normal_kahn& d)
+      : _D(d._D), _x0(d._x0), _y0(d._y0)
+      , _x(d.owned() ? _x0 : d._x), _y(d.owned() ? _y0 : d._y)
+      , _e(d._e), _stats(d._stats) {}
 
     /**
      * Generate the next deviate as a u_rand.
      *
      * @tparam Generator the type of g.
+     * @tparam store the digit_store for x.
      * @param g the random generator engine.
      * @param[out] x the u_rand to set.
      */
-    template<typename Generator>
-    void generate(Generator& g, u_rand<digit_gen>& x) {
+    template<typename Generator, typename store>
+    void generate(Generator& g, u_rand<digit_gen, store>& x) {
+      long long c = _stats.start(_D);
       for (;;) {
         // Generate a pair of exponential deviates
         _e.generate(g, x); _e.generate(g, _y);
+        _stats.tally(sample_stage::X, _D, c);
         std::pair<long long, long long> px =  x.rational();
         std::pair<long long, long long> py = _y.rational();
         for (;;) {
@@ -89,7 +124,10 @@ namespace exrandom {
           // tests below include equality.
           if (nxu <= nyl) {
             // (x - 1)^2 < 2*y, return x with random sign
+            _stats.tally(sample_stage::B, _D, c);
             if (_y.init().less_than_half(g)) x.negate();
+            _stats.tally(sample_stage::sign, _D, c);
+            _stats.sample();
             return;
           }
           if (nyu <= nxl)
@@ -101,6 +139,8 @@ namespace exrandom {
           else
             py = _y.rational(g, _y.ndigits() + 1);
         }
+        _stats.tally(sample_stage::B, _D, c);
+        _stats.reject(2);
       }
     }
 
@@ -115,7 +155,29 @@ namespace exrandom {
     template<typename RealType, typename Generator>
     RealType value(Generator& g) {
       generate(g, _x);
-      return _x.template value<RealType>(g);
+      long long c = _stats.start(_D);
+      RealType v = _x.template value<RealType>(g);
+      _stats.tally(sample_stage::round, _D, c);
+      return v;
+    }
+
+    /**
+     * Generate the next deviate and round it to nearest floating point number
+     * with a reduced precision.
+     *
+     * @tparam RealType the floating point type of the result.
+     * @tparam Generator the type of g.
+     * @param g the random generator engine.
+     * @param precision the number of (radix) digits in the result.
+     * @return the normal deviate (see u_rand::reduced_value).
+     */
+    template<typename RealType, typename Generator>
+    RealType reduced_value(Generator& g, int precision) {
+      generate(g, _x);
+      long long c = _stats.start(_D);
+      RealType v = _x.template reduced_value<RealType>(g, precision);
+      _stats.tally(sample_stage::round, _D, c);
+      return v;
     }
 
     /**
@@ -136,6 +198,17 @@ namespace exrandom {
       return _x.template midpoint<RealType>(g, k);
     }
 
+    /**
+     * @return the statistics collected (only useful with @e stats =
+     *   sample_stats).
+     */
+    const stats& statistics() const { return _stats; }
+    /**
+     * @return the statistics collected (only useful with @e stats =
+     *   sample_stats); use this to reset the counters.
+     */
+    stats& statistics() { return _stats; }
+
     /**
      * @return a reference to the digit generator used in the constructor.
      */
@@ -153,8 +226,12 @@ namespace exrandom {
     // Disable copy assignment
     unit_normal_kahn& operator=(const unit_normal_kahn&);
     digit_gen& _D;
-    u_rand<digit_gen> _x, _y; // temporary storage
+    u_rand<digit_gen> _x0, _y0; // own temporary storage
+    // The temporary storage, _x0, etc., or slots in a u_rand_workspace
+    u_rand<digit_gen> &_x, &_y;
     unit_exponential_dist<digit_gen, true> _e;
+    stats _stats;
+    bool owned() const { return &_x == &_x0; }
 
   };
 
@@ -11,6 +11,7 @@
 #define EXRANDOM_UNIT_UNIFORM_DIST_HPP 1
 
 #include <exrandom/u_rand.hpp>
+#include <exrandom/u_rand_workspace.hpp>
 
 namespace exrandom {
 
@@ -38,16 +39,34 @@ namespace exrandom {
      *
      * @param D a reference to the digit generator to be used.
      */
-    unit_uniform_dist(digit_gen& D) : _D(D), _x(D) {}
+    unit_uniform_dist(digit_gen& D) : _D(D), _x0(D), _x(_x0) {}
+    /**
+     * Construct using the temporary storage of a u_rand_workspace.
+     *
+     * @param w the workspace; its digit generator is used.
+     * @param first the slot of @e w to use (default 0).
+     */
+    explicit unit_uniform_dist(u_rand_workspace<digit_gen>& w, int first = 0)
+      : _D(w.digit_generator()), _x0(_D), _x(w.slot(first)) {}
+    /**
+     * The copy constructor.
+     *
+     * @param d the distribution to copy.
+     *
+     * The copy uses the same workspace as @e d (if any).
+     */
+    unit_uniform_dist(const unit_uniform_dist& d)
+      : _D(d._D), _x0(d._x0), _x(d.owned() ? _x0 : d._x) {}
 
     /**
      * Generate the next deviate as a u_rand.
      *
      * @tparam Generator the type of generator.
+     * @tparam store the digit_store for x.
      * @param[out] x the u_rand to set.
      */
-    template<typename Generator>
-    void generate(Generator& /*g*/, u_rand<digit_gen>& x)
+    template<typename Generator, typename store>
+    void generate(Generator& /*g*/, u_rand<digit_gen, store>& x)
     { x.init(); return; }
 
     /**
@@ -64,6 +83,22 @@ namespace exrandom {
       return _x.template value<RealType>(g);
     }
 
+    /**
+     * Generate the next deviate and round it to nearest floating point number
+     * with a reduced precision.
+     *
+     * @tparam RealType the floating point type of the result.
+     * @tparam Generator the type of g.
+     * @param g the random generator engine.
+     * @param precision the number of (radix) digits in the result.
+     * @return the uniform deviate (see u_rand::reduced_value).
+     */
+    template<typename RealType, typename Generator>
+    RealType reduced_value(Generator& g, int precision) {
+      generate(g, _x);
+      return _x.template reduced_value<RealType>(g, precision);
+    }
+
     /**
      * @return a reference to the digit generator used in the constructor.
      */
@@ -78,7 +113,9 @@ namespace exrandom {
     // Disable copy assignment
     unit_uniform_dist& operator=(const unit_uniform_dist&);
     digit_gen& _D;
-    u_rand<digit_gen> _x;  // temporary storage
+    u_rand<digit_gen> _x0;  // own temporary storage
+    u_rand<digit_gen>& _x;  // _x0 or a slot in a u_rand_workspace
+    bool owned() const { return &_x == &_x0; }
   };
 
 }
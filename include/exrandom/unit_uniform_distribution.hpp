@@ -12,6 +12,7 @@
 
 #include <iostream>             // for std::ostream, etc.
 #include <limits>
+#include <cstddef>              // for size_t
 
 #include <exrandom/rand_digit.hpp>
 #include <exrandom/unit_uniform_dist.hpp>
@@ -48,29 +49,82 @@ namespace exrandom {
     /**
      * @brief Parameter type for unit_uniform_distribution.
      *
-     * This holds no information because this distribution takes no parameters.
+     * The distribution takes no parameters; this holds the precision of the
+     * deviates.
      */
-    struct param_type {
+    class param_type {
+    public:
       /**
        * The type of the random number distribution.
        */
       typedef unit_uniform_distribution<RealType> distribution_type;
+      /**
+       * Constructs a parameter set.
+       *
+       * @param precision the number of (radix) digits in the deviates; if
+       *   this is 0 (the default), the full precision of RealType is used.
+       */
+      explicit param_type(int precision = 0) : _precision(precision) {}
+      /**
+       * @return the precision of the deviates.
+       */
+      int precision() const { return _precision; }
+      /**
+       * Compare two param_types.
+       * @return true if the precisions are the same.
+       */
+      friend bool operator==(const param_type& p1, const param_type& p2)
+      { return p1._precision == p2._precision; }
+      /**
+       * Contrast two param_types.
+       * @return true if the precisions differ.
+       */
+      friend bool operator!=(const param_type& p1, const param_type& p2)
+      { return !(p1 == p2); }
+    private:
+      int _precision;
     };
 
     /**
      * Constructs an uniform distribution.
+     *
+     * @param precision the number of (radix) digits in the deviates; if this
+     *   is 0 (the default), the full precision of RealType is used.  A
+     *   smaller precision reduces the number of random digits consumed (see
+     *   u_rand::reduced_value).
      */
     explicit
-    unit_uniform_distribution() : _uniform_dist(_D) {}
+    unit_uniform_distribution(int precision = 0)
+      : _param(precision), _uniform_dist(_D) {}
 
     /**
      * Constructs an uniform distribution with a parameter.
      *
-     * The parameter is ignored because it has no state.
+     * @param p the parameter set.
      */
     explicit
-    unit_uniform_distribution(const param_type& /*p*/)
-      : _uniform_dist(_D) {}
+    unit_uniform_distribution(const param_type& p)
+      : _param(p), _uniform_dist(_D) {}
+
+    /**
+     * The copy constructor.
+     *
+     * @param d the distribution to copy.
+     *
+     * The copy has its own digit generator; so copies can be used
+     * independently, e.g., in different threads.
+     */
+    unit_uniform_distribution(const unit_uniform_distribution& d)
+      : _param(d._param), _D(d._D), _uniform_dist(_D) {}
+
+    /**
+     * The copy assignment operator.
+     *
+     * @param d the distribution to copy.
+     * @return *this.
+     */
+    unit_uniform_distribution& operator=(const unit_uniform_distribution& d)
+    { _param = d._param; _D = d._D; return *this; }
 
     /**
      * Resets the distribution state.
@@ -80,14 +134,14 @@ namespace exrandom {
     /**
      * @return the parameter set of the distribution.
      */
-    param_type param() const { return param_type(); }
+    param_type param() const { return _param; }
 
     /**
      * Sets the parameter set of the distribution.
      *
-     * The function does not because a param_type has no state.
+     * @param p the new parameter set.
      */
-    void param(const param_type& /*param*/) {}
+    void param(const param_type& p) { _param = p; }
 
     /**
      * @return the greatest lower bound value of the distribution.
@@ -107,62 +161,100 @@ namespace exrandom {
     template<typename Generator>
     result_type
     operator()(Generator& g)
-    { return _uniform_dist.template value<result_type>(g); }
+    { return this->operator()(g, _param); }
 
     /**
      * @tparam Generator the type of g.
      * @param g the random generator engine.
+     * @param p the parameter set.
      * @return an uniform uniform deviate.
      */
     template<typename Generator>
     result_type
-    operator()(Generator& g, const param_type& /*p*/)
-    { return this->operator()(g); }
+    operator()(Generator& g, const param_type& p)
+    { return _uniform_dist.template reduced_value<result_type>
+        (g, p.precision()); }
+
+    /**
+     * Fill a range with uniform deviates.
+     *
+     * @tparam ForwardIt the type of the iterators.
+     * @tparam Generator the type of g.
+     * @param first the beginning of the range.
+     * @param last the end of the range.
+     * @param g the random generator engine.
+     *
+     * This is equivalent to assigning operator()(g) to each element of the
+     * range in turn; so the results are the same as filling the range one
+     * deviate at a time.  However, this avoids the overhead of a separate call
+     * for each deviate.
+     */
+    template<typename ForwardIt, typename Generator>
+    void generate(ForwardIt first, ForwardIt last, Generator& g)
+    { for (; first != last; ++first)
+        *first = this->operator()(g); }
+
+    /**
+     * Fill an array with uniform deviates.
+     *
+     * @tparam Generator the type of g.
+     * @param p a pointer to the first element of the array.
+     * @param n the number of elements of the array.
+     * @param g the random generator engine.
+     */
+    template<typename Generator>
+    void generate(result_type* p, size_t n, Generator& g)
+    { generate(p, p + n, g); }
 
   /**
    * Compare two unit_uniform_distributions.
-   * @return true.
+   * @return true if the precisions are the same.
    */
   friend bool
-  operator==(const unit_uniform_distribution<RealType>& /*d1*/,
-             const unit_uniform_distribution<RealType>& /*d2*/)
-  { return true; }
+  operator==(const unit_uniform_distribution<RealType>& d1,
+             const unit_uniform_distribution<RealType>& d2)
+  { return d1._param == d2._param; }
 
   /**
    * Contrast two unit_uniform_distributions.
-   * @return false.
+   * @return true if the precisions differ.
    */
   friend bool
-  operator!=(const unit_uniform_distribution<RealType>& /*d1*/,
-             const unit_uniform_distribution<RealType>& /*d2*/)
-  { return false; }
+  operator!=(const unit_uniform_distribution<RealType>& d1,
+             const unit_uniform_distribution<RealType>& d2)
+  { return d1._param != d2._param; }
 
   /**
    * Inserts a unit_uniform_distribution random number distribution into the
    * output stream @e os.
    *
    * @param os an output stream.
+   * @param x the distribution.
    * @return os.
    *
-   * This function does nothing because this distribution has no state.
+   * This writes the precision of the deviates.
    */
   friend std::ostream&
   operator<<(std::ostream& os,
-             const unit_uniform_distribution<RealType>& /*x*/)
-  { return os; }
+             const unit_uniform_distribution<RealType>& x)
+  { return os << x._param.precision(); }
 
   /**
    * Extracts a unit_uniform_distribution random number distribution from the
    * input stream @e is.
    *
    * @param is an input stream.
+   * @param x the distribution.
    * @return is.
    *
-   * This function does nothing because this distribution has no state.
+   * This reads the precision of the deviates.
    */
   friend std::istream&
-  operator>>(std::istream& is, unit_uniform_distribution& /*x*/)
-  { return is; }
+  operator>>(std::istream& is, unit_uniform_distribution& x) {
+    int precision;
+    if (is >> precision) x.param(param_type(precision));
+    return is;
+  }
 
   private:
     static_assert(!std::numeric_limits<RealType>::is_integer,
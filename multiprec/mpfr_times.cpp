@@ -37,6 +37,8 @@
 #endif
 
 #include <exrandom/unit_normal_distribution.hpp>
+#include <exrandom/unit_normal_dist.hpp>
+#include <exrandom/rand_digit.hpp>
 
 #if EXRANDOM_HAVE_MPFR
 
@@ -91,8 +93,12 @@ int main() {
     1.14e+06,
   };
 #endif
-#if EXRANDOM_HAVE_MPREAL
   auto g = std::mt19937(std::random_device()());
+  typedef exrandom::rand_digit<0> digit_gen;
+  digit_gen D;
+  exrandom::unit_normal_dist<digit_gen> Nd(D);
+  exrandom::u_rand<digit_gen> x(D);
+#if EXRANDOM_HAVE_MPREAL
   double timelistm[] = {
     1.07,
     1.09,
@@ -112,12 +118,12 @@ int main() {
     1.82e+06
   };
 #endif
-  std::cout << "timings (us) for nrandom vs grandom vs mpreal\n"
-            << "prec nrandom grandom mpreal\n"
+  std::cout << "timings (us) for nrandom vs grandom vs mpreal vs to_mpfr\n"
+            << "prec nrandom grandom mpreal to_mpfr\n"
             << std::setprecision(3);
   for (unsigned k = 0; k < sizeof(preclist)/sizeof(int); ++k) {
     int prec = preclist[k];
-    double tn = -1, tg = -1, tm = -1;
+    double tn = -1, tg = -1, tm = -1, td = -1;
 #if EXRANDOM_HAVE_NRANDOM
     {
       mpfr_set_prec(z, prec);
@@ -157,7 +163,25 @@ int main() {
       tm = dt/(m * 1000);
     }
 #endif
-    std::cout << prec << " " << tn << " " << tg << " " << tm << "\n";
+    {
+      // No reference timings for to_mpfr; double the number of samples
+      // until tx has elapsed.
+      mpfr_set_prec(z, prec);
+      size_t m = 0;
+      double dt = 0;
+      for (size_t n = 1; dt < tx * 1000; n *= 2) {
+        auto t0 = std::chrono::high_resolution_clock::now();
+        for (size_t i = 0; i < n; ++i)
+          { Nd.generate(g, x); x.to_mpfr(g, z, rnd); }
+        auto t1 = std::chrono::high_resolution_clock::now();
+        dt += double(std::chrono::duration_cast<std::chrono::nanoseconds>
+                     (t1 - t0).count());
+        m += n;
+      }
+      td = dt/(m * 1000);
+    }
+    std::cout << prec << " " << tn << " " << tg << " " << tm << " " << td
+              << "\n";
   }
   mpfr_clear(z); mpfr_clear(z2);
   mpfr_free_cache();